@@ -0,0 +1,263 @@
+#ifndef __IVI_BINARY_H__
+#define __IVI_BINARY_H__
+
+#include "ivi/ivi-enum.h"
+#include "ivi/ivi-model.h"
+#include "ivi/ivi-sdk.h"
+#include "ivi/ivi-types.h"
+
+#include <ostream>
+
+/*
+* Compact binary encoding of the model structs, eg to pass items between processes or keep
+* them in an external key-value store.  An encoding is a 4 byte header, "IV" followed by the
+* format version and the IVIBinaryType, then the fields in declaration order without tags:
+* integers as LEB128 varints, signed ones zigzagged, enums as varints and strings as a varint
+* length followed by the bytes.  Metadata properties are stored in whichever form the value
+* holds, JSON text or the protobuf wire bytes of a kept Struct, so neither side converts them.
+* Decoding into a view validates the whole buffer once and leaves every string in place, the
+* views hold IVIStringView fields pointing into the buffer, which must outlive them.  ToModel
+* then copies out the fields actually needed.
+* Decoding fails on other versions, like snapshots this is meant for processes running the
+* same SDK rather than as an interchange format.
+*/
+
+namespace ivi
+{
+    enum class IVIBinaryType : uint8_t
+    {
+        ITEM = 1,
+        ITEM_TYPE = 2,
+        PLAYER = 3,
+        ORDER = 4,
+        ITEM_STATUS_UPDATE = 5,
+        ITEM_TYPE_STATUS_UPDATE = 6,
+        PLAYER_STATUS_UPDATE = 7,
+        ORDER_STATUS_UPDATE = 8
+    };
+
+    // Form of encoded metadata properties
+    enum class IVIBinaryProperties : uint8_t
+    {
+        NONE = 0,
+        JSON = 1,
+        STRUCT = 2      // google::protobuf::Struct wire format
+    };
+
+    // Bytes inside a decoded buffer, valid as long as the buffer is
+    struct IVI_SDK_API IVIStringView
+    {
+        const char*                 data = nullptr;
+        size_t                      size = 0;
+
+        string                      str() const                     { return string(data, size); }
+        bool                        empty() const                   { return size == 0; }
+    };
+
+    IVI_SDK_API bool                operator==(const IVIStringView& lhs, const string& rhs);
+    IVI_SDK_API bool                operator!=(const IVIStringView& lhs, const string& rhs);
+    IVI_SDK_API std::ostream&       operator<<(std::ostream& out, const IVIStringView& value);
+
+    // Type of the encoding in data, false unless it starts with a header of this version
+    bool IVI_SDK_API                IVIBinaryPeekType(
+                                        const char* data,
+                                        size_t size,
+                                        IVIBinaryType& outType);
+
+    //////////////////////////////////////////////////////////////////////////
+    // Views, each Decode returns false if data is not a complete encoding of its type
+    //////////////////////////////////////////////////////////////////////////
+
+    struct IVI_SDK_API IVIMetadataView
+    {
+        IVIStringView                   name;
+        IVIStringView                   description;
+        IVIStringView                   image;
+        IVIBinaryProperties             propertiesForm = IVIBinaryProperties::NONE;
+        IVIStringView                   properties;
+
+        IVIMetadata                     ToModel() const;
+    };
+
+    struct IVI_SDK_API IVIItemView
+    {
+        IVIStringView                   gameInventoryId;
+        IVIStringView                   gameItemTypeId;
+        int64_t                         dgoodsId = 0;
+        IVIStringView                   itemName;
+        IVIStringView                   playerId;
+        IVIStringView                   ownerSidechainAccount;
+        int32_t                         serialNumber = 0;
+        IVIStringView                   currencyBase;
+        IVIStringView                   metadataUri;
+        IVIStringView                   trackingId;
+        IVIMetadataView                 metadata;
+        time_t                          createdTimestamp = 0;
+        time_t                          updatedTimestamp = 0;
+        ItemState                       itemState = ItemState::PENDING_ISSUED;
+
+        bool                            Decode(const char* data, size_t size);
+        IVIItem                         ToModel() const;
+    };
+
+    struct IVI_SDK_API IVIItemTypeView
+    {
+        IVIStringView                   gameItemTypeId;
+        int32_t                         maxSupply = 0;
+        int32_t                         currentSupply = 0;
+        int32_t                         issuedSupply = 0;
+        IVIStringView                   issuer;
+        int32_t                         issueTimeSpan = 0;
+        IVIStringView                   category;
+        IVIStringView                   tokenName;
+        IVIStringView                   baseUri;
+        vector<IVIStringView>           agreementIds;
+        IVIStringView                   trackingId;
+        IVIMetadataView                 metadata;
+        time_t                          createdTimestamp = 0;
+        time_t                          updatedTimestamp = 0;
+        ItemTypeState                   itemTypeState = ItemTypeState::PENDING_CREATE;
+        bool                            fungible = false;
+        bool                            burnable = false;
+        bool                            transferable = false;
+        bool                            finalized = false;
+        bool                            sellable = false;
+
+        bool                            Decode(const char* data, size_t size);
+        IVIItemType                     ToModel() const;
+    };
+
+    struct IVI_SDK_API IVIPlayerView
+    {
+        IVIStringView                   playerId;
+        IVIStringView                   email;
+        IVIStringView                   displayName;
+        IVIStringView                   sidechainAccountName;
+        IVIStringView                   trackingId;
+        time_t                          createdTimestamp = 0;
+        PlayerState                     playerState = PlayerState::PENDING_LINKED;
+
+        bool                            Decode(const char* data, size_t size);
+        IVIPlayer                       ToModel() const;
+    };
+
+    struct IVI_SDK_API IVIOrderAddressView
+    {
+        IVIStringView                   firstName;
+        IVIStringView                   lastName;
+        IVIStringView                   addressLine1;
+        IVIStringView                   addressLine2;
+        IVIStringView                   city;
+        IVIStringView                   state;
+        IVIStringView                   postalCode;
+        IVIStringView                   countryName;
+        IVIStringView                   countryIsoAlpha2;
+
+        IVIOrderAddress                 ToModel() const;
+    };
+
+    struct IVI_SDK_API IVIOrderView
+    {
+        IVIStringView                   orderId;
+        IVIStringView                   storeId;
+        IVIStringView                   buyerPlayerId;
+        IVIStringView                   tax;
+        IVIStringView                   total;
+        IVIOrderAddressView             address;
+        IVIStringView                   metadata;   // JSON
+        IVIStringView                   createdBy;
+        IVIStringView                   requestIp;
+        IVIStringView                   environmentId;
+        time_t                          createdTimestamp = 0;
+        IVIStringView                   bitpayInvoice;  // JSON
+        PaymentProviderId               paymentProviderId = PaymentProviderId::BRAINTREE;
+        OrderState                      orderStatus = OrderState::STARTED;
+
+        bool                            Decode(const char* data, size_t size);
+        IVIOrder                        ToModel() const;
+    };
+
+    struct IVI_SDK_API IVIItemStatusUpdateView
+    {
+        IVIStringView                   gameInventoryId;
+        IVIStringView                   gameItemTypeId;
+        IVIStringView                   playerId;
+        IVIStringView                   metadataUri;
+        IVIStringView                   trackingId;
+        int64_t                         dgoodsId = 0;
+        int32_t                         serialNumber = 0;
+        ItemState                       itemState = ItemState::PENDING_ISSUED;
+
+        bool                            Decode(const char* data, size_t size);
+        IVIItemStatusUpdate             ToModel() const;
+    };
+
+    struct IVI_SDK_API IVIItemTypeStatusUpdateView
+    {
+        IVIStringView                   gameItemTypeId;
+        IVIStringView                   baseUri;
+        IVIStringView                   trackingId;
+        int32_t                         currentSupply = 0;
+        int32_t                         issuedSupply = 0;
+        int32_t                         issueTimeSpan = 0;
+        ItemTypeState                   itemTypeState = ItemTypeState::PENDING_CREATE;
+
+        bool                            Decode(const char* data, size_t size);
+        IVIItemTypeStatusUpdate         ToModel() const;
+    };
+
+    struct IVI_SDK_API IVIPlayerStatusUpdateView
+    {
+        IVIStringView                   playerId;
+        IVIStringView                   trackingId;
+        PlayerState                     playerState = PlayerState::PENDING_LINKED;
+
+        bool                            Decode(const char* data, size_t size);
+        IVIPlayerStatusUpdate           ToModel() const;
+    };
+
+    struct IVI_SDK_API IVIOrderStatusUpdateView
+    {
+        IVIStringView                   orderId;
+        OrderState                      orderState = OrderState::STARTED;
+
+        bool                            Decode(const char* data, size_t size);
+        IVIOrderStatusUpdate            ToModel() const;
+    };
+
+    //////////////////////////////////////////////////////////////////////////
+    // Encoding, each appends to out so buffers can be reused or concatenated
+    //////////////////////////////////////////////////////////////////////////
+
+    void IVI_SDK_API                IVIBinaryEncode(const IVIItem& item, string& out);
+    void IVI_SDK_API                IVIBinaryEncode(const IVIItemType& itemType, string& out);
+    void IVI_SDK_API                IVIBinaryEncode(const IVIPlayer& player, string& out);
+    void IVI_SDK_API                IVIBinaryEncode(const IVIOrder& order, string& out);
+    void IVI_SDK_API                IVIBinaryEncode(const IVIItemStatusUpdate& update, string& out);
+    void IVI_SDK_API                IVIBinaryEncode(const IVIItemTypeStatusUpdate& update, string& out);
+    void IVI_SDK_API                IVIBinaryEncode(const IVIPlayerStatusUpdate& update, string& out);
+    void IVI_SDK_API                IVIBinaryEncode(const IVIOrderStatusUpdate& update, string& out);
+
+    template<typename TModel>
+    string                          IVIBinaryEncode(const TModel& value)
+    {
+        string out;
+        IVIBinaryEncode(value, out);
+        return out;
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // Decoding straight into a model, false if data is not a complete encoding of its type
+    //////////////////////////////////////////////////////////////////////////
+
+    bool IVI_SDK_API                IVIBinaryDecode(const char* data, size_t size, IVIItem& outItem);
+    bool IVI_SDK_API                IVIBinaryDecode(const char* data, size_t size, IVIItemType& outItemType);
+    bool IVI_SDK_API                IVIBinaryDecode(const char* data, size_t size, IVIPlayer& outPlayer);
+    bool IVI_SDK_API                IVIBinaryDecode(const char* data, size_t size, IVIOrder& outOrder);
+    bool IVI_SDK_API                IVIBinaryDecode(const char* data, size_t size, IVIItemStatusUpdate& outUpdate);
+    bool IVI_SDK_API                IVIBinaryDecode(const char* data, size_t size, IVIItemTypeStatusUpdate& outUpdate);
+    bool IVI_SDK_API                IVIBinaryDecode(const char* data, size_t size, IVIPlayerStatusUpdate& outUpdate);
+    bool IVI_SDK_API                IVIBinaryDecode(const char* data, size_t size, IVIOrderStatusUpdate& outUpdate);
+} // namespace ivi
+
+#endif // __IVI_BINARY_H__
@@ -0,0 +1,440 @@
+#ifndef __IVI_CACHE_H__
+#define __IVI_CACHE_H__
+
+#include "ivi/ivi-client.h"
+#include "ivi/ivi-executor.h"
+#include "ivi/ivi-model.h"
+#include "ivi/ivi-types.h"
+
+#include <chrono>
+#include <mutex>
+
+/*
+* Local caches of IVI data, kept coherent by the IVI data streams.
+* Find never makes an RPC, it only returns what has been seeded or
+* put into the cache and updated by stream messages since.
+*/
+
+namespace ivi
+{
+    /*
+    * Item type definitions keyed by gameItemTypeId.  Lookups are O(1) and readers only
+    * lock to copy a pointer, never for a copy of the data or behind a writer's work:
+    * the id index is an immutable snapshot swapped when ids are added, and each entry
+    * is an immutable IVIItemType swapped when a stream update arrives.  Returned
+    * ItemTypePtrs stay valid after later updates, they just no longer reflect them.
+    * Writers (Seed, Put, ApplyUpdate) are serialized with each other.
+    */
+    class IVI_SDK_API IVIItemTypeCache
+        : private NonCopyable<IVIItemTypeCache>
+    {
+    public:
+        using ItemTypePtr           = shared_ptr<const IVIItemType>;
+
+                                    IVIItemTypeCache();
+                                    ~IVIItemTypeCache();
+
+        // Replaces the cache contents with the full item type listing from IVIItemTypeClient::GetItemTypes(),
+        // leaves the cache untouched on failure
+        IVIResult                   Seed(
+                                        IVIItemTypeClient& client);
+
+        // Replaces the cache contents
+        void                        Seed(
+                                        const IVIItemTypeList& itemTypes);
+
+        // Adds or replaces a single item type, eg from IVIItemTypeClientAsync::GetItemType
+        void                        Put(
+                                        const IVIItemType& itemType);
+
+        // Applies the supply, state and baseUri of a stream update to the cached item type.
+        // Returns false if the item type is not cached, eg newly created, it is not added.
+        bool                        ApplyUpdate(
+                                        const IVIItemTypeStatusUpdate& update);
+
+        // Wraps a stream callback so the cache is updated before it is called, eg
+        //   callbacks.onItemTypeUpdated = cache.Hook(callbacks.onItemTypeUpdated);
+        // The cache must outlive the client manager the callback is given to.
+        OnItemTypeUpdated           Hook(
+                                        const OnItemTypeUpdated& next);
+
+        // nullptr if not cached
+        ItemTypePtr                 Find(
+                                        const string& gameItemTypeId) const;
+
+        // Visits a consistent snapshot of the cached ids, concurrent updates may or may not be seen
+        void                        ForEach(
+                                        const function<void(const IVIItemType&)>& visitor) const;
+
+        size_t                      Size() const;
+
+    private:
+
+        struct Entry
+        {
+            ItemTypePtr             itemType;   // guarded by m_swapMutex
+        };
+        using EntryPtr              = shared_ptr<Entry>;
+        using Index                 = unordered_map<string, EntryPtr>;
+        using IndexPtr              = shared_ptr<const Index>;
+
+        IndexPtr                    LoadIndex() const;
+
+        ItemTypePtr                 LoadItemType(
+                                        const Entry& entry) const;
+
+        void                        StoreIndex(
+                                        IndexPtr&& index);
+
+        void                        StoreItemType(
+                                        Entry& entry,
+                                        ItemTypePtr&& itemType);
+
+        IndexPtr                    m_index;    // guarded by m_swapMutex
+
+        std::mutex                  m_writeMutex;
+        mutable std::mutex          m_swapMutex;    // only held to copy or swap a pointer
+    };
+
+    /*
+    * Generation of each key with read-throughs in flight, so a result is only cached if no
+    * stream update for the same key arrived during its call.  Not thread-safe, the owning
+    * cache calls it under its own lock.
+    */
+    class IVI_SDK_API IVIInFlightKeys
+    {
+    public:
+        // Before the call, returns the generation to pass to End
+        uint64_t                    Begin(
+                                        const string& key);
+
+        // After the call, returns false if the key was invalidated since Begin
+        bool                        End(
+                                        const string& key,
+                                        uint64_t generation);
+
+        // On an update for key, a no-op unless a call for it is in flight
+        void                        Invalidate(
+                                        const string& key);
+
+    private:
+        struct InFlight
+        {
+            uint32_t                calls;
+            uint64_t                generation;
+        };
+
+        unordered_map<string, InFlight> m_keys;
+    };
+
+    // Shared with read-through completions, which only reach the cache while it is alive
+    struct IVICacheLifetime;
+
+    // Counters for cache sizing, hits and misses count Find lookups including read-throughs
+    struct IVI_SDK_API IVICacheStats
+    {
+        uint64_t                    hits;
+        uint64_t                    misses;
+        uint64_t                    evictions;
+        size_t                      size;       // entries
+        size_t                      capacity;   // entries, or bytes for byte-bounded caches
+        size_t                      bytes;      // estimated, 0 when the cache does not account bytes
+
+        double                      HitRate() const     { return hits + misses > 0 ? double(hits) / double(hits + misses) : 0.0; }
+    };
+
+    /*
+    * Players keyed by playerId, bounded to a fixed number of entries with least-recently-used
+    * eviction.  Fills from GetPlayer/GetPlayers results, either put explicitly or via the
+    * read-through GetPlayer, and is kept current by IVIPlayerStatusUpdate stream messages.
+    * All member functions are thread-safe, lookups take a lock since they update recency.
+    */
+    class IVI_SDK_API IVIPlayerCache
+        : private NonCopyable<IVIPlayerCache>
+    {
+    public:
+        using PlayerPtr             = shared_ptr<const IVIPlayer>;
+
+                                    IVIPlayerCache(
+                                        size_t capacity);
+                                    ~IVIPlayerCache();
+
+        void                        Put(
+                                        const IVIPlayer& player);
+
+        // eg the payload of IVIPlayerClient::GetPlayers
+        void                        Put(
+                                        const IVIPlayerList& players);
+
+        void                        Erase(
+                                        const string& playerId);
+
+        // Applies the trackingId of a stream update to the cached player, or drops the player if the update
+        // changes its state, since it does not carry the fields that change with it, eg sidechainAccountName
+        // on linking.  Returns false if the player is not cached, it is not added.
+        bool                        ApplyUpdate(
+                                        const IVIPlayerStatusUpdate& update);
+
+        // Wraps a stream callback so the cache is updated before it is called, eg
+        //   callbacks.onPlayerUpdated = cache.Hook(callbacks.onPlayerUpdated);
+        // The cache must outlive the client manager the callback is given to.
+        OnPlayerUpdated             Hook(
+                                        const OnPlayerUpdated& next);
+
+        // nullptr if not cached
+        PlayerPtr                   Find(
+                                        const string& playerId);
+
+        // Most recently used first, does not affect recency or the hit/miss counters.
+        // The cache is locked while visiting, the visitor must not call back into it.
+        void                        ForEach(
+                                        const function<void(const IVIPlayer&)>& visitor) const;
+
+        // Calls back immediately on a cache hit, otherwise calls client.GetPlayer and caches a successful
+        // result before calling back, unless an update for the player arrived meanwhile.  Results of calls
+        // outstanding when the cache is destroyed are only passed to callback.
+        void                        GetPlayer(
+                                        IVIPlayerClientAsync& client,
+                                        const string& playerId,
+                                        const function<void(const IVIResultPlayer&)>& callback);
+
+        IVICacheStats               Stats() const;
+
+    private:
+
+        struct Entry
+        {
+            string                  playerId;
+            PlayerPtr               player;
+        };
+        using LRUList               = list<Entry>;  // most recently used first
+
+        void                        PutLocked(
+                                        PlayerPtr&& player);
+
+        const size_t                m_capacity;
+        mutable std::mutex          m_mutex;
+        LRUList                     m_lru;
+        unordered_map<string, LRUList::iterator> m_index;
+        IVIInFlightKeys             m_inFlight;
+        uint64_t                    m_hits;
+        uint64_t                    m_misses;
+        uint64_t                    m_evictions;
+        shared_ptr<IVICacheLifetime> m_lifetime;
+    };
+
+    enum class IVICacheEviction : char
+    {
+        LRU,        // every hit moves the entry to the front
+        CLOCK       // hits only mark the entry, marked entries get a second chance at eviction
+    };
+
+    /*
+    * Items keyed by gameInventoryId, bounded by the estimated memory of the cached items
+    * rather than their count, since metadata sizes vary widely.  Entries expire ttlMs after
+    * they were put, 0 never expires them, and any IVIItemStatusUpdate for a cached item
+    * drops it, so the next read-through fetches the item with its current metadata.
+    * All member functions are thread-safe.
+    */
+    class IVI_SDK_API IVIItemCache
+        : private NonCopyable<IVIItemCache>
+    {
+    public:
+        using Clock                 = std::chrono::steady_clock;
+        using ItemPtr               = shared_ptr<const IVIItem>;
+
+                                    IVIItemCache(
+                                        size_t maxBytes,
+                                        uint32_t ttlMs,
+                                        IVICacheEviction eviction = IVICacheEviction::LRU);
+                                    ~IVIItemCache();
+
+        // Items estimated larger than maxBytes are not cached
+        void                        Put(
+                                        const IVIItem& item);
+
+        // eg the payload of IVIItemClient::GetItems
+        void                        Put(
+                                        const IVIItemList& items);
+
+        void                        Erase(
+                                        const string& gameInventoryId);
+
+        // Drops the cached item, returns false if it was not cached
+        bool                        ApplyUpdate(
+                                        const IVIItemStatusUpdate& update);
+
+        // Wraps a stream callback so the cache is updated before it is called, eg
+        //   callbacks.onItemUpdated = cache.Hook(callbacks.onItemUpdated);
+        // The cache must outlive the client manager the callback is given to.
+        OnItemUpdated               Hook(
+                                        const OnItemUpdated& next);
+
+        // nullptr if not cached or expired
+        ItemPtr                     Find(
+                                        const string& gameInventoryId);
+
+        // Unexpired items, does not affect recency or the hit/miss counters.
+        // The cache is locked while visiting, the visitor must not call back into it.
+        void                        ForEach(
+                                        const function<void(const IVIItem&)>& visitor) const;
+
+        // Calls back immediately on a cache hit, otherwise calls client.GetItem and caches a successful
+        // result before calling back, unless an update for the item arrived meanwhile.  Results of calls
+        // outstanding when the cache is destroyed are only passed to callback.
+        void                        GetItem(
+                                        IVIItemClientAsync& client,
+                                        const string& gameInventoryId,
+                                        const function<void(const IVIResultItem&)>& callback);
+
+        IVICacheStats               Stats() const;
+
+        // Heap and inline size of the item, used for the memory cap
+        static size_t               EstimateBytes(
+                                        const IVIItem& item);
+
+    private:
+
+        struct Entry
+        {
+            ItemPtr                 item;
+            size_t                  bytes;
+            Clock::time_point       expires;
+            bool                    referenced; // CLOCK only
+        };
+        using EntryList             = list<Entry>;  // LRU: most recently used first, CLOCK: most recently put first
+
+        void                        PutLocked(
+                                        ItemPtr&& item,
+                                        Clock::time_point now);
+
+        void                        EraseLocked(
+                                        unordered_map<string, EntryList::iterator>::iterator entry);
+
+        bool                        IsExpired(
+                                        const Entry& entry,
+                                        Clock::time_point now) const;
+
+        const size_t                m_maxBytes;
+        const std::chrono::milliseconds m_ttl;
+        const IVICacheEviction      m_eviction;
+        mutable std::mutex          m_mutex;
+        EntryList                   m_entries;
+        unordered_map<string, EntryList::iterator> m_index;
+        size_t                      m_bytes;
+        IVIInFlightKeys             m_inFlight;
+        uint64_t                    m_hits;
+        uint64_t                    m_misses;
+        uint64_t                    m_evictions;
+        shared_ptr<IVICacheLifetime> m_lifetime;
+    };
+
+    /*
+    * Short-lived record of item, player and order ids the server answered NOT_FOUND for, so
+    * repeated lookups of ids that do not exist, eg from malformed requests or stale references,
+    * are answered locally instead of each costing a round trip.  An id is remembered for ttlMs,
+    * at most capacity ids are remembered with the oldest dropped first, and a stream update for
+    * the id, ie the entity now exists, forgets it immediately.
+    * All member functions are thread-safe.
+    */
+    class IVI_SDK_API IVINotFoundCache
+        : private NonCopyable<IVINotFoundCache>
+    {
+    public:
+        using Clock                 = std::chrono::steady_clock;
+
+                                    IVINotFoundCache(
+                                        size_t capacity,
+                                        uint32_t ttlMs);
+                                    ~IVINotFoundCache();
+
+        // Each calls back immediately with NOT_FOUND for a remembered id, otherwise makes the call and
+        // remembers the id if the result is NOT_FOUND, unless an update for the id arrived meanwhile.
+        // Results of calls outstanding when the cache is destroyed are only passed to callback.
+        void                        GetItem(
+                                        IVIItemClientAsync& client,
+                                        const string& gameInventoryId,
+                                        const function<void(const IVIResultItem&)>& callback);
+
+        void                        GetPlayer(
+                                        IVIPlayerClientAsync& client,
+                                        const string& playerId,
+                                        const function<void(const IVIResultPlayer&)>& callback);
+
+        void                        GetOrder(
+                                        IVIOrderClientAsync& client,
+                                        const string& orderId,
+                                        const function<void(const IVIResultOrder&)>& callback);
+
+        // Wrap stream callbacks so the cache forgets ids as their entities appear, eg
+        //   callbacks.onItemUpdated = cache.HookItemUpdates(callbacks.onItemUpdated);
+        // The cache must outlive the client manager the callbacks are given to.
+        OnItemUpdated               HookItemUpdates(
+                                        const OnItemUpdated& next);
+
+        OnPlayerUpdated             HookPlayerUpdates(
+                                        const OnPlayerUpdated& next);
+
+        OnOrderUpdated              HookOrderUpdates(
+                                        const OnOrderUpdated& next);
+
+        // hits are lookups answered locally
+        IVICacheStats               Stats() const;
+
+    private:
+
+        enum class Kind : char
+        {
+            ITEM = 'i',
+            PLAYER = 'p',
+            ORDER = 'o'
+        };
+
+        struct Entry
+        {
+            string                  key;
+            Clock::time_point       expires;
+        };
+        using EntryList             = list<Entry>;  // oldest first, the TTL is fixed so this is also expiry order
+
+        static string               Key(
+                                        Kind kind,
+                                        const string& id);
+
+        // Returns true if the id is remembered, otherwise begins a call and returns its generation for Complete
+        bool                        Lookup(
+                                        const string& key,
+                                        uint64_t& outGeneration);
+
+        // Ends the call begun by Lookup, remembering the id if notFound and it was not updated meanwhile
+        void                        Complete(
+                                        const string& key,
+                                        uint64_t generation,
+                                        bool notFound);
+
+        template<typename TResult>
+        function<void(const TResult&)> Completion(
+                                        const string& key,
+                                        uint64_t generation,
+                                        const function<void(const TResult&)>& callback);
+
+        void                        Forget(
+                                        const string& key);
+
+        void                        ExpireLocked(
+                                        Clock::time_point now);
+
+        const size_t                m_capacity;
+        const std::chrono::milliseconds m_ttl;
+        mutable std::mutex          m_mutex;
+        EntryList                   m_entries;
+        unordered_map<string, EntryList::iterator> m_index;
+        IVIInFlightKeys             m_inFlight;
+        uint64_t                    m_hits;
+        uint64_t                    m_misses;
+        uint64_t                    m_evictions;
+        shared_ptr<IVICacheLifetime> m_lifetime;
+    };
+} // namespace ivi
+
+#endif // __IVI_CACHE_H__
@@ -67,6 +67,13 @@ namespace ivi
         IVIConnectionPtr            m_connection;
     };
 
+    // Per-service async call limiter, see IVIConfiguration::admissionPolicies
+    class IVIAdmissionControl;
+
+    // Coalesces concurrent async reads with identical arguments into one RPC
+    template<typename TKey, typename TResult>
+    class IVISingleFlight;
+
     template<typename TService>
     class IVI_SDK_API IVIClientT
         : public IVIClient
@@ -80,11 +87,29 @@ namespace ivi
 
         virtual                     ~IVIClientT();
 
+        // Async calls sent and awaiting their response, only tracked when an admission policy is configured
+        uint32_t                    InFlightCalls() const;
+
+        // Async calls waiting for admission, only when an admission policy is configured
+        uint32_t                    QueuedCalls() const;
+
     protected:
 
         template<class TStub>
         TStub*                      Stub();
 
+        // What async unary calls are made on, held by value so calls can be started from completions
+        // which may run after this client is destroyed or reinitialized
+        struct UnaryTarget
+        {
+            IVIConfigurationPtr     configuration;
+            shared_ptr<void>        stub;
+            CompletionQueuePtr      queue;
+            shared_ptr<IVIAdmissionControl> admission;
+        };
+
+        UnaryTarget                 GetUnaryTarget();
+
         template<
             typename TResult,
             typename TResponse,
@@ -111,6 +136,21 @@ namespace ivi
                                         TResponseParser&& parser,
                                         TResponseCallback&& callback);
 
+        template<
+            typename TResult,
+            typename TResponse,
+            typename TRequest,
+            typename TRequestCall,
+            typename TResponseParser,
+            typename TResponseCallback
+        >
+        static void                 CallUnaryAsync(
+                                        const UnaryTarget& target,
+                                        TRequest&& request,
+                                        TRequestCall&& call,
+                                        TResponseParser&& parser,
+                                        TResponseCallback&& callback);
+
         static bool                 CheckOkUnaryAsync(
                                         bool ok, 
                                         const grpc::ClientContext& context,
@@ -122,7 +162,9 @@ namespace ivi
                                         const grpc::Status& status);
 
     private:
-        void*                       m_stubPtr;
+        shared_ptr<void>            m_stubPtr;
+
+        shared_ptr<IVIAdmissionControl> m_admission;
     };
 
     template<typename TStreamClientTraits>
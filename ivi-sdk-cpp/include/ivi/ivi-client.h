@@ -21,9 +21,11 @@
 namespace ivi
 {
     using IVIResult                     = IVIResultT<void>; // No Payload, just a Status
+    using IVIResultCount                = IVIResultT<size_t>; // Number of elements passed to a visitor
 
     using IVIResultItem                 = IVIResultT<IVIItem>;
     using IVIResultItemList             = IVIResultT<IVIItemList>;
+    using IVIResultItemTable            = IVIResultT<IVIItemTable>;
     using IVIResultItemStateChange      = IVIResultT<IVIItemStateChange>;
 
     class IVI_SDK_API IVIItemClient
@@ -65,6 +67,23 @@ namespace ivi
                                             SortOrder sortOrder,
                                             Finalized finalized);
 
+         // Calls visitor with each item in turn as it is read from the response instead of building a list
+         IVIResultCount                 GetItems(
+                                            time_t createdTimestamp,
+                                            int32_t pageSize,
+                                            SortOrder sortOrder,
+                                            Finalized finalized,
+                                            const function<void(const IVIItem&)>& visitor);
+
+         // Appends the items to outTable column by column straight from the response, see ivi-table.h.
+         // The count is the number of rows appended.
+         IVIResultCount                 GetItems(
+                                            time_t createdTimestamp,
+                                            int32_t pageSize,
+                                            SortOrder sortOrder,
+                                            Finalized finalized,
+                                            IVIItemTable& outTable);
+
          IVIResult                      UpdateItemMetadata(
                                             const string& gameInventoryId,
                                             const IVIMetadata& metadata);
@@ -78,13 +97,89 @@ namespace ivi
                                             proto::api::item::UpdateItemMetadataRequest updateRequest);
     };
 
+    struct IVI_SDK_API IVIIssueItemsProgress
+    {
+        size_t                          total;
+        size_t                          sent;       // requests dispatched so far
+        size_t                          succeeded;
+        size_t                          failed;
+
+        size_t                          Completed() const   { return succeeded + failed; }
+        size_t                          InFlight() const    { return sent - Completed(); }
+        bool                            Done() const        { return Completed() == total; }
+    };
+
+    /*
+    * Handle to a running IVIItemClientAsync::IssueItems batch.
+    * Requests are dispatched as earlier ones complete, so at most windowSize IssueItem
+    * calls are outstanding at any time.  Pause() stops new dispatches (requests already
+    * in flight still complete and report), Resume() refills the window.
+    * Like the clients, this is not thread-safe.  Requests are issued on the stub and queue of
+    * the client that created it, without the client itself, so the batch may outlive it.
+    */
+    class IVI_SDK_API IVIIssueItemsBatch
+        : private NonCopyable<IVIIssueItemsBatch>
+        , public enable_shared_from_this<IVIIssueItemsBatch>
+    {
+    public:
+        using OnItemIssued              = function<void(const IVIIssueItemSpec&, const IVIResultItemStateChange&)>;
+        using OnProgress                = function<void(const IVIIssueItemsProgress&)>;
+
+                                        IVIIssueItemsBatch(
+                                            IVIItemClientAsync& client,
+                                            IVIIssueItemSpecList&& specs,
+                                            uint32_t windowSize,
+                                            const OnItemIssued& onItemIssued,
+                                            const OnProgress& onProgress);
+
+        void                            Pause();
+
+        void                            Resume();
+
+        bool                            IsPaused() const;
+
+        const IVIIssueItemsProgress&    Progress() const;
+
+    private:
+
+        friend class IVIItemClientAsync;
+
+        using IssueCall                 = function<void(const IVIIssueItemSpec&, const function<void(const IVIResultItemStateChange&)>&)>;
+
+        // Refills the window, calls made while it is already refilling return at once and are
+        // picked up by its loop, so requests failing synchronously never nest
+        void                            Dispatch();
+
+        void                            OnResult(size_t index, const IVIResultItemStateChange& result);
+
+        IssueCall                       m_issue;
+        IVIIssueItemSpecList            m_specs;
+        OnItemIssued                    m_onItemIssued;
+        OnProgress                      m_onProgress;
+        IVIIssueItemsProgress           m_progress;
+        uint32_t                        m_windowSize;
+        bool                            m_paused;
+        bool                            m_dispatching;
+    };
+    using IVIIssueItemsBatchPtr         = shared_ptr<IVIIssueItemsBatch>;
+
     class IVI_SDK_API IVIItemClientAsync
         : public IVIClientT<rpc::api::item::ItemService>
     {
     public:
-        using                           IVIClientT<ServiceT>::IVIClientT;
+                                        IVIItemClientAsync(
+                                            const IVIConfigurationPtr& configuration,
+                                            const IVIConnectionPtr& conn);
         virtual                         ~IVIItemClientAsync();
 
+        // Pipelines one IssueItem per spec through a window of at most windowSize outstanding requests.
+        // onItemIssued fires once per spec with that spec's result, onProgress after every completion.
+        IVIIssueItemsBatchPtr           IssueItems(
+                                            IVIIssueItemSpecList specs,
+                                            uint32_t windowSize,
+                                            const IVIIssueItemsBatch::OnItemIssued& onItemIssued,
+                                            const IVIIssueItemsBatch::OnProgress& onProgress = IVIIssueItemsBatch::OnProgress());
+
         void                            IssueItem(
                                             const string& gameInventoryId,
                                             const string& playerId,
@@ -110,6 +205,7 @@ namespace ivi
                                             const string& gameInventoryId,
                                             const function<void(const IVIResultItemStateChange&)>& callback);
 
+        // Concurrent GetItem calls with the same arguments share a single RPC, every callback receives its result
         void                            GetItem(
                                             const string& gameInventoryId,
                                             const function<void(const IVIResultItem&)>& callback);
@@ -126,6 +222,23 @@ namespace ivi
                                             Finalized finalized,
                                             const function<void(const IVIResultItemList&)>& callback);
 
+        // Calls visitor with each item in turn as it is read from the response, then callback
+        void                            GetItems(
+                                            time_t createdTimestamp,
+                                            int32_t pageSize,
+                                            SortOrder sortOrder,
+                                            Finalized finalized,
+                                            const function<void(const IVIItem&)>& visitor,
+                                            const function<void(const IVIResultCount&)>& callback);
+
+        // The page as an IVIItemTable built straight from the response, see ivi-table.h
+        void                            GetItems(
+                                            time_t createdTimestamp,
+                                            int32_t pageSize,
+                                            SortOrder sortOrder,
+                                            Finalized finalized,
+                                            const function<void(const IVIResultItemTable&)>& callback);
+
         void                            UpdateItemMetadata(
                                             const string& gameInventoryId,
                                             const IVIMetadata& metadata,
@@ -137,9 +250,17 @@ namespace ivi
 
     private:
 
+        friend class IVIIssueItemsBatch;
+
+        // IssueItem bound to this client's stub and queue by value, for IVIIssueItemsBatch
+        IVIIssueItemsBatch::IssueCall   MakeIssueCall();
+
         void                            UpdateItemMetadata(
                                             proto::api::item::UpdateItemMetadataRequest updateRequest,
                                             const function<void(const IVIResult&)>& callback);
+
+        using GetItemFlights            = IVISingleFlight<pair<string, bool>, IVIResultItem>;
+        shared_ptr<GetItemFlights>      m_getItemFlights;
     };
 
     using IVIResultItemType             = IVIResultT<IVIItemType>;
@@ -161,6 +282,12 @@ namespace ivi
         IVIResultItemTypeList           GetItemTypes(
                                             const StringList& gameItemTypeIds);
 
+        // Calls visitor with each item type in turn as it is read from the response instead of building
+        // a list, an empty gameItemTypeIds gets every item type
+        IVIResultCount                  GetItemTypes(
+                                            const StringList& gameItemTypeIds,
+                                            const function<void(const IVIItemType&)>& visitor);
+
         IVIResultItemTypeStateChange    CreateItemType(
                                             const string& gameItemTypeId,
                                             const string& tokenName,
@@ -181,13 +308,20 @@ namespace ivi
                                             const IVIMetadata& metadata);
     };
 
+    // Collects GetItemType ids for IVIItemTypeClientAsync, see IVIConfiguration::itemTypeBatchMaxIds
+    class IVIItemTypeBatcher;
+
     class IVI_SDK_API IVIItemTypeClientAsync
         : public IVIClientT<rpc::api::itemtype::ItemTypeService>
     {
     public:
-        using                           IVIClientT<ServiceT>::IVIClientT;
+                                        IVIItemTypeClientAsync(
+                                            const IVIConfigurationPtr& configuration,
+                                            const IVIConnectionPtr& conn);
         virtual                         ~IVIItemTypeClientAsync();
 
+        // Concurrent GetItemType calls for the same id share a single RPC, every callback receives its result.
+        // Different ids may also be combined into one GetItemTypes call, see IVIConfiguration::itemTypeBatchMaxIds
         void                            GetItemType(
                                             const string& gameItemTypeId,
                                             const function<void(const IVIResultItemType&)>& callback);
@@ -199,6 +333,13 @@ namespace ivi
                                             const StringList& gameItemTypeIds,
                                             const function<void(const IVIResultItemTypeList&)>& callback);
 
+        // Calls visitor with each item type in turn as it is read from the response, then callback,
+        // an empty gameItemTypeIds gets every item type
+        void                            GetItemTypes(
+                                            const StringList& gameItemTypeIds,
+                                            const function<void(const IVIItemType&)>& visitor,
+                                            const function<void(const IVIResultCount&)>& callback);
+
         void                            CreateItemType(
                                             const string& gameItemTypeId,
                                             const string& tokenName,
@@ -220,6 +361,29 @@ namespace ivi
                                             const string& gameItemTypeId,
                                             const IVIMetadata& metadata,
                                             const function<void(const IVIResult&)>& callback);
+
+    private:
+
+        using GetItemTypeFlights        = IVISingleFlight<string, IVIResultItemType>;
+
+        // Static so batches and their per-id fallbacks never touch a client which may be gone
+        static void                     SendItemTypeLookup(
+                                            const UnaryTarget& target,
+                                            const shared_ptr<GetItemTypeFlights>& flights,
+                                            const string& gameItemTypeId);
+
+        static void                     SendItemTypeBatch(
+                                            const UnaryTarget& target,
+                                            const shared_ptr<GetItemTypeFlights>& flights,
+                                            const StringList& gameItemTypeIds);
+
+        static void                     SendItemTypes(
+                                            const UnaryTarget& target,
+                                            const StringList& gameItemTypeIds,
+                                            const function<void(const IVIResultItemTypeList&)>& callback);
+
+        shared_ptr<GetItemTypeFlights>  m_getItemTypeFlights;
+        shared_ptr<IVIItemTypeBatcher>  m_batcher;
     };
 
     using IVIResultPlayer               = IVIResultT<IVIPlayer>;
@@ -246,13 +410,22 @@ namespace ivi
                                             time_t createdTimestamp, 
                                             int32_t pageSize,
                                             SortOrder sortOrder);
+
+        // Calls visitor with each player in turn as it is read from the response instead of building a list
+        IVIResultCount                  GetPlayers(
+                                            time_t createdTimestamp,
+                                            int32_t pageSize,
+                                            SortOrder sortOrder,
+                                            const function<void(const IVIPlayer&)>& visitor);
     };
 
     class IVI_SDK_API IVIPlayerClientAsync
         : public IVIClientT<rpc::api::player::PlayerService>
     {
     public:
-        using                           IVIClientT<ServiceT>::IVIClientT;
+                                        IVIPlayerClientAsync(
+                                            const IVIConfigurationPtr& configuration,
+                                            const IVIConnectionPtr& conn);
         virtual                         ~IVIPlayerClientAsync();
 
         void                            LinkPlayer(
@@ -262,6 +435,7 @@ namespace ivi
                                             const string& requestIp,
                                             const function<void(const IVIResultPlayerStateChange&)>& callback);
 
+        // Concurrent GetPlayer calls for the same id share a single RPC, every callback receives its result
         void                            GetPlayer(
                                             const string& playerId,
                                             const function<void(const IVIResultPlayer&)>& callback);
@@ -271,6 +445,19 @@ namespace ivi
                                             int32_t pageSize,
                                             SortOrder sortOrder,
                                             const function<void(const IVIResultPlayerList&)>& callback);
+
+        // Calls visitor with each player in turn as it is read from the response, then callback
+        void                            GetPlayers(
+                                            time_t createdTimestamp,
+                                            int32_t pageSize,
+                                            SortOrder sortOrder,
+                                            const function<void(const IVIPlayer&)>& visitor,
+                                            const function<void(const IVIResultCount&)>& callback);
+
+    private:
+
+        using GetPlayerFlights          = IVISingleFlight<string, IVIResultPlayer>;
+        shared_ptr<GetPlayerFlights>    m_getPlayerFlights;
     };
 
     using IVIResultOrder                    = IVIResultT<IVIOrder>;
@@ -6,6 +6,33 @@
 
 namespace ivi
 {
+    // What an async unary call does when its service's admission queue is full
+    enum class IVIOverflowPolicy : char
+    {
+        REJECT,         // the new call fails immediately with RESOURCE_EXHAUSTED
+        BLOCK,          // the calling thread waits up to blockTimeoutMs for queue space, then fails with RESOURCE_EXHAUSTED
+        DROP_OLDEST     // the oldest queued call fails with ABORTED and the new call is queued in its place
+    };
+
+    /*
+    * Limits the number of outstanding async unary calls per service.  Calls beyond maxInFlight
+    * wait in a FIFO queue of up to maxQueued entries and are sent as earlier calls complete.
+    * Rejected or dropped calls have their callback invoked immediately from the thread that
+    * caused it, with no RPC ever sent.
+    * BLOCK only makes sense when unary completions are polled on a different thread than the
+    * caller (see autoconfirmStreamUpdates), otherwise the caller always waits out the full timeout.
+    */
+    struct IVI_SDK_API IVIAdmissionPolicy
+    {
+        uint32_t                                maxInFlight;                // 0 = unlimited, admission control disabled
+        uint32_t                                maxQueued;
+        IVIOverflowPolicy                       overflowPolicy;
+        uint32_t                                blockTimeoutMs;             // only used by IVIOverflowPolicy::BLOCK
+    };
+
+    // Keyed by full gRPC service name, eg "ivi.rpc.api.item.ItemService", "ivi.rpc.api.itemtype.ItemTypeService",
+    // "ivi.rpc.api.order.OrderService", "ivi.rpc.api.payment.PaymentService", "ivi.rpc.api.player.PlayerService"
+    using IVIAdmissionPolicyMap                 = map<string, IVIAdmissionPolicy>;
 
     struct IVI_SDK_API IVIConfiguration
     {
@@ -19,6 +46,16 @@ namespace ivi
         uint32_t                                errorLoopMax;               // Number of times to poll message-receive when in auto-recovery, keep at >= 2
         bool                                    autoconfirmStreamUpdates;   // Affects threading semantics - see IVIClientManager for explanation
 
+        // IVIItemTypeClientAsync::GetItemType micro-batching, single-id lookups are collected for up to
+        // itemTypeBatchWindowMs or until itemTypeBatchMaxIds are pending, then sent as one GetItemTypes call.
+        // Completes on the unary Poll thread, so the window is only as accurate as the polling frequency.
+        uint32_t                                itemTypeBatchMaxIds;        // 0 = off, each GetItemType is its own RPC
+        uint32_t                                itemTypeBatchWindowMs;
+
+        // Per-service limits on outstanding async unary calls, services not listed are unlimited.
+        // Read when the clients are constructed.
+        IVIAdmissionPolicyMap                   admissionPolicies;
+
         static constexpr const char* DefaultHost() { return "sdk-api.iviengine.com:443"; }
 
         static IVIConfigurationPtr              DefaultConfiguration(
@@ -0,0 +1,171 @@
+#ifndef __IVI_EXPORT_H__
+#define __IVI_EXPORT_H__
+
+#include "ivi/ivi-client.h"
+#include "ivi/ivi-client-mgr.h"
+#include "ivi/ivi-model.h"
+#include "ivi/ivi-sdk.h"
+#include "ivi/ivi-snapshot.h"
+#include "ivi/ivi-types.h"
+
+#include <fstream>
+
+/*
+* Columnar binary exports of items or players for offline analytics.  A file holds one table
+* as a sequence of row groups appended as they fill, each storing every column contiguously:
+*   integer columns as int64 arrays, string columns as an offset array followed by the bytes,
+*   and low-cardinality string columns (item gameItemTypeId and currencyBase) as uint32 codes
+*   into a dictionary.
+* A footer written on Close holds the schema, the dictionaries and the offset of every column
+* chunk, followed by a fixed-size trailer locating the footer, so a reader maps the file and
+* reads any column of any row group without scanning the rest.
+* Memory use while writing is bounded by the row group size plus the dictionaries.
+* Like snapshots, the files are host byte order and versioned, not an interchange format.
+*/
+
+namespace ivi
+{
+    enum class IVIColumnarTable : uint32_t
+    {
+        ITEMS = 1,
+        PLAYERS = 2
+    };
+
+    class IVI_SDK_API IVIColumnarWriter
+        : private NonCopyable<IVIColumnarWriter>
+    {
+    public:
+        // nullptr if the file cannot be created
+        static unique_ptr<IVIColumnarWriter> Create(
+                                        const string& path,
+                                        IVIColumnarTable table,
+                                        uint32_t rowGroupRows = 65536);
+
+        // Closes the file if Close was not called
+                                    ~IVIColumnarWriter();
+
+        // Only for an ITEMS table
+        void                        Add(
+                                        const IVIItem& item);
+
+        // Only for a PLAYERS table
+        void                        Add(
+                                        const IVIPlayer& player);
+
+        // Writes the last row group and the footer, returns false on any file error since Create
+        bool                        Close();
+
+        uint64_t                    RowCount() const;
+
+    private:
+
+        struct Column;
+        struct RowGroup;
+
+                                    IVIColumnarWriter(
+                                        IVIColumnarTable table,
+                                        uint32_t rowGroupRows);
+
+        void                        Write(
+                                        const void* data,
+                                        size_t size);
+
+        void                        EndRow();
+
+        void                        FlushRowGroup();
+
+        const IVIColumnarTable      m_table;
+        const uint32_t              m_rowGroupRows;
+        unique_ptr<std::ofstream>   m_file;
+        vector<Column>              m_columns;
+        vector<RowGroup>            m_rowGroups;
+        uint64_t                    m_offset;       // bytes written so far
+        uint32_t                    m_rows;         // in the current row group
+        uint64_t                    m_totalRows;
+        bool                        m_closed;
+    };
+
+    class IVI_SDK_API IVIColumnarReader
+        : private NonCopyable<IVIColumnarReader>
+    {
+    public:
+        // nullptr if the file is missing, truncated, not closed, or from another version
+        static unique_ptr<IVIColumnarReader> Open(
+                                        const string& path);
+
+                                    ~IVIColumnarReader();
+
+        IVIColumnarTable            Table() const;
+
+        uint64_t                    RowCount() const;
+
+        size_t                      RowGroupCount() const;
+
+        size_t                      RowGroupRows(
+                                        size_t rowGroup) const;
+
+        StringList                  ColumnNames() const;
+
+        // false if there is no such integer column
+        bool                        ReadInt64Column(
+                                        size_t rowGroup,
+                                        const string& column,
+                                        vector<int64_t>& outValues) const;
+
+        // false if there is no such string column, dictionary columns are decoded
+        bool                        ReadStringColumn(
+                                        size_t rowGroup,
+                                        const string& column,
+                                        vector<string>& outValues) const;
+
+        // Rebuild whole rows one row group at a time, return the number visited
+        size_t                      ForEachItem(
+                                        const function<void(const IVIItem&)>& visitor) const;
+
+        size_t                      ForEachPlayer(
+                                        const function<void(const IVIPlayer&)>& visitor) const;
+
+    private:
+
+        struct Column;
+        struct RowGroup;
+        struct ColumnData;
+
+                                    IVIColumnarReader();
+
+        bool                        ReadColumn(
+                                        size_t rowGroup,
+                                        size_t column,
+                                        ColumnData& outData) const;
+
+        bool                        ReadRowGroup(
+                                        size_t rowGroup,
+                                        vector<ColumnData>& outColumns) const;
+
+        IVIMappedFile               m_file;
+        IVIColumnarTable            m_table;
+        vector<Column>              m_columns;
+        vector<RowGroup>            m_rowGroups;
+        uint64_t                    m_rowCount;
+    };
+
+    // Pages through every item via IVIItemPager straight into a columnar file at path.
+    // Returns the number of items exported, the file is removed on failure.
+    IVIResultCount IVI_SDK_API      IVIExportItems(
+                                        IVIClientManagerAsync& manager,
+                                        const string& path,
+                                        int32_t pageSize,
+                                        uint32_t rowGroupRows = 65536);
+
+    // Scans every player created up to now via IVIPlayerScan, unordered over partitions of the range
+    // from the oldest player's createdTimestamp, straight into a columnar file at path.
+    // Returns the number of players exported, the file is removed on failure.
+    IVIResultCount IVI_SDK_API      IVIExportPlayers(
+                                        IVIClientManagerAsync& manager,
+                                        const string& path,
+                                        int32_t pageSize,
+                                        uint32_t partitions,
+                                        uint32_t rowGroupRows = 65536);
+} // namespace ivi
+
+#endif // __IVI_EXPORT_H__
@@ -0,0 +1,71 @@
+#ifndef __IVI_INTERN_H__
+#define __IVI_INTERN_H__
+
+#include "ivi/ivi-sdk.h"
+#include "ivi/ivi-types.h"
+
+/*
+* Type of the model string fields that repeat across large results, eg IVIItem::gameItemTypeId.
+* A plain string by default.  Building with IVI_SDK_INTERNED_STRINGS (CMake option of the same
+* name) makes it a handle to an immutable string shared through a process-wide pool, so every
+* item of a type parsed into results and caches shares one copy of each such value, and copying
+* a model copies a pointer.  The handle converts to const string& and compares like a string,
+* code that assigns or reads these fields compiles in both builds but must not mutate them in place.
+*/
+
+namespace ivi
+{
+#ifdef IVI_SDK_INTERNED_STRINGS
+    class IVI_SDK_API IVIInternedString
+    {
+    public:
+                                    IVIInternedString();
+
+                                    IVIInternedString(
+                                        const string& value);
+
+                                    IVIInternedString(
+                                        const char* value);
+
+        const string&               str() const                     { return *m_value; }
+                                    operator const string&() const  { return *m_value; }
+        const char*                 c_str() const                   { return m_value->c_str(); }
+        const char*                 data() const                    { return m_value->data(); }
+        size_t                      size() const                    { return m_value->size(); }
+        bool                        empty() const                   { return m_value->empty(); }
+
+        // Distinct values currently pooled, for diagnostics
+        static size_t               PoolSize();
+
+    private:
+        shared_ptr<const string>    m_value;    // never nullptr
+    };
+
+    // Pooled values compare by pointer first
+    inline bool operator==(const IVIInternedString& lhs, const IVIInternedString& rhs)    { return &lhs.str() == &rhs.str() || lhs.str() == rhs.str(); }
+    inline bool operator!=(const IVIInternedString& lhs, const IVIInternedString& rhs)    { return !(lhs == rhs); }
+    inline bool operator<(const IVIInternedString& lhs, const IVIInternedString& rhs)     { return lhs.str() < rhs.str(); }
+    inline bool operator==(const IVIInternedString& lhs, const string& rhs)               { return lhs.str() == rhs; }
+    inline bool operator==(const string& lhs, const IVIInternedString& rhs)               { return lhs == rhs.str(); }
+    inline bool operator!=(const IVIInternedString& lhs, const string& rhs)               { return lhs.str() != rhs; }
+    inline bool operator!=(const string& lhs, const IVIInternedString& rhs)               { return lhs != rhs.str(); }
+    inline bool operator==(const IVIInternedString& lhs, const char* rhs)                 { return lhs.str() == rhs; }
+    inline bool operator!=(const IVIInternedString& lhs, const char* rhs)                 { return lhs.str() != rhs; }
+    inline std::ostream& operator<<(std::ostream& out, const IVIInternedString& value)    { return out << value.str(); }
+#else
+    using IVIInternedString         = string;
+#endif
+} // namespace ivi
+
+#ifdef IVI_SDK_INTERNED_STRINGS
+namespace std
+{
+    template<>
+    struct hash<ivi::IVIInternedString>
+    {
+        size_t operator()(const ivi::IVIInternedString& value) const { return hash<string>()(value.str()); }
+    };
+} // namespace std
+#endif
+
+#endif // __IVI_INTERN_H__
@@ -0,0 +1,32 @@
+#ifndef __IVI_JSON_H__
+#define __IVI_JSON_H__
+
+#include "ivi/ivi-sdk.h"
+#include "ivi/ivi-types.h"
+
+/*
+* Direct JSON conversion of google::protobuf::Struct trees, the type of IVI metadata properties,
+* order metadata and BitPay invoices, used by GoogleStructToJsonString and JsonStringToGoogleStruct.
+* Unlike protobuf's generic json_util these need no reflection or type resolver: the writer walks
+* the Struct emitting the format of MessageToJsonString, and the parser builds the Struct in place,
+* scanning strings and whitespace runs 16 bytes at a time with SSE2 where the target has it.
+*/
+
+namespace ivi
+{
+    // Appends the JSON of protoStruct to out, byte for byte what MessageToJsonString writes
+    void IVI_SDK_API                AppendGoogleStructJson(
+                                        const google::protobuf::Struct& protoStruct,
+                                        string& out);
+
+    // Parses a JSON object into outStruct, which is cleared first.  Strict RFC 8259: returns false
+    // on any syntax error, invalid UTF-8, duplicate key, number out of double range, or nesting
+    // deeper than 100, leaving outStruct unspecified.  json_util accepts a few non-standard forms,
+    // eg trailing commas, which JsonStringToGoogleStruct still handles by falling back to it.
+    bool IVI_SDK_API                ParseGoogleStructJson(
+                                        const char* json,
+                                        size_t size,
+                                        google::protobuf::Struct& outStruct);
+} // namespace ivi
+
+#endif // __IVI_JSON_H__
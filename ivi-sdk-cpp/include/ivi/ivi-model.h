@@ -2,6 +2,7 @@
 #define __IVI_MODEL_H__
 
 #include "ivi/ivi-enum.h"
+#include "ivi/ivi-intern.h"
 #include "ivi/ivi-sdk.h"
 #include "ivi/ivi-types.h"
 
@@ -9,21 +10,116 @@
 // API users need not worry about any non-trivial semantics
 // and can rely on compiler-generated default functions and
 // STL implementations, particularly copy/move semantics and NRVO.
+// The FromProto overloads taking an rvalue move the strings out of
+// a message the caller is done with, eg an RPC response, instead of
+// copying them.  The ToProto overloads taking a pointer overwrite the
+// fields of an existing message, eg a sub-message of a request, rather
+// than building a temporary to copy from.
 namespace ivi
 {
     string IVI_SDK_API                     GoogleStructToJsonString(const google::protobuf::Struct& protoStruct);
 
     google::protobuf::Struct IVI_SDK_API   JsonStringToGoogleStruct(const string& jsonString);
 
+    /*
+    * Type of IVIMetadata::properties, the JSON properties.  A plain string by default.
+    * Building with IVI_SDK_LAZY_METADATA_PROPERTIES (CMake option of the same name) makes it
+    * IVIMetadataProperties below: metadata parsed from the IVI engine keeps the received
+    * google::protobuf::Struct and only serializes it to JSON the first time the JSON is read,
+    * which is the dominant cost of parsing items otherwise, and ToProto sends a kept Struct as is.
+    * It converts to and from string, but code relying on other string members must change.
+    * The MetadataProperties* functions further down work with either type.
+    */
+#ifdef IVI_SDK_LAZY_METADATA_PROPERTIES
+    class IVI_SDK_API IVIMetadataProperties
+    {
+    public:
+                                    IVIMetadataProperties();
+
+                                    IVIMetadataProperties(
+                                        const string& json);
+
+                                    IVIMetadataProperties(
+                                        string&& json);
+
+                                    IVIMetadataProperties(
+                                        const char* json);
+
+        // Structured properties, eg built directly from an application property tree, are sent
+        // by ToProto as is without a JSON round trip.  The JSON is still available on demand.
+        static IVIMetadataProperties FromStruct(
+                                        const google::protobuf::Struct& properties);
+
+        static IVIMetadataProperties FromStruct(
+                                        google::protobuf::Struct&& properties);
+
+        // Shares the Struct without a copy, eg the same properties for a batch of IssueItem specs
+        static IVIMetadataProperties FromStruct(
+                                        const shared_ptr<const google::protobuf::Struct>& properties);
+
+        // Serializes a kept Struct to JSON on the first call, copies share the result and
+        // materialization is thread-safe
+        const string&               Json() const;
+
+                                    operator const string&() const  { return Json(); }
+        const char*                 c_str() const                   { return Json().c_str(); }
+        size_t                      size() const                    { return Json().size(); }
+        bool                        empty() const                   { return Json().empty(); }
+
+        // nullptr unless parsed from a proto or made FromStruct, the raw properties for callers
+        // that walk them directly instead of parsing the JSON
+        shared_ptr<const google::protobuf::Struct> Struct() const;
+
+        // The properties as a Struct, as sent by ToProto: the kept one, or the JSON parsed on the
+        // first call.  nullptr for empty JSON.
+        shared_ptr<const google::protobuf::Struct> ToStruct() const;
+
+        // Stable for the lifetime of the value and its copies, without materializing the JSON:
+        // the JSON size, or the wire size of a kept Struct
+        size_t                      ByteSizeEstimate() const;
+
+    private:
+        struct State;
+        shared_ptr<State>           m_state;    // nullptr for empty JSON
+    };
+
+    // Structural when both sides keep a Struct, whose JSON field order is unspecified, otherwise by JSON text
+    bool IVI_SDK_API                operator==(const IVIMetadataProperties& lhs, const IVIMetadataProperties& rhs);
+    bool IVI_SDK_API                operator!=(const IVIMetadataProperties& lhs, const IVIMetadataProperties& rhs);
+    IVI_SDK_API std::ostream&       operator<<(std::ostream& out, const IVIMetadataProperties& properties);
+#else
+    using IVIMetadataProperties     = string;
+#endif
+
+    // The JSON of properties as a Struct, kept as is by IVIMetadataProperties or converted to a string
+    IVIMetadataProperties IVI_SDK_API MetadataPropertiesFromStruct(const google::protobuf::Struct& properties);
+    IVIMetadataProperties IVI_SDK_API MetadataPropertiesFromStruct(google::protobuf::Struct&& properties);
+
+    // The Struct kept by IVIMetadataProperties, always nullptr for a string
+    shared_ptr<const google::protobuf::Struct> IVI_SDK_API MetadataPropertiesStruct(const IVIMetadataProperties& properties);
+
+    // The properties as sent by ToProto: the kept Struct, or the JSON parsed through a process-wide
+    // cache keyed by content, so metadata repeated across values, eg issuing many items of one type,
+    // is parsed once and then only hashed and copied.  nullptr for empty JSON.
+    shared_ptr<const google::protobuf::Struct> IVI_SDK_API MetadataPropertiesToStruct(const IVIMetadataProperties& properties);
+
+    // The JSON size, or the wire size of a kept Struct without materializing its JSON
+    size_t IVI_SDK_API              MetadataPropertiesByteSize(const IVIMetadataProperties& properties);
+
+    // The cache of MetadataPropertiesToStruct holds JSON of up to 16KB, 0 entries disables it, the default is 64
+    void IVI_SDK_API                SetMetadataStructCacheCapacity(size_t entries);
+
     struct IVI_SDK_API IVIMetadata
     {
         string                          name;
         string                          description;
-        string                          image;
-        string                          properties;     // JSON
+        IVIInternedString               image;
+        IVIMetadataProperties           properties;     // JSON
 
         static IVIMetadata              FromProto(const proto::common::Metadata& metadata);
+        static IVIMetadata              FromProto(proto::common::Metadata&& metadata);
         proto::common::Metadata         ToProto() const;
+        void                            ToProto(proto::common::Metadata* out) const;
     };
 
     struct IVI_SDK_API IVIMetadataUpdate
@@ -32,18 +128,19 @@ namespace ivi
         IVIMetadata                             metadata;
 
         proto::api::item::UpdateItemMetadata    ToProto() const;
+        void                                    ToProto(proto::api::item::UpdateItemMetadata* out) const;
     };
 
     struct IVI_SDK_API IVIItem
     {
         string                          gameInventoryId;
-        string                          gameItemTypeId;
+        IVIInternedString               gameItemTypeId;
         int64_t                         dgoodsId;
-        string                          itemName;
+        IVIInternedString               itemName;
         string                          playerId;
-        string                          ownerSidechainAccount;
+        IVIInternedString               ownerSidechainAccount;
         int32_t                         serialNumber;
-        string                          currencyBase;
+        IVIInternedString               currencyBase;
         string                          metadataUri;
         string                          trackingId;
         IVIMetadata                     metadata;
@@ -52,7 +149,9 @@ namespace ivi
         ItemState                       itemState;
 
         static IVIItem                  FromProto(const proto::api::item::Item& item);
+        static IVIItem                  FromProto(proto::api::item::Item&& item);
         proto::api::item::Item          ToProto() const;
+        void                            ToProto(proto::api::item::Item* out) const;
     };
 
     struct IVI_SDK_API IVIItemType
@@ -79,7 +178,9 @@ namespace ivi
         bool                            sellable : 1;
 
         static IVIItemType              FromProto(const proto::api::itemtype::ItemType& itemType);
+        static IVIItemType              FromProto(proto::api::itemtype::ItemType&& itemType);
         proto::api::itemtype::ItemType  ToProto() const;
+        void                            ToProto(proto::api::itemtype::ItemType* out) const;
     };
 
     struct IVI_SDK_API IVIOrderAddress
@@ -95,7 +196,9 @@ namespace ivi
         string                          countryIsoAlpha2;
 
         static IVIOrderAddress          FromProto(const proto::api::order::Address& address);
+        static IVIOrderAddress          FromProto(proto::api::order::Address&& address);
         proto::api::order::Address      ToProto() const;
+        void                            ToProto(proto::api::order::Address* out) const;
     };
 
     struct IVI_SDK_API IVIPurchasedItems
@@ -108,7 +211,9 @@ namespace ivi
         IVIMetadata                         metadata;
 
         static IVIPurchasedItems            FromProto(const proto::api::order::ItemTypeOrder& purchasedItem);
+        static IVIPurchasedItems            FromProto(proto::api::order::ItemTypeOrder&& purchasedItem);
         proto::api::order::ItemTypeOrder    ToProto() const;
+        void                                ToProto(proto::api::order::ItemTypeOrder* out) const;
     };
 
     struct IVI_SDK_API IVIOrder
@@ -129,7 +234,9 @@ namespace ivi
         OrderState                          orderStatus;
 
         static IVIOrder                     FromProto(const proto::api::order::Order& order);
+        static IVIOrder                     FromProto(proto::api::order::Order&& order);
         proto::api::order::Order            ToProto() const;
+        void                                ToProto(proto::api::order::Order* out) const;
     };
 
     struct IVI_SDK_API IVIFinalizeOrderResponse
@@ -144,6 +251,7 @@ namespace ivi
         bool                                scoreIsValid : 1;
 
         static IVIFinalizeOrderResponse     FromProto(const proto::api::order::FinalizeOrderAsyncResponse& response);
+        static IVIFinalizeOrderResponse     FromProto(proto::api::order::FinalizeOrderAsyncResponse&& response);
     };
 
     struct IVI_SDK_API IVIItemStateChange
@@ -153,6 +261,21 @@ namespace ivi
         ItemState                           itemState;
     };
 
+    // The arguments of a single IVIItemClientAsync::IssueItem call, for use with IssueItems
+    struct IVI_SDK_API IVIIssueItemSpec
+    {
+        string                              gameInventoryId;
+        string                              playerId;
+        string                              itemName;
+        string                              gameItemTypeId;
+        BigDecimal                          amountPaid;
+        string                              currency;
+        IVIMetadata                         metadata;
+        string                              storeId;
+        string                              orderId;
+        string                              requestIp;
+    };
+
     struct IVI_SDK_API IVIItemTypeStateChange
     {
         string                              gameItemTypeId;
@@ -171,7 +294,9 @@ namespace ivi
         PlayerState                         playerState;
 
         static IVIPlayer                    FromProto(const proto::api::player::IVIPlayer& player);
+        static IVIPlayer                    FromProto(proto::api::player::IVIPlayer&& player);
         proto::api::player::IVIPlayer       ToProto() const;
+        void                                ToProto(proto::api::player::IVIPlayer* out) const;
     };
 
     struct IVI_SDK_API IVIToken
@@ -180,6 +305,7 @@ namespace ivi
         PaymentProviderId                   paymentProviderId;  // Only Braintree is supported currently
 
         static IVIToken                     FromProto(const proto::api::payment::Token& token);
+        static IVIToken                     FromProto(proto::api::payment::Token&& token);
     };
 
     struct IVI_SDK_API IVIPlayerStatusUpdate
@@ -189,6 +315,7 @@ namespace ivi
         PlayerState                         playerState;
 
         static IVIPlayerStatusUpdate        FromProto(const rpc::streams::player::PlayerStatusUpdate& psu);
+        static IVIPlayerStatusUpdate        FromProto(rpc::streams::player::PlayerStatusUpdate&& psu);
     };
 	
     struct IVI_SDK_API IVIItemStatusUpdate
@@ -203,6 +330,7 @@ namespace ivi
         ItemState                           itemState;
 
         static IVIItemStatusUpdate          FromProto(const rpc::streams::item::ItemStatusUpdate& isu);
+        static IVIItemStatusUpdate          FromProto(rpc::streams::item::ItemStatusUpdate&& isu);
     };
 
     struct IVI_SDK_API IVIItemTypeStatusUpdate
@@ -216,6 +344,7 @@ namespace ivi
         ItemTypeState                       itemTypeState;
 
         static IVIItemTypeStatusUpdate      FromProto(const rpc::streams::itemtype::ItemTypeStatusUpdate& itsu);
+        static IVIItemTypeStatusUpdate      FromProto(rpc::streams::itemtype::ItemTypeStatusUpdate&& itsu);
     };
 
     struct IVI_SDK_API IVIOrderStatusUpdate
@@ -224,6 +353,7 @@ namespace ivi
         OrderState                          orderState;
 
         static IVIOrderStatusUpdate         FromProto(const rpc::streams::order::OrderStatusUpdate& osu);
+        static IVIOrderStatusUpdate         FromProto(rpc::streams::order::OrderStatusUpdate&& osu);
     };
 } // namespace ivi
 
@@ -0,0 +1,152 @@
+#ifndef __IVI_PAGING_H__
+#define __IVI_PAGING_H__
+
+#include "ivi/ivi-client.h"
+#include "ivi/ivi-client-mgr.h"
+#include "ivi/ivi-model.h"
+#include "ivi/ivi-table.h"
+#include "ivi/ivi-types.h"
+
+/*
+* Pagers walk a whole collection listed by a paged Get* RPC, eg IVIItemClientAsync::GetItems,
+* carrying the createdTimestamp cursor from page to page.  Each next page is requested as soon
+* as the previous one arrives, before it is handed to the caller, so the transfer of one page
+* overlaps with the processing of the one before it.
+* Items sharing the createdTimestamp of the last item of a page are tracked so they are not
+* returned twice should the server include the cursor timestamp in the next page.
+* A pager is not thread-safe, use it from the thread polling the client manager.
+*/
+
+namespace ivi
+{
+    template<typename TPage>
+    class IVIPagerState;
+    class IVIPlayerScanState;
+
+    class IVI_SDK_API IVIItemPager
+        : private NonCopyable<IVIItemPager>
+    {
+    public:
+        // last is true for the final call, which may carry an empty page or a failure
+        using OnPage                = function<void(const IVIResultItemList& page, bool last)>;
+
+                                    IVIItemPager(
+                                        IVIItemClientAsync& client,
+                                        time_t createdTimestamp,
+                                        int32_t pageSize,
+                                        SortOrder sortOrder,
+                                        Finalized finalized);
+
+        // Outstanding requests are abandoned, their results dropped
+                                    ~IVIItemPager();
+
+        // Push style: calls onPage with every page in order as the client manager is polled.
+        // Do not combine with NextPage.
+        void                        Start(
+                                        const OnPage& onPage);
+
+        // Pull style: polls manager until the next page has arrived.  Returns SUCCESS with an empty
+        // page once the collection is exhausted, or the failure of the RPC, which ends the walk.
+        IVIResultItemList           NextPage(
+                                        IVIClientManagerAsync& manager);
+
+        // Pull style over single items, returns the first failure if any
+        IVIResult                   ForEachItem(
+                                        IVIClientManagerAsync& manager,
+                                        const function<void(const IVIItem&)>& visitor);
+
+        // true once the last page has been returned or delivered
+        bool                        Done() const;
+
+    private:
+        shared_ptr<IVIPagerState<IVIItemList>> m_state;
+    };
+
+    // IVIItemPager delivering each page as an IVIItemTable, built straight from the responses
+    class IVI_SDK_API IVIItemTablePager
+        : private NonCopyable<IVIItemTablePager>
+    {
+    public:
+        // last is true for the final call, which may carry an empty page or a failure
+        using OnPage                = function<void(const IVIResultItemTable& page, bool last)>;
+
+                                    IVIItemTablePager(
+                                        IVIItemClientAsync& client,
+                                        time_t createdTimestamp,
+                                        int32_t pageSize,
+                                        SortOrder sortOrder,
+                                        Finalized finalized);
+
+        // Outstanding requests are abandoned, their results dropped
+                                    ~IVIItemTablePager();
+
+        // Push style, see IVIItemPager::Start
+        void                        Start(
+                                        const OnPage& onPage);
+
+        // Pull style, see IVIItemPager::NextPage
+        IVIResultItemTable          NextPage(
+                                        IVIClientManagerAsync& manager);
+
+        // Pull style, appends every remaining page to outTable and counts the rows appended.
+        // On failure outTable keeps the pages appended before it.
+        IVIResultCount              AppendAll(
+                                        IVIClientManagerAsync& manager,
+                                        IVIItemTable& outTable);
+
+        // true once the last page has been returned or delivered
+        bool                        Done() const;
+
+    private:
+        shared_ptr<IVIPagerState<IVIItemTable>> m_state;
+    };
+
+    /*
+    * Walks every player created in [fromTimestamp, toTimestamp] by splitting the range into
+    * equal partitions and paging GetPlayers over each concurrently, so a full scan takes about
+    * as many round trips as the largest partition rather than the whole player base.
+    * Since partitions cover disjoint time ranges, ordered delivery is a concatenation in
+    * sortOrder: each partition still has its next page in flight, but pages of later partitions
+    * are held back until the earlier ones are done.  Unordered delivery passes pages on as they
+    * arrive and has no such wait.
+    */
+    class IVI_SDK_API IVIPlayerScan
+        : private NonCopyable<IVIPlayerScan>
+    {
+    public:
+        // last is true for the final call, which may carry an empty page or a failure
+        using OnPage                = function<void(const IVIResultPlayerList& page, bool last)>;
+
+                                    IVIPlayerScan(
+                                        IVIPlayerClientAsync& client,
+                                        time_t fromTimestamp,
+                                        time_t toTimestamp,
+                                        uint32_t partitions,
+                                        int32_t pageSize,
+                                        SortOrder sortOrder,
+                                        bool ordered);
+
+        // Outstanding requests are abandoned, their results dropped
+                                    ~IVIPlayerScan();
+
+        // Calls onPage with every page as the client manager is polled.  The first failure
+        // ends the scan, the remaining partitions are abandoned.
+        void                        Start(
+                                        const OnPage& onPage);
+
+        // Starts the scan and polls manager until it is done, returns the first failure if any
+        IVIResult                   ForEachPlayer(
+                                        IVIClientManagerAsync& manager,
+                                        const function<void(const IVIPlayer&)>& visitor);
+
+        bool                        Done() const;
+
+        // Number of partitions actually used, at most one per second of the range
+        size_t                      PartitionCount() const;
+
+    private:
+        shared_ptr<IVIPlayerScanState> m_state;
+    };
+} // namespace ivi
+
+#endif // __IVI_PAGING_H__
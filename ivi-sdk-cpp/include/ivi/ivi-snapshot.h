@@ -0,0 +1,178 @@
+#ifndef __IVI_SNAPSHOT_H__
+#define __IVI_SNAPSHOT_H__
+
+#include "ivi/ivi-cache.h"
+#include "ivi/ivi-model.h"
+#include "ivi/ivi-sdk.h"
+#include "ivi/ivi-types.h"
+
+/*
+* Cache snapshots for warm restarts.  A snapshot is a single versioned file holding
+* item types, players and items as serialized protobuf records, each section with an
+* index sorted by key hash.  Opening a snapshot maps the file read-only and only
+* validates the headers, records are parsed when they are looked up or loaded.
+*
+* Typical use on startup:
+*   auto snapshot(IVISnapshot::Open(path));
+*   if (snapshot) { snapshot->LoadInto(itemTypeCache); snapshot->LoadInto(playerCache); }
+*   callbacks.onItemTypeUpdated = itemTypeCache.Hook(...);   // reconciles from here on
+*   // optionally reseed in the background, anything changed while the server was down
+*   // is only known to the Get* RPCs, see IVISnapshot::CreatedTimestamp
+* and on shutdown or periodically:
+*   IVISnapshotWriter writer; writer.Add(itemTypeCache); writer.Add(playerCache); writer.Write(path);
+*
+* Snapshots are a local cache format, not an interchange format: they are only readable
+* by a build with the same snapshot version and byte order.
+*/
+
+namespace ivi
+{
+    // Read-only memory mapping of a whole file
+    class IVI_SDK_API IVIMappedFile
+        : private NonCopyable<IVIMappedFile>
+    {
+    public:
+                                    IVIMappedFile();
+                                    ~IVIMappedFile();
+
+        // false if the file cannot be opened or is empty
+        bool                        Open(
+                                        const string& path);
+
+        void                        Close();
+
+        bool                        IsOpen() const      { return m_data != nullptr; }
+        const char*                 Data() const        { return m_data; }
+        size_t                      Size() const        { return m_size; }
+
+    private:
+        const char*                 m_data;
+        size_t                      m_size;
+    };
+
+    enum class IVISnapshotSection : uint32_t
+    {
+        ITEM_TYPES = 1,
+        PLAYERS = 2,
+        ITEMS = 3
+    };
+
+    class IVI_SDK_API IVISnapshotWriter
+        : private NonCopyable<IVISnapshotWriter>
+    {
+    public:
+                                    IVISnapshotWriter();
+                                    ~IVISnapshotWriter();
+
+        void                        Add(
+                                        const IVIItemType& itemType);
+
+        void                        Add(
+                                        const IVIPlayer& player);
+
+        void                        Add(
+                                        const IVIItem& item);
+
+        void                        Add(
+                                        const IVIItemTypeCache& cache);
+
+        void                        Add(
+                                        const IVIPlayerCache& cache);
+
+        void                        Add(
+                                        const IVIItemCache& cache);
+
+        // Writes a temporary file next to path then renames it over path, so a snapshot being
+        // read is never partially written.  Returns false on any file error.
+        bool                        Write(
+                                        const string& path,
+                                        time_t createdTimestamp = time(nullptr)) const;
+
+    private:
+
+        struct Record
+        {
+            uint64_t                keyHash;
+            string                  bytes;      // serialized proto
+        };
+        using RecordList            = vector<Record>;
+
+        RecordList                  m_itemTypes;
+        RecordList                  m_players;
+        RecordList                  m_items;
+    };
+
+    class IVI_SDK_API IVISnapshot
+        : private NonCopyable<IVISnapshot>
+    {
+    public:
+        // nullptr if the file is missing, truncated, or from another snapshot version
+        static unique_ptr<IVISnapshot> Open(
+                                        const string& path);
+
+                                    ~IVISnapshot();
+
+        time_t                      CreatedTimestamp() const;
+
+        size_t                      Count(
+                                        IVISnapshotSection section) const;
+
+        // O(log n) over the section index, parses just the matching record
+        bool                        FindItemType(
+                                        const string& gameItemTypeId,
+                                        IVIItemType& outItemType) const;
+
+        bool                        FindPlayer(
+                                        const string& playerId,
+                                        IVIPlayer& outPlayer) const;
+
+        bool                        FindItem(
+                                        const string& gameInventoryId,
+                                        IVIItem& outItem) const;
+
+        // Parse every record of the section, return the number loaded
+        size_t                      LoadInto(
+                                        IVIItemTypeCache& cache) const;
+
+        size_t                      LoadInto(
+                                        IVIPlayerCache& cache) const;
+
+        // Loaded items get a fresh TTL
+        size_t                      LoadInto(
+                                        IVIItemCache& cache) const;
+
+        size_t                      ForEachItem(
+                                        const function<void(const IVIItem&)>& visitor) const;
+
+    private:
+
+        struct SectionView
+        {
+            const char*             index;      // IndexEntry array, sorted by keyHash
+            const char*             data;
+            uint32_t                count;
+        };
+
+                                    IVISnapshot();
+
+        template<typename TProto>
+        bool                        FindRecord(
+                                        IVISnapshotSection section,
+                                        const string& key,
+                                        TProto& outProto) const;
+
+        template<typename TProto>
+        size_t                      ForEachRecord(
+                                        IVISnapshotSection section,
+                                        const function<void(const TProto&)>& visitor) const;
+
+        const SectionView&          Section(
+                                        IVISnapshotSection section) const;
+
+        IVIMappedFile               m_file;
+        time_t                      m_createdTimestamp;
+        SectionView                 m_sections[3];
+    };
+} // namespace ivi
+
+#endif // __IVI_SNAPSHOT_H__
@@ -0,0 +1,132 @@
+#ifndef __IVI_TABLE_H__
+#define __IVI_TABLE_H__
+
+#include "ivi/ivi-enum.h"
+#include "ivi/ivi-model.h"
+#include "ivi/ivi-sdk.h"
+#include "ivi/ivi-types.h"
+
+/*
+* Structure-of-arrays counterpart of IVIItemList for bulk inventory data.  Every IVIItem field
+* is a column of its own, so a scan such as counting items per itemState per gameItemTypeId
+* reads two dense arrays of small integers instead of striding over whole items.
+* Fixed-width fields are plain vectors.  The fields whose values repeat across many items, the
+* ones IVI_SDK_INTERNED_STRINGS pools, are dictionary encoded: a uint32 code per row indexing
+* the distinct values of the column, which also store each value once.
+* IVIItemClient::GetItems and IVIItemTablePager fill tables straight from the response messages,
+* without building an IVIItem per row.
+*/
+
+namespace ivi
+{
+    class IVI_SDK_API IVIDictionaryColumn
+    {
+    public:
+        using Code                  = uint32_t;
+
+        // Appends a row, returns its code
+        Code                        Append(
+                                        const string& value);
+
+        // Appends all rows of other, looking up each of its distinct values once
+        void                        Append(
+                                        const IVIDictionaryColumn& other);
+
+        // Code of value if any row has it, eg to filter a scan of Codes() by a value
+        bool                        Find(
+                                        const string& value,
+                                        Code& outCode) const;
+
+        const string&               operator[](size_t row) const    { return m_values[m_codes[row]]; }
+
+        // One code per row
+        const vector<Code>&         Codes() const                   { return m_codes; }
+
+        // The distinct values indexed by code, in order of first appearance
+        const vector<string>&       Values() const                  { return m_values; }
+
+        size_t                      size() const                    { return m_codes.size(); }
+        bool                        empty() const                   { return m_codes.empty(); }
+        void                        reserve(size_t rows)            { m_codes.reserve(rows); }
+        void                        clear();
+
+    private:
+        vector<Code>                m_codes;
+        vector<string>              m_values;
+        unordered_map<string, Code> m_index;
+    };
+
+    /*
+    * Columns are named after the IVIItem fields and all hold size() rows, the row order being the
+    * order the items were appended in.  Rows are added through Append, columns are read-only.
+    */
+    class IVI_SDK_API IVIItemTable
+    {
+    public:
+        void                        Append(
+                                        const proto::api::item::Item& item);
+
+        // Moves the strings out of item
+        void                        Append(
+                                        proto::api::item::Item&& item);
+
+        void                        Append(
+                                        const IVIItem& item);
+
+        // Appends all rows of other, remapping its dictionary codes once per distinct value
+        void                        Append(
+                                        const IVIItemTable& other);
+
+        void                        AppendRow(
+                                        const IVIItemTable& other,
+                                        size_t row);
+
+        // Materializes one row
+        IVIItem                     Row(
+                                        size_t row) const;
+
+        size_t                      size() const                    { return m_dgoodsId.size(); }
+        bool                        empty() const                   { return m_dgoodsId.empty(); }
+        void                        reserve(size_t rows);
+        void                        clear();
+
+        const vector<string>&                   gameInventoryId() const         { return m_gameInventoryId; }
+        const IVIDictionaryColumn&              gameItemTypeId() const          { return m_gameItemTypeId; }
+        const vector<int64_t>&                  dgoodsId() const                { return m_dgoodsId; }
+        const IVIDictionaryColumn&              itemName() const                { return m_itemName; }
+        const vector<string>&                   playerId() const                { return m_playerId; }
+        const IVIDictionaryColumn&              ownerSidechainAccount() const   { return m_ownerSidechainAccount; }
+        const vector<int32_t>&                  serialNumber() const            { return m_serialNumber; }
+        const IVIDictionaryColumn&              currencyBase() const            { return m_currencyBase; }
+        const vector<string>&                   metadataUri() const             { return m_metadataUri; }
+        const vector<string>&                   trackingId() const              { return m_trackingId; }
+        const vector<string>&                   metadataName() const            { return m_metadataName; }
+        const vector<string>&                   metadataDescription() const     { return m_metadataDescription; }
+        const IVIDictionaryColumn&              metadataImage() const           { return m_metadataImage; }
+        const vector<IVIMetadataProperties>&    metadataProperties() const      { return m_metadataProperties; }
+        const vector<time_t>&                   createdTimestamp() const        { return m_createdTimestamp; }
+        const vector<time_t>&                   updatedTimestamp() const        { return m_updatedTimestamp; }
+        const vector<ItemState>&                itemState() const               { return m_itemState; }
+
+    private:
+        vector<string>                  m_gameInventoryId;
+        IVIDictionaryColumn             m_gameItemTypeId;
+        vector<int64_t>                 m_dgoodsId;
+        IVIDictionaryColumn             m_itemName;
+        vector<string>                  m_playerId;
+        IVIDictionaryColumn             m_ownerSidechainAccount;
+        vector<int32_t>                 m_serialNumber;
+        IVIDictionaryColumn             m_currencyBase;
+        vector<string>                  m_metadataUri;
+        vector<string>                  m_trackingId;
+        vector<string>                  m_metadataName;
+        vector<string>                  m_metadataDescription;
+        IVIDictionaryColumn             m_metadataImage;
+        vector<IVIMetadataProperties>   m_metadataProperties;
+        vector<time_t>                  m_createdTimestamp;
+        vector<time_t>                  m_updatedTimestamp;
+        vector<ItemState>               m_itemState;
+    };
+} // namespace ivi
+
+#endif // __IVI_TABLE_H__
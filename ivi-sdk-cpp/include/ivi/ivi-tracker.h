@@ -0,0 +1,268 @@
+#ifndef __IVI_TRACKER_H__
+#define __IVI_TRACKER_H__
+
+#include "ivi/ivi-client.h"
+#include "ivi/ivi-executor.h"
+#include "ivi/ivi-model.h"
+#include "ivi/ivi-types.h"
+
+#include <chrono>
+#include <future>
+#include <mutex>
+
+/*
+* Trackers follow the state of IVI entities as reported by the data streams and
+* notify callers when an entity reaches a state they are waiting for, replacing
+* polling of the Get* RPCs.
+*/
+
+namespace ivi
+{
+    using IVIResultOrderState           = IVIResultT<OrderState>;
+
+    /*
+    * Tracks the OrderState of orders keyed by orderId.  Feed it IVIOrderStatusUpdate stream
+    * messages via Hook or ApplyUpdate, and optionally the state of orders already known from
+    * CreatePrimaryOrder/GetOrder results via Track.
+    * Waiters are one-shot, their callback is invoked exactly once with:
+    *   SUCCESS   - the order reached the target state
+    *   ABORTED   - the order reached a different final state (COMPLETE, DECLINED, FAILED, EXPIRED)
+    *   TIMEOUT   - the timeout passed first, timeouts are only checked by ProcessTimeouts
+    * The payload is the last known state of the order.
+    * Memory is bounded: once an order reaches a final state no waiters remain, its state is kept
+    * for finalStateTtlMs so late WaitFor calls are still answered immediately, and at most
+    * maxFinalStates final states are kept, oldest dropped first.  Expiry is done by ProcessTimeouts.
+    * Orders in other states are kept until they reach a final state, which the server eventually
+    * reports for every order, or until Forget.
+    * All member functions are thread-safe, callbacks are invoked without any lock held,
+    * on the thread that applied the update or processed the timeouts.
+    */
+    class IVI_SDK_API IVIOrderTracker
+        : private NonCopyable<IVIOrderTracker>
+    {
+    public:
+        using Clock                 = std::chrono::steady_clock;
+        using OnOrderState          = function<void(const IVIResultOrderState&)>;
+
+        static constexpr uint32_t   DefaultFinalStateTtlMs = 24 * 60 * 60 * 1000;
+        static constexpr size_t     DefaultMaxFinalStates = 100000;
+
+                                    IVIOrderTracker(
+                                        uint32_t finalStateTtlMs = DefaultFinalStateTtlMs,
+                                        size_t maxFinalStates = DefaultMaxFinalStates);
+                                    ~IVIOrderTracker();
+
+        void                        Track(
+                                        const IVIOrder& order);
+
+        void                        ApplyUpdate(
+                                        const IVIOrderStatusUpdate& update);
+
+        // Wraps a stream callback so the tracker is updated before it is called, eg
+        //   callbacks.onOrderUpdated = tracker.Hook(callbacks.onOrderUpdated);
+        // The tracker must outlive the client manager the callback is given to.
+        OnOrderUpdated              Hook(
+                                        const OnOrderUpdated& next);
+
+        // Calls back immediately if the order is already known to be in the target or a final state
+        void                        WaitFor(
+                                        const string& orderId,
+                                        OrderState targetState,
+                                        uint32_t timeoutMs,
+                                        const OnOrderState& callback);
+
+        // Fails waiters whose timeout has passed and drops expired final states, call regularly, eg after
+        // each IVIClientManagerAsync::Poll.  Returns the number of waiters timed out.
+        size_t                      ProcessTimeouts(
+                                        Clock::time_point now = Clock::now());
+
+        // Drops the order's last known state, does not affect its waiters
+        void                        Forget(
+                                        const string& orderId);
+
+        // false if no update for the order has been seen
+        bool                        GetState(
+                                        const string& orderId,
+                                        OrderState& outState) const;
+
+        size_t                      WaiterCount() const;
+
+        static bool                 IsFinalState(
+                                        OrderState state);
+
+    private:
+
+        struct Waiter
+        {
+            string                  orderId;
+            OrderState              targetState;
+            OnOrderState            callback;
+            bool                    done;
+        };
+        using WaiterPtr             = shared_ptr<Waiter>;
+        using WaiterList            = list<WaiterPtr>;
+        using Notification          = pair<WaiterPtr, IVIResultOrderState>;
+
+        struct FinalState
+        {
+            string                  orderId;
+            Clock::time_point       expires;
+        };
+        using FinalStateList        = list<FinalState>;    // oldest first, the TTL is fixed so this is also expiry order
+
+        struct State
+        {
+            OrderState              state;
+            bool                    final;
+            FinalStateList::iterator finalState;    // only when final
+        };
+        using StateMap              = unordered_map<string, State>;
+
+        void                        SetState(
+                                        const string& orderId,
+                                        OrderState state);
+
+        void                        EraseStateLocked(
+                                        StateMap::iterator state);
+
+        static void                 Notify(
+                                        const vector<Notification>& notifications);
+
+        const std::chrono::milliseconds m_finalStateTtl;
+        const size_t                m_maxFinalStates;
+        mutable std::mutex          m_mutex;
+        StateMap                    m_states;
+        FinalStateList              m_finalStates;
+        unordered_map<string, WaiterList> m_waiters;
+        multimap<Clock::time_point, WaiterPtr> m_deadlines;  // may hold waiters already done
+        size_t                      m_waiterCount;
+    };
+
+    using IVIResultItemStatusUpdate     = IVIResultT<IVIItemStatusUpdate>;
+
+    /*
+    * Correlates item state changes started by IssueItem, TransferItem, BurnItem etc with the
+    * IVIItemStatusUpdate stream message carrying the same trackingId and a final (non-PENDING)
+    * ItemState.  Feed it stream messages via Hook or ApplyUpdate.  Completions are one-shot:
+    *   SUCCESS             - the final update arrived, it is the payload
+    *   TIMEOUT             - expiryMs passed first, only checked by ProcessTimeouts
+    *   RESOURCE_EXHAUSTED  - maxTracked trackingIds are already awaiting their final update
+    *   or the failure status of the RPC when wrapped with TrackOnSuccess
+    * Final updates that arrive before their trackingId is tracked, eg when the stream is polled
+    * before the unary response, are kept for expiryMs, up to maxBuffered of them, oldest dropped first.
+    * Memory is fixed at construction: an open-addressing hash index over a preallocated entry pool.
+    * All member functions are thread-safe, callbacks are invoked without any lock held.
+    */
+    class IVI_SDK_API IVIItemTracker
+        : private NonCopyable<IVIItemTracker>
+    {
+    public:
+        using Clock                 = std::chrono::steady_clock;
+        using OnCompleted           = function<void(const IVIResultItemStatusUpdate&)>;
+        using OnStateChange         = function<void(const IVIResultItemStateChange&)>;
+
+                                    IVIItemTracker(
+                                        uint32_t maxTracked,
+                                        uint32_t maxBuffered,
+                                        uint32_t expiryMs);
+                                    ~IVIItemTracker();
+
+        void                        Track(
+                                        const string& trackingId,
+                                        const OnCompleted& onCompleted);
+
+        std::future<IVIResultItemStatusUpdate> Await(
+                                        const string& trackingId);
+
+        // Returns a callback for IssueItem, TransferItem, BurnItem etc which tracks the trackingId of a successful
+        // result, or calls onCompleted with the failure status, eg
+        //   client.BurnItem(gameInventoryId, tracker.TrackOnSuccess(onBurned));
+        OnStateChange               TrackOnSuccess(
+                                        const OnCompleted& onCompleted);
+
+        void                        ApplyUpdate(
+                                        const IVIItemStatusUpdate& update);
+
+        // Wraps a stream callback so the tracker is updated before it is called, eg
+        //   callbacks.onItemUpdated = tracker.Hook(callbacks.onItemUpdated);
+        // The tracker must outlive the client manager the callback is given to.
+        OnItemUpdated               Hook(
+                                        const OnItemUpdated& next);
+
+        // Expires tracked and buffered entries older than expiryMs, call regularly, eg after each
+        // IVIClientManagerAsync::Poll.  Returns the number of tracked entries timed out.
+        size_t                      ProcessTimeouts(
+                                        Clock::time_point now = Clock::now());
+
+        size_t                      TrackedCount() const;
+
+        size_t                      BufferedCount() const;
+
+        static bool                 IsFinalState(
+                                        ItemState state);
+
+    private:
+
+        static constexpr uint32_t   NoEntry = numeric_limits<uint32_t>::max();
+
+        // Index slots hold the low hash bits next to the entry so most probe misses never touch the pool
+        struct Slot
+        {
+            uint32_t                hashTag;
+            uint32_t                entry;      // NoEntry for empty, TombstoneEntry for erased
+        };
+        static constexpr uint32_t   TombstoneEntry = NoEntry - 1;
+
+        // Tracked or buffered entries are kept on separate age-ordered lists, linked by pool index
+        struct Entry
+        {
+            string                  trackingId;
+            size_t                  hash;
+            OnCompleted             onCompleted;    // empty when buffered
+            IVIItemStatusUpdate     update;         // only when buffered
+            Clock::time_point       deadline;
+            uint32_t                prev;
+            uint32_t                next;
+        };
+
+        struct AgeList
+        {
+            uint32_t                head;       // oldest
+            uint32_t                tail;
+            uint32_t                count;
+        };
+
+        using Completion            = pair<OnCompleted, IVIResultItemStatusUpdate>;
+
+        uint32_t                    FindLocked(
+                                        const string& trackingId,
+                                        size_t hash) const;
+
+        uint32_t                    InsertLocked(
+                                        const string& trackingId,
+                                        size_t hash,
+                                        AgeList& ageList);
+
+        void                        EraseLocked(
+                                        uint32_t entry,
+                                        AgeList& ageList);
+
+        void                        RebuildIndexLocked();
+
+        static void                 Complete(
+                                        vector<Completion>& completions);
+
+        const uint32_t              m_maxTracked;
+        const uint32_t              m_maxBuffered;
+        const std::chrono::milliseconds m_expiry;
+        mutable std::mutex          m_mutex;
+        vector<Slot>                m_slots;        // power of two sized
+        uint32_t                    m_tombstones;
+        vector<Entry>               m_entries;
+        vector<uint32_t>            m_freeEntries;
+        AgeList                     m_tracked;
+        AgeList                     m_buffered;
+    };
+} // namespace ivi
+
+#endif // __IVI_TRACKER_H__
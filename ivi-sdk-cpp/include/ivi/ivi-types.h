@@ -7,12 +7,15 @@
 #include <functional>
 #include <iterator>
 #include <list>
+#include <map>
 #include <memory>
 #include <sstream>
 #include <string>
 #include <tuple>
 #include <type_traits>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 /*
 * Forward declarations and type aliases for shared types in the IVI SDK.
@@ -41,6 +44,7 @@ namespace ivi
     // STL aliases in case they need to be changed to alternate implementations
     using std::back_inserter;
     using std::enable_if;
+    using std::enable_shared_from_this;
     using std::forward;
     using std::function;
     using std::get;
@@ -51,8 +55,11 @@ namespace ivi
     using std::list;
     using std::make_pair;
     using std::make_shared;
+    using std::map;
     using std::move;
+    using std::multimap;
     using std::numeric_limits;
+    using std::pair;
     using std::ostringstream;
     using std::shared_ptr;
     using std::stoi;
@@ -61,38 +68,63 @@ namespace ivi
     using std::transform;
     using std::tuple;
     using std::unique_ptr;
+    using std::unordered_map;
+    using std::vector;
+
+    // Container of the model list types below.  std::list by default, so existing code relying on
+    // list-only members or iterator stability keeps working.  Building with IVI_SDK_VECTOR_LISTS
+    // (CMake option of the same name) makes them contiguous, saving an allocation per element
+    // and speeding up iteration, the SDK itself only relies on what both containers provide.
+#ifdef IVI_SDK_VECTOR_LISTS
+    template<typename T>
+    using IVIListT                  = vector<T>;
+#else
+    template<typename T>
+    using IVIListT                  = list<T>;
+#endif
+
+    // Reserves room for count elements when the container supports it
+    template<typename T>
+    inline void Reserve(list<T>& /*container*/, size_t /*count*/) {}
+
+    template<typename T>
+    inline void Reserve(vector<T>& container, size_t count) { container.reserve(count); }
 
     using UUID                      = string;
-    using UUIDList                  = list<string>;
+    using UUIDList                  = IVIListT<string>;
 
 
     using BigDecimal                = string;
 
-    using StringList                = list<string>;
+    using StringList                = IVIListT<string>;
 
     struct IVIItem;
-    using IVIItemList               = list<IVIItem>;
+    using IVIItemList               = IVIListT<IVIItem>;
+    class IVIItemTable;
 
     struct IVIItemType;
-    using IVIItemTypeList           = list<IVIItemType>;
+    using IVIItemTypeList           = IVIListT<IVIItemType>;
 
     struct IVIItemStateChange;
+
+    struct IVIIssueItemSpec;
+    using IVIIssueItemSpecList      = vector<IVIIssueItemSpec>;
     struct IVIItemTypeStateChange;
 
     struct IVIMetadata;
 
     struct IVIMetadataUpdate;
-    using IVIMetadataUpdateList     = list<IVIMetadataUpdate>;
+    using IVIMetadataUpdateList     = IVIListT<IVIMetadataUpdate>;
 
     struct IVIOrder;
     struct IVIOrderAddress;
     struct IVIFinalizeOrderResponse;
 
     struct IVIPlayer;
-    using IVIPlayerList             = list<IVIPlayer>;
+    using IVIPlayerList             = IVIListT<IVIPlayer>;
 
     struct IVIPurchasedItems;
-    using IVIPurchasedItemsList      = list<IVIPurchasedItems>;
+    using IVIPurchasedItemsList      = IVIListT<IVIPurchasedItems>;
 
     struct IVIToken;
 
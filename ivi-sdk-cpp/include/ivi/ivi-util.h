@@ -173,4 +173,8 @@
 #define IVI_LOG_FUNC() IVI_LOG_SCOPE(__func__)
 #define IVI_LOG_FUNC_TRIVIAL() IVI_LOG_DTRACE(__func__)
 
+// A string field of a protobuf message about to be discarded, its buffer moved out rather than copied.
+// An empty field is left alone since taking its mutable pointer would allocate.
+#define IVI_TAKE_STRING(message, field) ((message).field().empty() ? std::string() : std::move(*(message).mutable_##field()))
+
 #endif //__IVI_UTIL_H__
@@ -0,0 +1,804 @@
+#include "ivi/ivi-binary.h"
+#include "ivi/ivi-util.h"
+
+#include <climits>
+#include <cstring>
+
+#include "google/protobuf/struct.pb.h"
+
+namespace ivi
+{
+    static const char       BinaryMagic[2] = { 'I', 'V' };
+    static const uint8_t    BinaryVersion = 1;
+    static const size_t     BinaryHeaderSize = 4;
+
+    //////////////////////////////////////////////////////////////////////////
+    // IVIStringView
+    //////////////////////////////////////////////////////////////////////////
+
+    bool operator==(const IVIStringView& lhs, const string& rhs)
+    {
+        return lhs.size == rhs.size() && (lhs.size == 0 || memcmp(lhs.data, rhs.data(), lhs.size) == 0);
+    }
+
+    bool operator!=(const IVIStringView& lhs, const string& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    std::ostream& operator<<(std::ostream& out, const IVIStringView& value)
+    {
+        return out.write(value.data, static_cast<std::streamsize>(value.size));
+    }
+
+    bool IVIBinaryPeekType(const char* data, size_t size, IVIBinaryType& outType)
+    {
+        if (data == nullptr
+            || size < BinaryHeaderSize
+            || data[0] != BinaryMagic[0]
+            || data[1] != BinaryMagic[1]
+            || static_cast<uint8_t>(data[2]) != BinaryVersion
+            || static_cast<uint8_t>(data[3]) < static_cast<uint8_t>(IVIBinaryType::ITEM)
+            || static_cast<uint8_t>(data[3]) > static_cast<uint8_t>(IVIBinaryType::ORDER_STATUS_UPDATE))
+        {
+            return false;
+        }
+        outType = static_cast<IVIBinaryType>(data[3]);
+        return true;
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // Writer and reader
+    //////////////////////////////////////////////////////////////////////////
+
+    class BinaryWriter
+    {
+    public:
+        BinaryWriter(string& out, IVIBinaryType type, size_t sizeHint)
+            : m_out(out)
+        {
+            m_out.reserve(m_out.size() + BinaryHeaderSize + sizeHint);
+            m_out.push_back(BinaryMagic[0]);
+            m_out.push_back(BinaryMagic[1]);
+            m_out.push_back(static_cast<char>(BinaryVersion));
+            m_out.push_back(static_cast<char>(type));
+        }
+
+        void Varint(uint64_t value)
+        {
+            char bytes[10];
+            size_t size(0);
+            while (value >= 0x80)
+            {
+                bytes[size++] = static_cast<char>(value | 0x80);
+                value >>= 7;
+            }
+            bytes[size++] = static_cast<char>(value);
+            m_out.append(bytes, size);
+        }
+
+        void Signed(int64_t value)
+        {
+            Varint((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+        }
+
+        template<typename TEnum>
+        void Enum(TEnum value)
+        {
+            Varint(static_cast<uint64_t>(static_cast<int>(value)));
+        }
+
+        void String(const string& value)
+        {
+            Varint(value.size());
+            m_out.append(value);
+        }
+
+        void Message(const google::protobuf::MessageLite& message)
+        {
+            const size_t size(message.ByteSizeLong());
+            Varint(size);
+            const size_t offset(m_out.size());
+            m_out.resize(offset + size);
+            message.SerializeWithCachedSizesToArray(reinterpret_cast<uint8_t*>(&m_out[offset]));
+        }
+
+    private:
+        string&                     m_out;
+    };
+
+    // Reads fail sticky: once past the end or on a bad value every later read returns zero values
+    class BinaryReader
+    {
+    public:
+        BinaryReader(const char* data, size_t size, IVIBinaryType type)
+            : m_pos(data)
+            , m_end(data + size)
+            , m_ok(false)
+        {
+            IVIBinaryType actual;
+            m_ok = IVIBinaryPeekType(data, size, actual) && actual == type;
+            m_pos = m_ok ? data + BinaryHeaderSize : m_end;
+        }
+
+        uint64_t Varint()
+        {
+            uint64_t value(0);
+            for (unsigned shift = 0; shift < 64 && m_pos != m_end; shift += 7)
+            {
+                const uint8_t byte(static_cast<uint8_t>(*m_pos++));
+                value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+                if ((byte & 0x80) == 0)
+                {
+                    return value;
+                }
+            }
+            Fail();
+            return 0;
+        }
+
+        int64_t Signed()
+        {
+            const uint64_t value(Varint());
+            return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+        }
+
+        int32_t Signed32()
+        {
+            const int64_t value(Signed());
+            if (value < INT32_MIN || value > INT32_MAX)
+            {
+                Fail();
+                return 0;
+            }
+            return static_cast<int32_t>(value);
+        }
+
+        template<typename TEnum>
+        TEnum Enum(bool (*isValid)(int))
+        {
+            const uint64_t value(Varint());
+            if (value > INT_MAX || !isValid(static_cast<int>(value)))
+            {
+                Fail();
+                return TEnum();
+            }
+            return static_cast<TEnum>(value);
+        }
+
+        IVIStringView String()
+        {
+            IVIStringView view;
+            const uint64_t size(Varint());
+            if (size > static_cast<uint64_t>(m_end - m_pos))
+            {
+                Fail();
+                return view;
+            }
+            view.data = m_pos;
+            view.size = static_cast<size_t>(size);
+            m_pos += view.size;
+            return view;
+        }
+
+        // Count of a repeated field, each element taking at least a byte
+        size_t Count()
+        {
+            const uint64_t count(Varint());
+            if (count > static_cast<uint64_t>(m_end - m_pos))
+            {
+                Fail();
+                return 0;
+            }
+            return static_cast<size_t>(count);
+        }
+
+        void Fail()
+        {
+            m_ok = false;
+            m_pos = m_end;
+        }
+
+        // Succeeded and consumed the whole buffer
+        bool Done() const                   { return m_ok && m_pos == m_end; }
+
+    private:
+        const char*                 m_pos;
+        const char*                 m_end;
+        bool                        m_ok;
+    };
+
+    //////////////////////////////////////////////////////////////////////////
+    // Metadata
+    //////////////////////////////////////////////////////////////////////////
+
+    static size_t SizeHint(const IVIMetadata& metadata)
+    {
+        return metadata.name.size() + metadata.description.size() + metadata.image.size() + MetadataPropertiesByteSize(metadata.properties) + 16;
+    }
+
+    static void Write(BinaryWriter& writer, const IVIMetadata& metadata)
+    {
+        writer.String(metadata.name);
+        writer.String(metadata.description);
+        writer.String(metadata.image);
+
+        // A kept Struct is written as is, reading Json() would serialize it
+        const shared_ptr<const google::protobuf::Struct> protoStruct(MetadataPropertiesStruct(metadata.properties));
+        if (protoStruct)
+        {
+            writer.Enum(IVIBinaryProperties::STRUCT);
+            writer.Message(*protoStruct);
+        }
+        else if (!metadata.properties.empty())
+        {
+            writer.Enum(IVIBinaryProperties::JSON);
+            writer.String(static_cast<const string&>(metadata.properties));
+        }
+        else
+        {
+            writer.Enum(IVIBinaryProperties::NONE);
+        }
+    }
+
+    static void Read(BinaryReader& reader, IVIMetadataView& out)
+    {
+        out.name = reader.String();
+        out.description = reader.String();
+        out.image = reader.String();
+        const uint64_t form(reader.Varint());
+        if (form > static_cast<uint64_t>(IVIBinaryProperties::STRUCT))
+        {
+            reader.Fail();
+            return;
+        }
+        out.propertiesForm = static_cast<IVIBinaryProperties>(form);
+        out.properties = out.propertiesForm == IVIBinaryProperties::NONE ? IVIStringView() : reader.String();
+    }
+
+    IVIMetadata IVIMetadataView::ToModel() const
+    {
+        IVIMetadata metadata{ name.str(), description.str(), image.str(), {} };
+        if (propertiesForm == IVIBinaryProperties::JSON)
+        {
+            metadata.properties = IVIMetadataProperties(properties.str());
+        }
+        else if (propertiesForm == IVIBinaryProperties::STRUCT)
+        {
+            google::protobuf::Struct protoStruct;
+            if (properties.size <= static_cast<size_t>(INT_MAX)
+                && protoStruct.ParseFromArray(properties.data, static_cast<int>(properties.size)))
+            {
+                metadata.properties = MetadataPropertiesFromStruct(move(protoStruct));
+            }
+            else
+            {
+                IVI_LOG_WARNING("IVIMetadataView dropping unparseable properties of ", name);
+            }
+        }
+        return metadata;
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // IVIItem
+    //////////////////////////////////////////////////////////////////////////
+
+    void IVIBinaryEncode(const IVIItem& item, string& out)
+    {
+        BinaryWriter writer(out, IVIBinaryType::ITEM,
+            item.gameInventoryId.size() + item.gameItemTypeId.size() + item.itemName.size() + item.playerId.size()
+            + item.ownerSidechainAccount.size() + item.currencyBase.size() + item.metadataUri.size() + item.trackingId.size()
+            + SizeHint(item.metadata) + 48);
+        writer.String(item.gameInventoryId);
+        writer.String(item.gameItemTypeId);
+        writer.Signed(item.dgoodsId);
+        writer.String(item.itemName);
+        writer.String(item.playerId);
+        writer.String(item.ownerSidechainAccount);
+        writer.Signed(item.serialNumber);
+        writer.String(item.currencyBase);
+        writer.String(item.metadataUri);
+        writer.String(item.trackingId);
+        Write(writer, item.metadata);
+        writer.Signed(item.createdTimestamp);
+        writer.Signed(item.updatedTimestamp);
+        writer.Enum(item.itemState);
+    }
+
+    bool IVIItemView::Decode(const char* data, size_t size)
+    {
+        BinaryReader reader(data, size, IVIBinaryType::ITEM);
+        gameInventoryId = reader.String();
+        gameItemTypeId = reader.String();
+        dgoodsId = reader.Signed();
+        itemName = reader.String();
+        playerId = reader.String();
+        ownerSidechainAccount = reader.String();
+        serialNumber = reader.Signed32();
+        currencyBase = reader.String();
+        metadataUri = reader.String();
+        trackingId = reader.String();
+        Read(reader, metadata);
+        createdTimestamp = static_cast<time_t>(reader.Signed());
+        updatedTimestamp = static_cast<time_t>(reader.Signed());
+        itemState = reader.Enum<ItemState>(&proto::common::item::ItemState_IsValid);
+        return reader.Done();
+    }
+
+    IVIItem IVIItemView::ToModel() const
+    {
+        return
+        {
+             gameInventoryId.str()
+            ,gameItemTypeId.str()
+            ,dgoodsId
+            ,itemName.str()
+            ,playerId.str()
+            ,ownerSidechainAccount.str()
+            ,serialNumber
+            ,currencyBase.str()
+            ,metadataUri.str()
+            ,trackingId.str()
+            ,metadata.ToModel()
+            ,createdTimestamp
+            ,updatedTimestamp
+            ,itemState
+        };
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // IVIItemType
+    //////////////////////////////////////////////////////////////////////////
+
+    enum ItemTypeFlags : uint8_t
+    {
+        ItemTypeFungible        = 1 << 0,
+        ItemTypeBurnable        = 1 << 1,
+        ItemTypeTransferable    = 1 << 2,
+        ItemTypeFinalized       = 1 << 3,
+        ItemTypeSellable        = 1 << 4,
+        ItemTypeAllFlags        = (1 << 5) - 1
+    };
+
+    void IVIBinaryEncode(const IVIItemType& itemType, string& out)
+    {
+        size_t agreementIdsSize(0);
+        for (const string& agreementId : itemType.agreementIds)
+        {
+            agreementIdsSize += agreementId.size() + 1;
+        }
+
+        BinaryWriter writer(out, IVIBinaryType::ITEM_TYPE,
+            itemType.gameItemTypeId.size() + itemType.issuer.size() + itemType.category.size() + itemType.tokenName.size()
+            + itemType.baseUri.size() + agreementIdsSize + itemType.trackingId.size() + SizeHint(itemType.metadata) + 48);
+        writer.String(itemType.gameItemTypeId);
+        writer.Signed(itemType.maxSupply);
+        writer.Signed(itemType.currentSupply);
+        writer.Signed(itemType.issuedSupply);
+        writer.String(itemType.issuer);
+        writer.Signed(itemType.issueTimeSpan);
+        writer.String(itemType.category);
+        writer.String(itemType.tokenName);
+        writer.String(itemType.baseUri);
+        writer.Varint(itemType.agreementIds.size());
+        for (const string& agreementId : itemType.agreementIds)
+        {
+            writer.String(agreementId);
+        }
+        writer.String(itemType.trackingId);
+        Write(writer, itemType.metadata);
+        writer.Signed(itemType.createdTimestamp);
+        writer.Signed(itemType.updatedTimestamp);
+        writer.Enum(itemType.itemTypeState);
+        writer.Varint(
+              (itemType.fungible ? ItemTypeFungible : 0)
+            | (itemType.burnable ? ItemTypeBurnable : 0)
+            | (itemType.transferable ? ItemTypeTransferable : 0)
+            | (itemType.finalized ? ItemTypeFinalized : 0)
+            | (itemType.sellable ? ItemTypeSellable : 0));
+    }
+
+    bool IVIItemTypeView::Decode(const char* data, size_t size)
+    {
+        BinaryReader reader(data, size, IVIBinaryType::ITEM_TYPE);
+        gameItemTypeId = reader.String();
+        maxSupply = reader.Signed32();
+        currentSupply = reader.Signed32();
+        issuedSupply = reader.Signed32();
+        issuer = reader.String();
+        issueTimeSpan = reader.Signed32();
+        category = reader.String();
+        tokenName = reader.String();
+        baseUri = reader.String();
+        const size_t agreementIdCount(reader.Count());
+        agreementIds.clear();
+        agreementIds.reserve(agreementIdCount);
+        for (size_t index = 0; index < agreementIdCount; ++index)
+        {
+            agreementIds.push_back(reader.String());
+        }
+        trackingId = reader.String();
+        Read(reader, metadata);
+        createdTimestamp = static_cast<time_t>(reader.Signed());
+        updatedTimestamp = static_cast<time_t>(reader.Signed());
+        itemTypeState = reader.Enum<ItemTypeState>(&proto::common::itemtype::ItemTypeState_IsValid);
+        const uint64_t flags(reader.Varint());
+        if (flags & ~static_cast<uint64_t>(ItemTypeAllFlags))
+        {
+            reader.Fail();
+        }
+        fungible = (flags & ItemTypeFungible) != 0;
+        burnable = (flags & ItemTypeBurnable) != 0;
+        transferable = (flags & ItemTypeTransferable) != 0;
+        finalized = (flags & ItemTypeFinalized) != 0;
+        sellable = (flags & ItemTypeSellable) != 0;
+        return reader.Done();
+    }
+
+    IVIItemType IVIItemTypeView::ToModel() const
+    {
+        UUIDList agreementIdList;
+        for (const IVIStringView& agreementId : agreementIds)
+        {
+            agreementIdList.push_back(agreementId.str());
+        }
+
+        return
+        {
+             gameItemTypeId.str()
+            ,maxSupply
+            ,currentSupply
+            ,issuedSupply
+            ,issuer.str()
+            ,issueTimeSpan
+            ,category.str()
+            ,tokenName.str()
+            ,baseUri.str()
+            ,move(agreementIdList)
+            ,trackingId.str()
+            ,metadata.ToModel()
+            ,createdTimestamp
+            ,updatedTimestamp
+            ,itemTypeState
+            ,fungible
+            ,burnable
+            ,transferable
+            ,finalized
+            ,sellable
+        };
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // IVIPlayer
+    //////////////////////////////////////////////////////////////////////////
+
+    void IVIBinaryEncode(const IVIPlayer& player, string& out)
+    {
+        BinaryWriter writer(out, IVIBinaryType::PLAYER,
+            player.playerId.size() + player.email.size() + player.displayName.size()
+            + player.sidechainAccountName.size() + player.trackingId.size() + 24);
+        writer.String(player.playerId);
+        writer.String(player.email);
+        writer.String(player.displayName);
+        writer.String(player.sidechainAccountName);
+        writer.String(player.trackingId);
+        writer.Signed(player.createdTimestamp);
+        writer.Enum(player.playerState);
+    }
+
+    bool IVIPlayerView::Decode(const char* data, size_t size)
+    {
+        BinaryReader reader(data, size, IVIBinaryType::PLAYER);
+        playerId = reader.String();
+        email = reader.String();
+        displayName = reader.String();
+        sidechainAccountName = reader.String();
+        trackingId = reader.String();
+        createdTimestamp = static_cast<time_t>(reader.Signed());
+        playerState = reader.Enum<PlayerState>(&proto::common::player::PlayerState_IsValid);
+        return reader.Done();
+    }
+
+    IVIPlayer IVIPlayerView::ToModel() const
+    {
+        return
+        {
+             playerId.str()
+            ,email.str()
+            ,displayName.str()
+            ,sidechainAccountName.str()
+            ,trackingId.str()
+            ,createdTimestamp
+            ,playerState
+        };
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // IVIOrder
+    //////////////////////////////////////////////////////////////////////////
+
+    IVIOrderAddress IVIOrderAddressView::ToModel() const
+    {
+        return
+        {
+             firstName.str()
+            ,lastName.str()
+            ,addressLine1.str()
+            ,addressLine2.str()
+            ,city.str()
+            ,state.str()
+            ,postalCode.str()
+            ,countryName.str()
+            ,countryIsoAlpha2.str()
+        };
+    }
+
+    void IVIBinaryEncode(const IVIOrder& order, string& out)
+    {
+        const IVIOrderAddress& address(order.address);
+        BinaryWriter writer(out, IVIBinaryType::ORDER,
+            order.orderId.size() + order.storeId.size() + order.buyerPlayerId.size() + order.tax.size() + order.total.size()
+            + address.firstName.size() + address.lastName.size() + address.addressLine1.size() + address.addressLine2.size()
+            + address.city.size() + address.state.size() + address.postalCode.size() + address.countryName.size()
+            + address.countryIsoAlpha2.size() + order.metadata.size() + order.createdBy.size() + order.requestIp.size()
+            + order.environmentId.size() + order.bitpayInvoice.size() + 48);
+        writer.String(order.orderId);
+        writer.String(order.storeId);
+        writer.String(order.buyerPlayerId);
+        writer.String(order.tax);
+        writer.String(order.total);
+        writer.String(address.firstName);
+        writer.String(address.lastName);
+        writer.String(address.addressLine1);
+        writer.String(address.addressLine2);
+        writer.String(address.city);
+        writer.String(address.state);
+        writer.String(address.postalCode);
+        writer.String(address.countryName);
+        writer.String(address.countryIsoAlpha2);
+        writer.String(order.metadata);
+        writer.String(order.createdBy);
+        writer.String(order.requestIp);
+        writer.String(order.environmentId);
+        writer.Signed(order.createdTimestamp);
+        writer.String(order.bitpayInvoice);
+        writer.Enum(order.paymentProviderId);
+        writer.Enum(order.orderStatus);
+    }
+
+    bool IVIOrderView::Decode(const char* data, size_t size)
+    {
+        BinaryReader reader(data, size, IVIBinaryType::ORDER);
+        orderId = reader.String();
+        storeId = reader.String();
+        buyerPlayerId = reader.String();
+        tax = reader.String();
+        total = reader.String();
+        address.firstName = reader.String();
+        address.lastName = reader.String();
+        address.addressLine1 = reader.String();
+        address.addressLine2 = reader.String();
+        address.city = reader.String();
+        address.state = reader.String();
+        address.postalCode = reader.String();
+        address.countryName = reader.String();
+        address.countryIsoAlpha2 = reader.String();
+        metadata = reader.String();
+        createdBy = reader.String();
+        requestIp = reader.String();
+        environmentId = reader.String();
+        createdTimestamp = static_cast<time_t>(reader.Signed());
+        bitpayInvoice = reader.String();
+        paymentProviderId = reader.Enum<PaymentProviderId>(&proto::api::order::payment::PaymentProviderId_IsValid);
+        orderStatus = reader.Enum<OrderState>(&proto::common::order::OrderState_IsValid);
+        return reader.Done();
+    }
+
+    IVIOrder IVIOrderView::ToModel() const
+    {
+        return
+        {
+             orderId.str()
+            ,storeId.str()
+            ,buyerPlayerId.str()
+            ,tax.str()
+            ,total.str()
+            ,address.ToModel()
+            ,metadata.str()
+            ,createdBy.str()
+            ,requestIp.str()
+            ,environmentId.str()
+            ,createdTimestamp
+            ,bitpayInvoice.str()
+            ,paymentProviderId
+            ,orderStatus
+        };
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // Status updates
+    //////////////////////////////////////////////////////////////////////////
+
+    void IVIBinaryEncode(const IVIItemStatusUpdate& update, string& out)
+    {
+        BinaryWriter writer(out, IVIBinaryType::ITEM_STATUS_UPDATE,
+            update.gameInventoryId.size() + update.gameItemTypeId.size() + update.playerId.size()
+            + update.metadataUri.size() + update.trackingId.size() + 24);
+        writer.String(update.gameInventoryId);
+        writer.String(update.gameItemTypeId);
+        writer.String(update.playerId);
+        writer.String(update.metadataUri);
+        writer.String(update.trackingId);
+        writer.Signed(update.dgoodsId);
+        writer.Signed(update.serialNumber);
+        writer.Enum(update.itemState);
+    }
+
+    bool IVIItemStatusUpdateView::Decode(const char* data, size_t size)
+    {
+        BinaryReader reader(data, size, IVIBinaryType::ITEM_STATUS_UPDATE);
+        gameInventoryId = reader.String();
+        gameItemTypeId = reader.String();
+        playerId = reader.String();
+        metadataUri = reader.String();
+        trackingId = reader.String();
+        dgoodsId = reader.Signed();
+        serialNumber = reader.Signed32();
+        itemState = reader.Enum<ItemState>(&proto::common::item::ItemState_IsValid);
+        return reader.Done();
+    }
+
+    IVIItemStatusUpdate IVIItemStatusUpdateView::ToModel() const
+    {
+        return
+        {
+             gameInventoryId.str()
+            ,gameItemTypeId.str()
+            ,playerId.str()
+            ,metadataUri.str()
+            ,trackingId.str()
+            ,dgoodsId
+            ,serialNumber
+            ,itemState
+        };
+    }
+
+    void IVIBinaryEncode(const IVIItemTypeStatusUpdate& update, string& out)
+    {
+        BinaryWriter writer(out, IVIBinaryType::ITEM_TYPE_STATUS_UPDATE,
+            update.gameItemTypeId.size() + update.baseUri.size() + update.trackingId.size() + 24);
+        writer.String(update.gameItemTypeId);
+        writer.String(update.baseUri);
+        writer.String(update.trackingId);
+        writer.Signed(update.currentSupply);
+        writer.Signed(update.issuedSupply);
+        writer.Signed(update.issueTimeSpan);
+        writer.Enum(update.itemTypeState);
+    }
+
+    bool IVIItemTypeStatusUpdateView::Decode(const char* data, size_t size)
+    {
+        BinaryReader reader(data, size, IVIBinaryType::ITEM_TYPE_STATUS_UPDATE);
+        gameItemTypeId = reader.String();
+        baseUri = reader.String();
+        trackingId = reader.String();
+        currentSupply = reader.Signed32();
+        issuedSupply = reader.Signed32();
+        issueTimeSpan = reader.Signed32();
+        itemTypeState = reader.Enum<ItemTypeState>(&proto::common::itemtype::ItemTypeState_IsValid);
+        return reader.Done();
+    }
+
+    IVIItemTypeStatusUpdate IVIItemTypeStatusUpdateView::ToModel() const
+    {
+        return
+        {
+             gameItemTypeId.str()
+            ,baseUri.str()
+            ,trackingId.str()
+            ,currentSupply
+            ,issuedSupply
+            ,issueTimeSpan
+            ,itemTypeState
+        };
+    }
+
+    void IVIBinaryEncode(const IVIPlayerStatusUpdate& update, string& out)
+    {
+        BinaryWriter writer(out, IVIBinaryType::PLAYER_STATUS_UPDATE,
+            update.playerId.size() + update.trackingId.size() + 8);
+        writer.String(update.playerId);
+        writer.String(update.trackingId);
+        writer.Enum(update.playerState);
+    }
+
+    bool IVIPlayerStatusUpdateView::Decode(const char* data, size_t size)
+    {
+        BinaryReader reader(data, size, IVIBinaryType::PLAYER_STATUS_UPDATE);
+        playerId = reader.String();
+        trackingId = reader.String();
+        playerState = reader.Enum<PlayerState>(&proto::common::player::PlayerState_IsValid);
+        return reader.Done();
+    }
+
+    IVIPlayerStatusUpdate IVIPlayerStatusUpdateView::ToModel() const
+    {
+        return { playerId.str(), trackingId.str(), playerState };
+    }
+
+    void IVIBinaryEncode(const IVIOrderStatusUpdate& update, string& out)
+    {
+        BinaryWriter writer(out, IVIBinaryType::ORDER_STATUS_UPDATE, update.orderId.size() + 8);
+        writer.String(update.orderId);
+        writer.Enum(update.orderState);
+    }
+
+    bool IVIOrderStatusUpdateView::Decode(const char* data, size_t size)
+    {
+        BinaryReader reader(data, size, IVIBinaryType::ORDER_STATUS_UPDATE);
+        orderId = reader.String();
+        orderState = reader.Enum<OrderState>(&proto::common::order::OrderState_IsValid);
+        return reader.Done();
+    }
+
+    IVIOrderStatusUpdate IVIOrderStatusUpdateView::ToModel() const
+    {
+        return { orderId.str(), orderState };
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // Decoding into models
+    //////////////////////////////////////////////////////////////////////////
+
+    template<typename TView, typename TModel>
+    static bool DecodeModel(const char* data, size_t size, TModel& outModel)
+    {
+        TView view;
+        if (!view.Decode(data, size))
+        {
+            return false;
+        }
+        outModel = view.ToModel();
+        return true;
+    }
+
+    bool IVIBinaryDecode(const char* data, size_t size, IVIItem& outItem)
+    {
+        return DecodeModel<IVIItemView>(data, size, outItem);
+    }
+
+    bool IVIBinaryDecode(const char* data, size_t size, IVIItemType& outItemType)
+    {
+        return DecodeModel<IVIItemTypeView>(data, size, outItemType);
+    }
+
+    bool IVIBinaryDecode(const char* data, size_t size, IVIPlayer& outPlayer)
+    {
+        return DecodeModel<IVIPlayerView>(data, size, outPlayer);
+    }
+
+    bool IVIBinaryDecode(const char* data, size_t size, IVIOrder& outOrder)
+    {
+        return DecodeModel<IVIOrderView>(data, size, outOrder);
+    }
+
+    bool IVIBinaryDecode(const char* data, size_t size, IVIItemStatusUpdate& outUpdate)
+    {
+        return DecodeModel<IVIItemStatusUpdateView>(data, size, outUpdate);
+    }
+
+    bool IVIBinaryDecode(const char* data, size_t size, IVIItemTypeStatusUpdate& outUpdate)
+    {
+        return DecodeModel<IVIItemTypeStatusUpdateView>(data, size, outUpdate);
+    }
+
+    bool IVIBinaryDecode(const char* data, size_t size, IVIPlayerStatusUpdate& outUpdate)
+    {
+        return DecodeModel<IVIPlayerStatusUpdateView>(data, size, outUpdate);
+    }
+
+    bool IVIBinaryDecode(const char* data, size_t size, IVIOrderStatusUpdate& outUpdate)
+    {
+        return DecodeModel<IVIOrderStatusUpdateView>(data, size, outUpdate);
+    }
+} // namespace ivi
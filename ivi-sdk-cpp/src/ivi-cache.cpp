@@ -0,0 +1,798 @@
+#include "ivi/ivi-cache.h"
+#include "ivi/ivi-util.h"
+
+namespace ivi
+{
+    //////////////////////////////////////////////////////////////////////////
+    // IVIInFlightKeys
+    //////////////////////////////////////////////////////////////////////////
+
+    uint64_t IVIInFlightKeys::Begin(const string& key)
+    {
+        InFlight& inFlight(m_keys[key]);    // value-initialized on the first call for key
+        ++inFlight.calls;
+        return inFlight.generation;
+    }
+
+    bool IVIInFlightKeys::End(const string& key, uint64_t generation)
+    {
+        auto inFlight(m_keys.find(key));
+        IVI_CHECK(inFlight != m_keys.end());
+        const bool unchanged(inFlight->second.generation == generation);
+        if (--inFlight->second.calls == 0)
+        {
+            m_keys.erase(inFlight);
+        }
+        return unchanged;
+    }
+
+    void IVIInFlightKeys::Invalidate(const string& key)
+    {
+        auto inFlight(m_keys.find(key));
+        if (inFlight != m_keys.end())
+        {
+            ++inFlight->second.generation;
+        }
+    }
+
+    // Locked by completions for as long as they use the cache, and cleared by the cache's destructor
+    struct IVICacheLifetime
+    {
+        std::mutex                  mutex;
+        bool                        alive = true;
+    };
+
+    static void EndLifetime(IVICacheLifetime& lifetime)
+    {
+        std::lock_guard<std::mutex> lock(lifetime.mutex);
+        lifetime.alive = false;
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // IVIItemTypeCache
+    //////////////////////////////////////////////////////////////////////////
+
+    IVIItemTypeCache::IVIItemTypeCache()
+        : m_index(make_shared<const Index>())
+    {
+    }
+
+    IVIItemTypeCache::~IVIItemTypeCache() {}
+
+    IVIResult IVIItemTypeCache::Seed(IVIItemTypeClient& client)
+    {
+        IVI_LOG_FUNC();
+
+        const IVIResultItemTypeList result(client.GetItemTypes());
+        if (result.Success())
+        {
+            Seed(result.Payload());
+        }
+        return { result.Status() };
+    }
+
+    void IVIItemTypeCache::Seed(const IVIItemTypeList& itemTypes)
+    {
+        IVI_LOG_VERBOSE("IVIItemTypeCache seeding ", itemTypes.size(), " item types");
+
+        shared_ptr<Index> index(make_shared<Index>());
+        index->reserve(itemTypes.size());
+        for (const IVIItemType& itemType : itemTypes)
+        {
+            (*index)[itemType.gameItemTypeId] = make_shared<Entry>(Entry{ make_shared<const IVIItemType>(itemType) });
+        }
+
+        std::lock_guard<std::mutex> lock(m_writeMutex);
+        StoreIndex(move(index));
+    }
+
+    void IVIItemTypeCache::Put(const IVIItemType& itemType)
+    {
+        ItemTypePtr itemTypePtr(make_shared<const IVIItemType>(itemType));
+
+        std::lock_guard<std::mutex> lock(m_writeMutex);
+        const IndexPtr index(LoadIndex());
+        auto entry(index->find(itemType.gameItemTypeId));
+        if (entry != index->end())
+        {
+            StoreItemType(*entry->second, move(itemTypePtr));
+            return;
+        }
+
+        // New ids are rare next to lookups, so readers never lock and adding one copies the index
+        shared_ptr<Index> newIndex(make_shared<Index>(*index));
+        (*newIndex)[itemType.gameItemTypeId] = make_shared<Entry>(Entry{ move(itemTypePtr) });
+        StoreIndex(move(newIndex));
+    }
+
+    bool IVIItemTypeCache::ApplyUpdate(const IVIItemTypeStatusUpdate& update)
+    {
+        std::lock_guard<std::mutex> lock(m_writeMutex);
+        const IndexPtr index(LoadIndex());
+        auto entry(index->find(update.gameItemTypeId));
+        if (entry == index->end())
+        {
+            IVI_LOG_VERBOSE("IVIItemTypeCache update for uncached gameItemTypeId=", update.gameItemTypeId);
+            return false;
+        }
+
+        shared_ptr<IVIItemType> itemType(make_shared<IVIItemType>(*LoadItemType(*entry->second)));
+        itemType->baseUri = update.baseUri;
+        itemType->trackingId = update.trackingId;
+        itemType->currentSupply = update.currentSupply;
+        itemType->issuedSupply = update.issuedSupply;
+        itemType->issueTimeSpan = update.issueTimeSpan;
+        itemType->itemTypeState = update.itemTypeState;
+        StoreItemType(*entry->second, move(itemType));
+        return true;
+    }
+
+    OnItemTypeUpdated IVIItemTypeCache::Hook(const OnItemTypeUpdated& next)
+    {
+        return [this, next](const IVIItemTypeStatusUpdate& update)
+        {
+            ApplyUpdate(update);
+            if (next)
+            {
+                next(update);
+            }
+        };
+    }
+
+    IVIItemTypeCache::ItemTypePtr IVIItemTypeCache::Find(const string& gameItemTypeId) const
+    {
+        const IndexPtr index(LoadIndex());
+        auto entry(index->find(gameItemTypeId));
+        if (entry == index->end())
+        {
+            return nullptr;
+        }
+        return LoadItemType(*entry->second);
+    }
+
+    void IVIItemTypeCache::ForEach(const function<void(const IVIItemType&)>& visitor) const
+    {
+        const IndexPtr index(LoadIndex());
+        for (const auto& entry : *index)
+        {
+            visitor(*LoadItemType(*entry.second));
+        }
+    }
+
+    size_t IVIItemTypeCache::Size() const
+    {
+        return LoadIndex()->size();
+    }
+
+    IVIItemTypeCache::IndexPtr IVIItemTypeCache::LoadIndex() const
+    {
+        std::lock_guard<std::mutex> lock(m_swapMutex);
+        return m_index;
+    }
+
+    IVIItemTypeCache::ItemTypePtr IVIItemTypeCache::LoadItemType(const Entry& entry) const
+    {
+        std::lock_guard<std::mutex> lock(m_swapMutex);
+        return entry.itemType;
+    }
+
+    // Swapped rather than assigned, the replaced pointer goes back out through the argument
+    // so it is released, possibly freeing the whole snapshot, outside the lock
+    void IVIItemTypeCache::StoreIndex(IndexPtr&& index)
+    {
+        std::lock_guard<std::mutex> lock(m_swapMutex);
+        m_index.swap(index);
+    }
+
+    void IVIItemTypeCache::StoreItemType(Entry& entry, ItemTypePtr&& itemType)
+    {
+        std::lock_guard<std::mutex> lock(m_swapMutex);
+        entry.itemType.swap(itemType);
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // IVIPlayerCache
+    //////////////////////////////////////////////////////////////////////////
+
+    IVIPlayerCache::IVIPlayerCache(size_t capacity)
+        : m_capacity(capacity)
+        , m_hits(0)
+        , m_misses(0)
+        , m_evictions(0)
+        , m_lifetime(make_shared<IVICacheLifetime>())
+    {
+        IVI_CHECK(m_capacity > 0);
+        m_index.reserve(m_capacity);
+    }
+
+    IVIPlayerCache::~IVIPlayerCache()
+    {
+        EndLifetime(*m_lifetime);
+    }
+
+    void IVIPlayerCache::Put(const IVIPlayer& player)
+    {
+        PlayerPtr playerPtr(make_shared<const IVIPlayer>(player));
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        PutLocked(move(playerPtr));
+    }
+
+    void IVIPlayerCache::Put(const IVIPlayerList& players)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const IVIPlayer& player : players)
+        {
+            PutLocked(make_shared<const IVIPlayer>(player));
+        }
+    }
+
+    void IVIPlayerCache::PutLocked(PlayerPtr&& player)
+    {
+        auto entry(m_index.find(player->playerId));
+        if (entry != m_index.end())
+        {
+            entry->second->player = move(player);
+            m_lru.splice(m_lru.begin(), m_lru, entry->second);
+            return;
+        }
+
+        if (m_lru.size() >= m_capacity)
+        {
+            m_index.erase(m_lru.back().playerId);
+            m_lru.pop_back();
+            ++m_evictions;
+        }
+
+        const string playerId(player->playerId);
+        m_lru.push_front({ playerId, move(player) });
+        m_index[playerId] = m_lru.begin();
+    }
+
+    void IVIPlayerCache::Erase(const string& playerId)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto entry(m_index.find(playerId));
+        if (entry != m_index.end())
+        {
+            m_lru.erase(entry->second);
+            m_index.erase(entry);
+        }
+    }
+
+    bool IVIPlayerCache::ApplyUpdate(const IVIPlayerStatusUpdate& update)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_inFlight.Invalidate(update.playerId);
+        auto entry(m_index.find(update.playerId));
+        if (entry == m_index.end())
+        {
+            return false;
+        }
+
+        // A state change, eg linking, also changes fields the update does not carry, so the player is refetched
+        if (entry->second->player->playerState != update.playerState)
+        {
+            m_lru.erase(entry->second);
+            m_index.erase(entry);
+            return true;
+        }
+
+        // Copy-on-write, callers may still hold the previous PlayerPtr
+        shared_ptr<IVIPlayer> player(make_shared<IVIPlayer>(*entry->second->player));
+        player->trackingId = update.trackingId;
+        entry->second->player = move(player);
+        return true;
+    }
+
+    OnPlayerUpdated IVIPlayerCache::Hook(const OnPlayerUpdated& next)
+    {
+        return [this, next](const IVIPlayerStatusUpdate& update)
+        {
+            ApplyUpdate(update);
+            if (next)
+            {
+                next(update);
+            }
+        };
+    }
+
+    IVIPlayerCache::PlayerPtr IVIPlayerCache::Find(const string& playerId)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto entry(m_index.find(playerId));
+        if (entry == m_index.end())
+        {
+            ++m_misses;
+            return nullptr;
+        }
+
+        ++m_hits;
+        m_lru.splice(m_lru.begin(), m_lru, entry->second);
+        return entry->second->player;
+    }
+
+    void IVIPlayerCache::ForEach(const function<void(const IVIPlayer&)>& visitor) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const Entry& entry : m_lru)
+        {
+            visitor(*entry.player);
+        }
+    }
+
+    void IVIPlayerCache::GetPlayer(
+        IVIPlayerClientAsync& client,
+        const string& playerId,
+        const function<void(const IVIResultPlayer&)>& callback)
+    {
+        PlayerPtr player(Find(playerId));
+        if (player)
+        {
+            callback({ IVIResultStatus::SUCCESS, *player });
+            return;
+        }
+
+        uint64_t generation;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            generation = m_inFlight.Begin(playerId);
+        }
+
+        const shared_ptr<IVICacheLifetime> lifetime(m_lifetime);
+        client.GetPlayer(
+            playerId,
+            [this, lifetime, playerId, generation, callback](const IVIResultPlayer& result)
+            {
+                {
+                    std::lock_guard<std::mutex> lifetimeLock(lifetime->mutex);
+                    if (lifetime->alive)
+                    {
+                        // An update seen while the call was in flight may be newer than the result
+                        PlayerPtr player(result.Success() ? make_shared<const IVIPlayer>(result.Payload()) : nullptr);
+                        std::lock_guard<std::mutex> lock(m_mutex);
+                        if (m_inFlight.End(playerId, generation) && player)
+                        {
+                            PutLocked(move(player));
+                        }
+                    }
+                }
+                callback(result);
+            });
+    }
+
+    IVICacheStats IVIPlayerCache::Stats() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return { m_hits, m_misses, m_evictions, m_lru.size(), m_capacity, 0 };
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // IVIItemCache
+    //////////////////////////////////////////////////////////////////////////
+
+    IVIItemCache::IVIItemCache(size_t maxBytes, uint32_t ttlMs, IVICacheEviction eviction)
+        : m_maxBytes(maxBytes)
+        , m_ttl(ttlMs)
+        , m_eviction(eviction)
+        , m_bytes(0)
+        , m_hits(0)
+        , m_misses(0)
+        , m_evictions(0)
+        , m_lifetime(make_shared<IVICacheLifetime>())
+    {
+        IVI_CHECK(m_maxBytes > 0);
+    }
+
+    IVIItemCache::~IVIItemCache()
+    {
+        EndLifetime(*m_lifetime);
+    }
+
+    /*static*/ size_t IVIItemCache::EstimateBytes(const IVIItem& item)
+    {
+        // Index node and key copy on top of the item itself, string lengths rather than
+        // capacities so every copy of an item has the same estimate
+        return sizeof(IVIItem) + sizeof(Entry) + 2 * sizeof(void*) + sizeof(pair<const string, EntryList::iterator>) + 2 * sizeof(void*)
+            + 2 * item.gameInventoryId.size()
+            + item.gameItemTypeId.size()
+            + item.itemName.size()
+            + item.playerId.size()
+            + item.ownerSidechainAccount.size()
+            + item.currencyBase.size()
+            + item.metadataUri.size()
+            + item.trackingId.size()
+            + item.metadata.name.size()
+            + item.metadata.description.size()
+            + item.metadata.image.size()
+            + MetadataPropertiesByteSize(item.metadata.properties);
+    }
+
+    void IVIItemCache::Put(const IVIItem& item)
+    {
+        ItemPtr itemPtr(make_shared<const IVIItem>(item));
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        PutLocked(move(itemPtr), Clock::now());
+    }
+
+    void IVIItemCache::Put(const IVIItemList& items)
+    {
+        const Clock::time_point now(Clock::now());
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const IVIItem& item : items)
+        {
+            PutLocked(make_shared<const IVIItem>(item), now);
+        }
+    }
+
+    void IVIItemCache::PutLocked(ItemPtr&& item, Clock::time_point now)
+    {
+        const size_t bytes(EstimateBytes(*item));
+        auto existing(m_index.find(item->gameInventoryId));
+        if (existing != m_index.end())
+        {
+            EraseLocked(existing);
+        }
+
+        if (bytes > m_maxBytes)
+        {
+            IVI_LOG_VERBOSE("IVIItemCache not caching gameInventoryId=", item->gameInventoryId, " of ", bytes, " bytes");
+            return;
+        }
+
+        while (m_bytes + bytes > m_maxBytes)
+        {
+            Entry& victim(m_entries.back());
+            if (m_eviction == IVICacheEviction::CLOCK && victim.referenced && !IsExpired(victim, now))
+            {
+                victim.referenced = false;
+                m_entries.splice(m_entries.begin(), m_entries, std::prev(m_entries.end()));
+                continue;
+            }
+            EraseLocked(m_index.find(victim.item->gameInventoryId));
+            ++m_evictions;
+        }
+
+        const string gameInventoryId(item->gameInventoryId);
+        m_entries.push_front({ move(item), bytes, now + m_ttl, false });
+        m_index[gameInventoryId] = m_entries.begin();
+        m_bytes += bytes;
+    }
+
+    void IVIItemCache::EraseLocked(unordered_map<string, EntryList::iterator>::iterator entry)
+    {
+        m_bytes -= entry->second->bytes;
+        m_entries.erase(entry->second);
+        m_index.erase(entry);
+    }
+
+    bool IVIItemCache::IsExpired(const Entry& entry, Clock::time_point now) const
+    {
+        return m_ttl.count() > 0 && entry.expires <= now;
+    }
+
+    void IVIItemCache::Erase(const string& gameInventoryId)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto entry(m_index.find(gameInventoryId));
+        if (entry != m_index.end())
+        {
+            EraseLocked(entry);
+        }
+    }
+
+    bool IVIItemCache::ApplyUpdate(const IVIItemStatusUpdate& update)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_inFlight.Invalidate(update.gameInventoryId);
+        auto entry(m_index.find(update.gameInventoryId));
+        if (entry == m_index.end())
+        {
+            return false;
+        }
+
+        // Updates carry neither the metadata nor the other item fields, so the item is refetched instead of patched
+        EraseLocked(entry);
+        return true;
+    }
+
+    OnItemUpdated IVIItemCache::Hook(const OnItemUpdated& next)
+    {
+        return [this, next](const IVIItemStatusUpdate& update)
+        {
+            ApplyUpdate(update);
+            if (next)
+            {
+                next(update);
+            }
+        };
+    }
+
+    IVIItemCache::ItemPtr IVIItemCache::Find(const string& gameInventoryId)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto entry(m_index.find(gameInventoryId));
+        if (entry == m_index.end())
+        {
+            ++m_misses;
+            return nullptr;
+        }
+
+        if (IsExpired(*entry->second, Clock::now()))
+        {
+            EraseLocked(entry);
+            ++m_misses;
+            return nullptr;
+        }
+
+        ++m_hits;
+        if (m_eviction == IVICacheEviction::LRU)
+        {
+            m_entries.splice(m_entries.begin(), m_entries, entry->second);
+        }
+        else
+        {
+            entry->second->referenced = true;
+        }
+        return entry->second->item;
+    }
+
+    void IVIItemCache::ForEach(const function<void(const IVIItem&)>& visitor) const
+    {
+        const Clock::time_point now(Clock::now());
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const Entry& entry : m_entries)
+        {
+            if (!IsExpired(entry, now))
+            {
+                visitor(*entry.item);
+            }
+        }
+    }
+
+    void IVIItemCache::GetItem(
+        IVIItemClientAsync& client,
+        const string& gameInventoryId,
+        const function<void(const IVIResultItem&)>& callback)
+    {
+        ItemPtr item(Find(gameInventoryId));
+        if (item)
+        {
+            callback({ IVIResultStatus::SUCCESS, *item });
+            return;
+        }
+
+        uint64_t generation;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            generation = m_inFlight.Begin(gameInventoryId);
+        }
+
+        const shared_ptr<IVICacheLifetime> lifetime(m_lifetime);
+        client.GetItem(
+            gameInventoryId,
+            [this, lifetime, gameInventoryId, generation, callback](const IVIResultItem& result)
+            {
+                {
+                    std::lock_guard<std::mutex> lifetimeLock(lifetime->mutex);
+                    if (lifetime->alive)
+                    {
+                        // An update seen while the call was in flight may be newer than the result
+                        ItemPtr item(result.Success() ? make_shared<const IVIItem>(result.Payload()) : nullptr);
+                        std::lock_guard<std::mutex> lock(m_mutex);
+                        if (m_inFlight.End(gameInventoryId, generation) && item)
+                        {
+                            PutLocked(move(item), Clock::now());
+                        }
+                    }
+                }
+                callback(result);
+            });
+    }
+
+    IVICacheStats IVIItemCache::Stats() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return { m_hits, m_misses, m_evictions, m_entries.size(), m_maxBytes, m_bytes };
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // IVINotFoundCache
+    //////////////////////////////////////////////////////////////////////////
+
+    IVINotFoundCache::IVINotFoundCache(size_t capacity, uint32_t ttlMs)
+        : m_capacity(capacity)
+        , m_ttl(ttlMs)
+        , m_hits(0)
+        , m_misses(0)
+        , m_evictions(0)
+        , m_lifetime(make_shared<IVICacheLifetime>())
+    {
+        IVI_CHECK(m_capacity > 0);
+        m_index.reserve(m_capacity);
+    }
+
+    IVINotFoundCache::~IVINotFoundCache()
+    {
+        EndLifetime(*m_lifetime);
+    }
+
+    /*static*/ string IVINotFoundCache::Key(Kind kind, const string& id)
+    {
+        string key;
+        key.reserve(id.size() + 1);
+        key.push_back(static_cast<char>(kind));
+        key.append(id);
+        return key;
+    }
+
+    void IVINotFoundCache::ExpireLocked(Clock::time_point now)
+    {
+        while (!m_entries.empty() && m_entries.front().expires <= now)
+        {
+            m_index.erase(m_entries.front().key);
+            m_entries.pop_front();
+        }
+    }
+
+    bool IVINotFoundCache::Lookup(const string& key, uint64_t& outGeneration)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ExpireLocked(Clock::now());
+        if (m_index.find(key) != m_index.end())
+        {
+            ++m_hits;
+            return true;
+        }
+
+        ++m_misses;
+        outGeneration = m_inFlight.Begin(key);
+        return false;
+    }
+
+    void IVINotFoundCache::Complete(const string& key, uint64_t generation, bool notFound)
+    {
+        const Clock::time_point now(Clock::now());
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        // An update seen while the call was in flight may have created the entity
+        if (!m_inFlight.End(key, generation) || !notFound || m_index.find(key) != m_index.end())
+        {
+            return;
+        }
+
+        ExpireLocked(now);
+        if (m_entries.size() >= m_capacity)
+        {
+            m_index.erase(m_entries.front().key);
+            m_entries.pop_front();
+            ++m_evictions;
+        }
+
+        m_entries.push_back({ key, now + m_ttl });
+        m_index[key] = std::prev(m_entries.end());
+    }
+
+    void IVINotFoundCache::Forget(const string& key)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_inFlight.Invalidate(key);
+        auto entry(m_index.find(key));
+        if (entry != m_index.end())
+        {
+            m_entries.erase(entry->second);
+            m_index.erase(entry);
+        }
+    }
+
+    template<typename TResult>
+    function<void(const TResult&)> IVINotFoundCache::Completion(
+        const string& key,
+        uint64_t generation,
+        const function<void(const TResult&)>& callback)
+    {
+        const shared_ptr<IVICacheLifetime> lifetime(m_lifetime);
+        return [this, lifetime, key, generation, callback](const TResult& result)
+        {
+            {
+                std::lock_guard<std::mutex> lifetimeLock(lifetime->mutex);
+                if (lifetime->alive)
+                {
+                    Complete(key, generation, result.Status() == IVIResultStatus::NOT_FOUND);
+                }
+            }
+            callback(result);
+        };
+    }
+
+    void IVINotFoundCache::GetItem(
+        IVIItemClientAsync& client,
+        const string& gameInventoryId,
+        const function<void(const IVIResultItem&)>& callback)
+    {
+        const string key(Key(Kind::ITEM, gameInventoryId));
+        uint64_t generation = 0;
+        if (Lookup(key, generation))
+        {
+            callback({ IVIResultStatus::NOT_FOUND });
+            return;
+        }
+
+        client.GetItem(gameInventoryId, Completion(key, generation, callback));
+    }
+
+    void IVINotFoundCache::GetPlayer(
+        IVIPlayerClientAsync& client,
+        const string& playerId,
+        const function<void(const IVIResultPlayer&)>& callback)
+    {
+        const string key(Key(Kind::PLAYER, playerId));
+        uint64_t generation = 0;
+        if (Lookup(key, generation))
+        {
+            callback({ IVIResultStatus::NOT_FOUND });
+            return;
+        }
+
+        client.GetPlayer(playerId, Completion(key, generation, callback));
+    }
+
+    void IVINotFoundCache::GetOrder(
+        IVIOrderClientAsync& client,
+        const string& orderId,
+        const function<void(const IVIResultOrder&)>& callback)
+    {
+        const string key(Key(Kind::ORDER, orderId));
+        uint64_t generation = 0;
+        if (Lookup(key, generation))
+        {
+            callback({ IVIResultStatus::NOT_FOUND });
+            return;
+        }
+
+        client.GetOrder(orderId, Completion(key, generation, callback));
+    }
+
+    OnItemUpdated IVINotFoundCache::HookItemUpdates(const OnItemUpdated& next)
+    {
+        return [this, next](const IVIItemStatusUpdate& update)
+        {
+            Forget(Key(Kind::ITEM, update.gameInventoryId));
+            if (next)
+            {
+                next(update);
+            }
+        };
+    }
+
+    OnPlayerUpdated IVINotFoundCache::HookPlayerUpdates(const OnPlayerUpdated& next)
+    {
+        return [this, next](const IVIPlayerStatusUpdate& update)
+        {
+            Forget(Key(Kind::PLAYER, update.playerId));
+            if (next)
+            {
+                next(update);
+            }
+        };
+    }
+
+    OnOrderUpdated IVINotFoundCache::HookOrderUpdates(const OnOrderUpdated& next)
+    {
+        return [this, next](const IVIOrderStatusUpdate& update)
+        {
+            Forget(Key(Kind::ORDER, update.orderId));
+            if (next)
+            {
+                next(update);
+            }
+        };
+    }
+
+    IVICacheStats IVINotFoundCache::Stats() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return { m_hits, m_misses, m_evictions, m_entries.size(), m_capacity, 0 };
+    }
+} // namespace ivi
@@ -1,7 +1,9 @@
 #include "ivi/ivi-client.h"
 #include "ivi/ivi-model.h"
+#include "ivi/ivi-table.h"
 #include "ivi/ivi-util.h"
 
+#include "grpcpp/alarm.h"
 #include "grpcpp/grpcpp.h"
 #include "grpc/support/log.h"
 
@@ -19,6 +21,10 @@
 #include "ivi/generated/streams/order/stream.grpc.pb.h"
 #include "ivi/generated/streams/player/stream.grpc.pb.h"
 
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
 #include <type_traits>
 
 namespace ivi
@@ -145,6 +151,222 @@ namespace ivi
         return *m_configuration;
     }
 
+    //////////////////////////////////////////////////////////////////////////
+    // IVIAdmissionControl, bounds the async unary calls outstanding per
+    // service.  Shared by the owning client and its in-flight completion
+    // callbacks, so may be called from the Writer and unary Reader threads.
+    //////////////////////////////////////////////////////////////////////////
+
+    class IVIAdmissionControl
+        : private NonCopyable<IVIAdmissionControl>
+    {
+    public:
+        using Starter               = function<void()>;
+        using Failer                = function<void(IVIResultStatus)>;
+
+        explicit IVIAdmissionControl(const IVIAdmissionPolicy& policy)
+            : m_policy(policy)
+            , m_inFlight(0)
+            , m_shutdown(false)
+        {
+        }
+
+        // Starts the call now if there is room, otherwise queues it or fails it per the overflow policy
+        void Admit(Starter&& start, Failer&& fail)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+
+            if (m_queue.size() >= m_policy.maxQueued && !CanStart())
+            {
+                switch (m_policy.overflowPolicy)
+                {
+                case IVIOverflowPolicy::BLOCK:
+                    if (!m_queueSpace.wait_for(lock, std::chrono::milliseconds(m_policy.blockTimeoutMs),
+                            [this]() { return m_shutdown || m_queue.size() < m_policy.maxQueued || CanStart(); }))
+                    {
+                        lock.unlock();
+                        fail(IVIResultStatus::RESOURCE_EXHAUSTED);
+                        return;
+                    }
+                    break;
+                case IVIOverflowPolicy::DROP_OLDEST:
+                    if (!m_queue.empty())
+                    {
+                        Pending dropped(move(m_queue.front()));
+                        m_queue.pop_front();
+                        m_queue.push_back({ move(start), move(fail) });
+                        lock.unlock();
+                        dropped.fail(IVIResultStatus::ABORTED);
+                        return;
+                    }
+                    // nothing queued to drop
+                    lock.unlock();
+                    fail(IVIResultStatus::RESOURCE_EXHAUSTED);
+                    return;
+                case IVIOverflowPolicy::REJECT:
+                default:
+                    lock.unlock();
+                    fail(IVIResultStatus::RESOURCE_EXHAUSTED);
+                    return;
+                }
+            }
+
+            if (m_shutdown)
+            {
+                lock.unlock();
+                fail(IVIResultStatus::UNAVAILABLE);
+            }
+            else if (CanStart())
+            {
+                ++m_inFlight;
+                lock.unlock();
+                start();
+            }
+            else
+            {
+                m_queue.push_back({ move(start), move(fail) });
+            }
+        }
+
+        // A call completed.  Queued calls are only started after ok completions, since !ok means the
+        // unary queue may be shutting down and must not receive new work.
+        void Release(bool startNext)
+        {
+            Starter next;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                --m_inFlight;
+                if (startNext && !m_shutdown && !m_queue.empty())
+                {
+                    next = move(m_queue.front().start);
+                    m_queue.pop_front();
+                    ++m_inFlight;
+                }
+            }
+            m_queueSpace.notify_all();
+
+            if (next)
+            {
+                next();
+            }
+        }
+
+        // Fails everything still queued, the owning client is going away
+        void Shutdown()
+        {
+            std::deque<Pending> queue;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_shutdown = true;
+                queue.swap(m_queue);
+            }
+            m_queueSpace.notify_all();
+
+            for (Pending& pending : queue)
+            {
+                pending.fail(IVIResultStatus::UNAVAILABLE);
+            }
+        }
+
+        uint32_t InFlight() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_inFlight;
+        }
+
+        uint32_t Queued() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return static_cast<uint32_t>(m_queue.size());
+        }
+
+    private:
+
+        struct Pending
+        {
+            Starter                 start;
+            Failer                  fail;
+        };
+
+        bool CanStart() const
+        {
+            return m_queue.empty() && m_inFlight < m_policy.maxInFlight;
+        }
+
+        const IVIAdmissionPolicy    m_policy;
+        mutable std::mutex          m_mutex;
+        std::condition_variable     m_queueSpace;
+        std::deque<Pending>         m_queue;
+        uint32_t                    m_inFlight;
+        bool                        m_shutdown;
+    };
+
+    static shared_ptr<IVIAdmissionControl> MakeAdmissionControl(const IVIConfiguration& config, const char* serviceName)
+    {
+        auto policy(config.admissionPolicies.find(serviceName));
+        if (policy == config.admissionPolicies.end() || policy->second.maxInFlight == 0)
+        {
+            return nullptr;
+        }
+
+        IVI_LOG_VERBOSE(serviceName, " admission control maxInFlight=", policy->second.maxInFlight, " maxQueued=", policy->second.maxQueued);
+        return make_shared<IVIAdmissionControl>(policy->second);
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // IVISingleFlight, the first caller for a key issues the RPC and every
+    // caller joining while it is outstanding receives the same result.
+    //////////////////////////////////////////////////////////////////////////
+
+    template<typename TKey, typename TResult>
+    class IVISingleFlight
+        : private NonCopyable<IVISingleFlight<TKey, TResult>>
+    {
+    public:
+        using Key                   = TKey;
+        using Callback              = function<void(const TResult&)>;
+
+        // Returns true if the caller leads the flight and must issue the RPC, then call Complete
+        bool Join(const TKey& key, const Callback& callback)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto& waiters(m_flights[key]);
+            waiters.push_back(callback);
+            return waiters.size() == 1;
+        }
+
+        void Complete(const TKey& key, const TResult& result)
+        {
+            CallbackList waiters;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                auto flight(m_flights.find(key));
+                if (flight == m_flights.end())
+                {
+                    return;
+                }
+                waiters.swap(flight->second);
+                m_flights.erase(flight);
+            }
+
+            // Outside the lock, callbacks may start new flights for the same key
+            if (waiters.size() > 1)
+            {
+                IVI_LOG_VERBOSE("Single-flight result shared by ", waiters.size(), " callers");
+            }
+            for (const Callback& callback : waiters)
+            {
+                callback(result);
+            }
+        }
+
+    private:
+        using CallbackList          = vector<Callback>;
+
+        std::mutex                  m_mutex;
+        map<TKey, CallbackList>     m_flights;
+    };
+
     //////////////////////////////////////////////////////////////////////////
     // IVIClientT class template 
     // Primary purposes is wrapping boilerplate gRPC semantics for
@@ -156,20 +378,36 @@ namespace ivi
         const IVIConfigurationPtr& configuration, 
         const IVIConnectionPtr& conn)
         : IVIClient(configuration, conn)
-        , m_stubPtr(TService::NewStub(Connection()->channel).release())
+        , m_stubPtr(TService::NewStub(Connection()->channel))
+        , m_admission(MakeAdmissionControl(GetConfig(), TService::service_full_name()))
     {
     }
 
     template<typename TService>
     ivi::IVIClientT<TService>::~IVIClientT()
     {
-        delete Stub<typename ServiceT::Stub>();
+        if (m_admission)
+        {
+            m_admission->Shutdown();
+        }
+    }
+
+    template<typename TService>
+    uint32_t IVIClientT<TService>::InFlightCalls() const
+    {
+        return m_admission ? m_admission->InFlight() : 0;
+    }
+
+    template<typename TService>
+    uint32_t IVIClientT<TService>::QueuedCalls() const
+    {
+        return m_admission ? m_admission->Queued() : 0;
     }
 
     // gRPC commits the sin of using public nested classes for their generated interfaces, 
     // which precludes forward declarations of those stubs in IVI's public headers.
     // To avoid the massive pollution of including gRPC headers in our public headers,
-    // we're just going to manually manage a void*, instead of incurring
+    // we're just going to manually manage a shared_ptr<void>, instead of incurring
     // the expense and maintenance issues of a virtual interface & private 
     // implementation, or pImpl implementation.
     // Issue filed here: https://github.com/grpc/grpc/issues/25995
@@ -177,7 +415,13 @@ namespace ivi
     template<typename TStub>
     TStub* IVIClientT<TService>::Stub()
     {
-        return static_cast<TStub*>(m_stubPtr);
+        return static_cast<TStub*>(m_stubPtr.get());
+    }
+
+    template<typename TService>
+    typename IVIClientT<TService>::UnaryTarget IVIClientT<TService>::GetUnaryTarget()
+    {
+        return { GetConfigPtr(), m_stubPtr, Connection()->unaryQueue, m_admission };
     }
 
     /*static*/
@@ -197,21 +441,30 @@ namespace ivi
 #endif // IVI_LOGGING_LEVEL >= 2
     }
 
+    // The response is discarded once parsed, so parsers taking it as an rvalue may move its strings out
     template<typename TResult, typename TResponseParser, typename TResponse,
     class = typename enable_if<!is_same<TResult,IVIResult>::value, TResult>::type>
-    static TResult MakeSuccessResult(TResponseParser&& parser, const TResponse& response)
+    static TResult MakeSuccessResult(TResponseParser&& parser, TResponse&& response)
     {
         return { IVIResultStatus::SUCCESS,
-                 parser(response) };
+                 parser(forward<TResponse>(response)) };
     }
 
     template<typename TResult, typename TResponseParser, typename TResponse,
     class = typename enable_if<is_same<TResult, IVIResult>::value, TResult>::type>
-    static IVIResult MakeSuccessResult(TResponseParser&& /*parser*/, const TResponse& /*response*/)
+    static IVIResult MakeSuccessResult(TResponseParser&& /*parser*/, TResponse&& /*response*/)
     {
         return { IVIResultStatus::SUCCESS };
     }
 
+    // Parser of a response that is a single model, through the rvalue FromProto
+    template<typename TModel>
+    struct FromProtoParser
+    {
+        template<typename TProto>
+        TModel operator()(TProto&& proto) const { return TModel::FromProto(forward<TProto>(proto)); }
+    };
+
     template<typename TService>
     template<
         typename TResult,
@@ -235,7 +488,7 @@ namespace ivi
         if (status.ok())
         {
             IVI_LOG_NTRACE(ServiceT::service_full_name(), " Response: ", response.DebugString());
-            return MakeSuccessResult<TResult>(parser, response);
+            return MakeSuccessResult<TResult>(parser, move(response));
         }
         else
         {
@@ -258,11 +511,37 @@ namespace ivi
         TRequestCall&& call,
         TResponseParser&& parser,
         TResponseCallback&& callback)
+    {
+        CallUnaryAsync<TResult, TResponse>(
+            GetUnaryTarget(),
+            forward<TRequest>(request),
+            forward<TRequestCall>(call),
+            forward<TResponseParser>(parser),
+            forward<TResponseCallback>(callback));
+    }
+
+    /*static*/
+    template<typename TService>
+    template<
+        typename TResult,
+        typename TResponse,
+        typename TRequest,
+        typename TRequestCall,
+        typename TResponseParser,
+        typename TResponseCallback
+    >
+    void IVIClientT<TService>::CallUnaryAsync(
+        const UnaryTarget& target,
+        TRequest&& request,
+        TRequestCall&& call,
+        TResponseParser&& parser,
+        TResponseCallback&& callback)
     {
         IVI_LOG_NTRACE(ServiceT::service_full_name(), " Request: ", request.DebugString());
 		IVI_CHECK(callback);
-        request.set_environment_id(GetConfig().environmentId);
+        request.set_environment_id(target.configuration->environmentId);
 
+        using RequestT              = typename std::decay<TRequest>::type;
         struct AsyncState
         {
             grpc::ClientContext         context;
@@ -273,29 +552,60 @@ namespace ivi
         };
 
         shared_ptr<AsyncState> asyncState(make_shared<AsyncState>());
-        
-        asyncState->reader = (Stub<typename ServiceT::Stub>()->*call)(
-            &asyncState->context,
-            request,
-            Connection()->unaryQueue.get());
-
-        asyncState->reader->Finish(
-            &asyncState->response,
-            &asyncState->status,
-            new AsyncCallback([asyncState, parser, callback](bool ok)
-                {
-                    if (CheckOkUnaryAsync(ok, asyncState->context, asyncState->status))
-                    {
-                        IVI_LOG_NTRACE(ServiceT::service_full_name(), " Response: ", asyncState->response.DebugString());
-                        callback(MakeSuccessResult<TResult>(parser, asyncState->response));
-                    }
-                    else
+        shared_ptr<IVIAdmissionControl> admission(target.admission);
+
+        // Queued calls are started from another call's completion, possibly after the client is destroyed
+        // or reinitialized, so the stub and queue the call was made on are held rather than the client
+        shared_ptr<void> stub(target.stub);
+        CompletionQueuePtr queue(target.queue);
+
+        auto start = [asyncState, stub, queue, call, parser, callback, admission](const RequestT& startRequest)
+        {
+            asyncState->reader = (static_cast<typename ServiceT::Stub*>(stub.get())->*call)(
+                &asyncState->context,
+                startRequest,
+                queue.get());
+
+            asyncState->reader->Finish(
+                &asyncState->response,
+                &asyncState->status,
+                new AsyncCallback([asyncState, parser, callback, admission](bool ok)
                     {
-                        callback({ TranslateGrpcError(asyncState->context, asyncState->status) });
+                        if (admission)
+                        {
+                            admission->Release(ok);
+                        }
+
+                        if (CheckOkUnaryAsync(ok, asyncState->context, asyncState->status))
+                        {
+                            IVI_LOG_NTRACE(ServiceT::service_full_name(), " Response: ", asyncState->response.DebugString());
+                            callback(MakeSuccessResult<TResult>(parser, move(asyncState->response)));
+                        }
+                        else
+                        {
+                            callback({ TranslateGrpcError(asyncState->context, asyncState->status) });
+                        }
                     }
-                }
-            )
-        );
+                )
+            );
+        };
+
+        if (admission)
+        {
+            // The request is only copied to the heap when the call may have to wait for admission
+            shared_ptr<RequestT> parked(make_shared<RequestT>(forward<TRequest>(request)));
+            admission->Admit(
+                [start, parked]() { start(*parked); },
+                [callback](IVIResultStatus status)
+                {
+                    IVI_LOG_WARNING(ServiceT::service_full_name(), " async request not admitted: ", static_cast<int32_t>(status));
+                    callback({ status });
+                });
+        }
+        else
+        {
+            start(request);
+        }
     }
 
     template<typename TService>
@@ -572,11 +882,13 @@ namespace ivi
 
         IVI_LOG_NTRACE(ServiceT::service_full_name(), " Received: ", CurrentMessage().DebugString());
 
-        OnCallback(ParsedMessageT::FromProto(CurrentMessage()));
+        // The message is read into again for the next update, its strings are moved out rather than copied
+        const ParsedMessageT update(ParsedMessageT::FromProto(move(m_state->updateResponse)));
+        OnCallback(update);
 
         if (Base::GetConfig().autoconfirmStreamUpdates)
         {
-            sendConfirm();
+            sendConfirm(update);
         }
 
         ReadNext();
@@ -589,7 +901,16 @@ namespace ivi
     template IVIClientT<IVIItemClient::ServiceT>::IVIClientT(
         const IVIConfigurationPtr& configuration,
         const IVIConnectionPtr& conn);
+    template uint32_t IVIClientT<IVIItemClient::ServiceT>::InFlightCalls() const;
+    template uint32_t IVIClientT<IVIItemClient::ServiceT>::QueuedCalls() const;
     IVIItemClient::~IVIItemClient() {}
+    IVIItemClientAsync::IVIItemClientAsync(
+        const IVIConfigurationPtr& configuration,
+        const IVIConnectionPtr& conn)
+        : IVIClientT<ServiceT>(configuration, conn)
+        , m_getItemFlights(make_shared<GetItemFlights>())
+    {
+    }
     IVIItemClientAsync::~IVIItemClientAsync() {}
 
     static proto::api::item::IssueItemRequest MakeIssueItemRequest(
@@ -611,7 +932,7 @@ namespace ivi
         request.set_game_item_type_id(gameItemTypeId);
         request.set_amount_paid(amountPaid);
         request.set_currency(currency);
-        *request.mutable_metadata() = metadata.ToProto();
+        metadata.ToProto(request.mutable_metadata());
         request.set_store_id(storeId);
         request.set_order_id(orderId);
         request.set_request_ip(requestIp);
@@ -674,6 +995,114 @@ namespace ivi
             callback);
     }
 
+    IVIIssueItemsBatch::IssueCall IVIItemClientAsync::MakeIssueCall()
+    {
+        const UnaryTarget target(GetUnaryTarget());
+        return [target](const IVIIssueItemSpec& spec, const function<void(const IVIResultItemStateChange&)>& callback)
+        {
+            IVI_LOG_VERBOSE("IssueItem (async) gameInventoryId=", spec.gameInventoryId);
+
+            using Response = proto::api::item::IssueItemStartedResponse;
+            CallUnaryAsync<IVIResultItemStateChange, Response>(
+                target,
+                MakeIssueItemRequest(spec.gameInventoryId, spec.playerId, spec.itemName, spec.gameItemTypeId, spec.amountPaid,
+                    spec.currency, spec.metadata, spec.storeId, spec.orderId, spec.requestIp),
+                &ServiceT::Stub::AsyncIssueItem,
+                ItemStateUpdateResponseParserT<Response>{ spec.gameInventoryId },
+                callback);
+        };
+    }
+
+    IVIIssueItemsBatchPtr IVIItemClientAsync::IssueItems(
+        IVIIssueItemSpecList specs,
+        uint32_t windowSize,
+        const IVIIssueItemsBatch::OnItemIssued& onItemIssued,
+        const IVIIssueItemsBatch::OnProgress& onProgress)
+    {
+        IVI_LOG_FUNC();
+        IVI_LOG_VERBOSE("IssueItems (async) count=", specs.size(), " windowSize=", windowSize);
+
+        IVIIssueItemsBatchPtr batch(make_shared<IVIIssueItemsBatch>(*this, move(specs), windowSize, onItemIssued, onProgress));
+        batch->Dispatch();
+        return batch;
+    }
+
+    IVIIssueItemsBatch::IVIIssueItemsBatch(
+        IVIItemClientAsync& client,
+        IVIIssueItemSpecList&& specs,
+        uint32_t windowSize,
+        const OnItemIssued& onItemIssued,
+        const OnProgress& onProgress)
+        : m_issue(client.MakeIssueCall())
+        , m_specs(move(specs))
+        , m_onItemIssued(onItemIssued)
+        , m_onProgress(onProgress)
+        , m_progress{ m_specs.size(), 0, 0, 0 }
+        , m_windowSize(windowSize > 0 ? windowSize : 1)
+        , m_paused(false)
+        , m_dispatching(false)
+    {
+    }
+
+    void IVIIssueItemsBatch::Pause()
+    {
+        m_paused = true;
+    }
+
+    void IVIIssueItemsBatch::Resume()
+    {
+        m_paused = false;
+        Dispatch();
+    }
+
+    bool IVIIssueItemsBatch::IsPaused() const
+    {
+        return m_paused;
+    }
+
+    const IVIIssueItemsProgress& IVIIssueItemsBatch::Progress() const
+    {
+        return m_progress;
+    }
+
+    void IVIIssueItemsBatch::Dispatch()
+    {
+        // Admission failures call back before m_issue returns, which would otherwise recurse once per spec
+        if (m_dispatching)
+        {
+            return;
+        }
+
+        m_dispatching = true;
+        IVIIssueItemsBatchPtr self(shared_from_this());
+        while (!m_paused && m_progress.sent < m_progress.total && m_progress.InFlight() < m_windowSize)
+        {
+            const size_t index = m_progress.sent++;
+            m_issue(m_specs[index],
+                [self, index](const IVIResultItemStateChange& result)
+                {
+                    self->OnResult(index, result);
+                });
+        }
+        m_dispatching = false;
+    }
+
+    void IVIIssueItemsBatch::OnResult(size_t index, const IVIResultItemStateChange& result)
+    {
+        if (result.Success())
+            ++m_progress.succeeded;
+        else
+            ++m_progress.failed;
+
+        if (m_onItemIssued)
+            m_onItemIssued(m_specs[index], result);
+
+        if (m_onProgress)
+            m_onProgress(m_progress);
+
+        Dispatch();
+    }
+
     static proto::api::item::TransferItemRequest MakeTransferItemRequest(
         const string& gameInventoryId,
         const string& sourcePlayerId,
@@ -779,7 +1208,7 @@ namespace ivi
         return CallUnary<IVIResultItem, Response>(
             MakeGetItemRequest(gameInventoryId, history),
             &ServiceT::Stub::GetItem,
-            &IVIItem::FromProto);
+            FromProtoParser<IVIItem>());
     }
 
     void IVIItemClientAsync::GetItem(
@@ -797,12 +1226,35 @@ namespace ivi
         IVI_LOG_FUNC();
         IVI_LOG_VERBOSE("GetItem (async) gameInventoryId=", gameInventoryId);
 
+        const GetItemFlights::Key key(gameInventoryId, history);
+        if (!m_getItemFlights->Join(key, callback))
+        {
+            return;
+        }
+
+        shared_ptr<GetItemFlights> flights(m_getItemFlights);
+        function<void(const IVIResultItem&)> fanOut = [flights, key](const IVIResultItem& result)
+        {
+            flights->Complete(key, result);
+        };
+
         using Response = proto::api::item::Item;
         CallUnaryAsync<IVIResultItem, Response>(
             MakeGetItemRequest(gameInventoryId, history),
             &ServiceT::Stub::AsyncGetItem,
-            &IVIItem::FromProto, 
-            callback);
+            FromProtoParser<IVIItem>(), 
+            fanOut);
+    }
+
+    // Builds one model object at a time, the repeated field is never copied into a container
+    template<typename TModel, typename TRepeatedField>
+    static size_t VisitEach(TRepeatedField& protos, const function<void(const TModel&)>& visitor)
+    {
+        for (auto& proto : protos)
+        {
+            visitor(TModel::FromProto(move(proto)));
+        }
+        return static_cast<size_t>(protos.size());
     }
 
     static proto::api::item::GetItemsRequest MakeGetItemsRequest(
@@ -819,10 +1271,12 @@ namespace ivi
         return request;
     }
 
-    static IVIResultItemList::PayloadT ParseItems(const proto::api::item::Items& response)
+    static IVIResultItemList::PayloadT ParseItems(proto::api::item::Items&& response)
     {
-        list<IVIItem> outItems;
-        transform(response.items().begin(), response.items().end(), back_inserter(outItems), &IVIItem::FromProto);
+        IVIItemList outItems;
+        Reserve(outItems, response.items_size());
+        transform(std::make_move_iterator(response.mutable_items()->begin()), std::make_move_iterator(response.mutable_items()->end()),
+            back_inserter(outItems), FromProtoParser<IVIItem>());
         return outItems;
     }
 
@@ -860,6 +1314,98 @@ namespace ivi
             callback);
     }
 
+    IVIResultCount IVIItemClient::GetItems(
+        time_t createdTimestamp,
+        int32_t pageSize,
+        SortOrder sortOrder,
+        Finalized finalized,
+        const function<void(const IVIItem&)>& visitor)
+    {
+        IVI_LOG_FUNC();
+        IVI_LOG_VERBOSE("GetItems (visitor) pageSize=", pageSize);
+        IVI_CHECK(visitor);
+
+        using Response = proto::api::item::Items;
+        return CallUnary<IVIResultCount, Response>(
+            MakeGetItemsRequest(createdTimestamp, pageSize, sortOrder, finalized),
+            &ServiceT::Stub::GetItems,
+            [&visitor](Response&& response) { return VisitEach(*response.mutable_items(), visitor); });
+    }
+
+    void IVIItemClientAsync::GetItems(
+        time_t createdTimestamp,
+        int32_t pageSize,
+        SortOrder sortOrder,
+        Finalized finalized,
+        const function<void(const IVIItem&)>& visitor,
+        const function<void(const IVIResultCount&)>& callback)
+    {
+        IVI_LOG_FUNC();
+        IVI_LOG_VERBOSE("GetItems (async visitor) pageSize=", pageSize);
+        IVI_CHECK(visitor);
+
+        using Response = proto::api::item::Items;
+        CallUnaryAsync<IVIResultCount, Response>(
+            MakeGetItemsRequest(createdTimestamp, pageSize, sortOrder, finalized),
+            &ServiceT::Stub::AsyncGetItems,
+            [visitor](Response&& response) { return VisitEach(*response.mutable_items(), visitor); },
+            callback);
+    }
+
+    static void AppendItems(proto::api::item::Items&& response, IVIItemTable& outTable)
+    {
+        outTable.reserve(outTable.size() + static_cast<size_t>(response.items_size()));
+        for (proto::api::item::Item& item : *response.mutable_items())
+        {
+            outTable.Append(move(item));
+        }
+    }
+
+    IVIResultCount IVIItemClient::GetItems(
+        time_t createdTimestamp,
+        int32_t pageSize,
+        SortOrder sortOrder,
+        Finalized finalized,
+        IVIItemTable& outTable)
+    {
+        IVI_LOG_FUNC();
+        IVI_LOG_VERBOSE("GetItems (table) pageSize=", pageSize);
+
+        using Response = proto::api::item::Items;
+        return CallUnary<IVIResultCount, Response>(
+            MakeGetItemsRequest(createdTimestamp, pageSize, sortOrder, finalized),
+            &ServiceT::Stub::GetItems,
+            [&outTable](Response&& response)
+            {
+                const size_t count(static_cast<size_t>(response.items_size()));
+                AppendItems(move(response), outTable);
+                return count;
+            });
+    }
+
+    void IVIItemClientAsync::GetItems(
+        time_t createdTimestamp,
+        int32_t pageSize,
+        SortOrder sortOrder,
+        Finalized finalized,
+        const function<void(const IVIResultItemTable&)>& callback)
+    {
+        IVI_LOG_FUNC();
+        IVI_LOG_VERBOSE("GetItems (async table) pageSize=", pageSize);
+
+        using Response = proto::api::item::Items;
+        CallUnaryAsync<IVIResultItemTable, Response>(
+            MakeGetItemsRequest(createdTimestamp, pageSize, sortOrder, finalized),
+            &ServiceT::Stub::AsyncGetItems,
+            [](Response&& response)
+            {
+                IVIItemTable table;
+                AppendItems(move(response), table);
+                return table;
+            },
+            callback);
+    }
+
     proto::api::item::UpdateItemMetadataRequest MakeUpdateItemMetadataRequest(
         const string& gameInventoryId,
         const IVIMetadata& metadata)
@@ -867,7 +1413,7 @@ namespace ivi
         proto::api::item::UpdateItemMetadataRequest request;
         auto protoMetadata(request.add_update_items());
         protoMetadata->set_game_inventory_id(gameInventoryId);
-        *protoMetadata->mutable_metadata() = metadata.ToProto();
+        metadata.ToProto(protoMetadata->mutable_metadata());
         return request;
     }
 
@@ -883,8 +1429,10 @@ namespace ivi
     {
         proto::api::item::UpdateItemMetadataRequest request;
         request.mutable_update_items()->Reserve(static_cast<int>(updates.size()));
-        transform(updates.begin(), updates.end(), google::protobuf::RepeatedPtrFieldBackInserter(request.mutable_update_items()),
-            [](const IVIMetadataUpdate& update) { return update.ToProto();  });
+        for (const IVIMetadataUpdate& update : updates)
+        {
+            update.ToProto(request.add_update_items());
+        }
         return request;
     }
 
@@ -944,8 +1492,127 @@ namespace ivi
     template IVIClientT<IVIItemTypeClient::ServiceT>::IVIClientT(
         const IVIConfigurationPtr& configuration,
         const IVIConnectionPtr& conn);
+    template uint32_t IVIClientT<IVIItemTypeClient::ServiceT>::InFlightCalls() const;
+    template uint32_t IVIClientT<IVIItemTypeClient::ServiceT>::QueuedCalls() const;
     IVIItemTypeClient::~IVIItemTypeClient() {}
-    IVIItemTypeClientAsync::~IVIItemTypeClientAsync() {}
+
+    // Collects GetItemType ids until the batch is full or its window alarm fires on the unary queue,
+    // whichever is first, then hands them to the sender as a single batch.  Alarms are never cancelled,
+    // a cancelled alarm completes with ok=false which the client manager treats as a failed queue,
+    // instead a stale alarm just finds its batch already gone when it fires.
+    class IVIItemTypeBatcher
+        : public enable_shared_from_this<IVIItemTypeBatcher>
+        , private NonCopyable<IVIItemTypeBatcher>
+    {
+    public:
+        using Sender                = function<void(const StringList&)>;
+
+        IVIItemTypeBatcher(uint32_t maxIds, uint32_t windowMs, Sender&& sender)
+            : m_maxIds(maxIds)
+            , m_windowMs(windowMs)
+            , m_sender(move(sender))
+        {
+        }
+
+        void Add(const string& gameItemTypeId, grpc::CompletionQueue* queue)
+        {
+            StringList ready;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_pending.push_back(gameItemTypeId);
+                if (m_pending.size() >= m_maxIds)
+                {
+                    ready.swap(m_pending);
+                    m_alarm.reset();
+                }
+                else if (m_pending.size() == 1)
+                {
+                    // The tag keeps its alarm alive until the queue hands it back, fired or cancelled
+                    shared_ptr<IVIItemTypeBatcher> self(shared_from_this());
+                    shared_ptr<grpc::Alarm> armed(make_shared<grpc::Alarm>());
+                    m_alarm = armed;
+                    armed->Set(
+                        queue,
+                        std::chrono::system_clock::now() + std::chrono::milliseconds(m_windowMs),
+                        new AsyncCallback([self, armed](bool ok)
+                            {
+                                if (ok)
+                                {
+                                    self->Expire(armed);
+                                }
+                            }));
+                }
+            }
+
+            if (!ready.empty())
+            {
+                m_sender(ready);
+            }
+        }
+
+        // Detaches any armed alarm, returns the ids that were never sent
+        StringList Shutdown()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            StringList pending;
+            pending.swap(m_pending);
+            m_alarm.reset();
+            return pending;
+        }
+
+    private:
+
+        void Expire(const shared_ptr<grpc::Alarm>& alarm)
+        {
+            StringList ready;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (m_alarm != alarm)
+                {
+                    return; // batch already sent when it filled up, or shut down
+                }
+                ready.swap(m_pending);
+                m_alarm.reset();
+            }
+            m_sender(ready);
+        }
+
+        const uint32_t              m_maxIds;
+        const uint32_t              m_windowMs;
+        const Sender                m_sender;
+        std::mutex                  m_mutex;
+        StringList                  m_pending;
+        shared_ptr<grpc::Alarm>     m_alarm;
+    };
+
+    IVIItemTypeClientAsync::IVIItemTypeClientAsync(
+        const IVIConfigurationPtr& configuration,
+        const IVIConnectionPtr& conn)
+        : IVIClientT<ServiceT>(configuration, conn)
+        , m_getItemTypeFlights(make_shared<GetItemTypeFlights>())
+    {
+        if (GetConfig().itemTypeBatchMaxIds > 0)
+        {
+            // Batches are sent from alarms on the unary queue, which may fire as this client is destroyed
+            const UnaryTarget target(GetUnaryTarget());
+            shared_ptr<GetItemTypeFlights> flights(m_getItemTypeFlights);
+            m_batcher = make_shared<IVIItemTypeBatcher>(
+                GetConfig().itemTypeBatchMaxIds,
+                GetConfig().itemTypeBatchWindowMs,
+                [target, flights](const StringList& gameItemTypeIds) { SendItemTypeBatch(target, flights, gameItemTypeIds); });
+        }
+    }
+
+    IVIItemTypeClientAsync::~IVIItemTypeClientAsync()
+    {
+        if (m_batcher)
+        {
+            for (const string& gameItemTypeId : m_batcher->Shutdown())
+            {
+                m_getItemTypeFlights->Complete(gameItemTypeId, { IVIResultStatus::UNAVAILABLE });
+            }
+        }
+    }
 
     static IVIResultItemType ParseItemTypeListToElement(const IVIResultItemTypeList& result)
     {
@@ -970,14 +1637,95 @@ namespace ivi
     void IVIItemTypeClientAsync::GetItemType(
         const string& gameItemTypeId,
         const function<void(const IVIResultItemType&)>& callback)
+    {
+        if (!m_getItemTypeFlights->Join(gameItemTypeId, callback))
+        {
+            return;
+        }
+
+        if (m_batcher)
+        {
+            m_batcher->Add(gameItemTypeId, Connection()->unaryQueue.get());
+        }
+        else
+        {
+            SendItemTypeLookup(GetUnaryTarget(), m_getItemTypeFlights, gameItemTypeId);
+        }
+    }
+
+    /*static*/
+    void IVIItemTypeClientAsync::SendItemTypeLookup(
+        const UnaryTarget& target,
+        const shared_ptr<GetItemTypeFlights>& flights,
+        const string& gameItemTypeId)
     {
         StringList strlist;
         strlist.push_back(gameItemTypeId);
-        GetItemTypes(
+        SendItemTypes(
+            target,
             strlist, 
-            [callback](const IVIResultItemTypeList& result)
+            [flights, gameItemTypeId](const IVIResultItemTypeList& result)
+            {
+                flights->Complete(gameItemTypeId, ParseItemTypeListToElement(result));
+            });
+    }
+
+    /*static*/
+    void IVIItemTypeClientAsync::SendItemTypeBatch(
+        const UnaryTarget& target,
+        const shared_ptr<GetItemTypeFlights>& flights,
+        const StringList& gameItemTypeIds)
+    {
+        IVI_LOG_VERBOSE("GetItemType batch: ", gameItemTypeIds.size());
+
+        if (gameItemTypeIds.size() == 1)
+        {
+            SendItemTypeLookup(target, flights, gameItemTypeIds.front());
+            return;
+        }
+
+        SendItemTypes(
+            target,
+            gameItemTypeIds,
+            [target, flights, gameItemTypeIds](const IVIResultItemTypeList& result)
             {
-                callback(ParseItemTypeListToElement(result));
+                if (result.Status() == IVIResultStatus::NOT_FOUND)
+                {
+                    // A single unknown id fails the whole batch, so look each one up on its own
+                    for (const string& gameItemTypeId : gameItemTypeIds)
+                    {
+                        SendItemTypeLookup(target, flights, gameItemTypeId);
+                    }
+                    return;
+                }
+
+                if (!result.Success())
+                {
+                    for (const string& gameItemTypeId : gameItemTypeIds)
+                    {
+                        flights->Complete(gameItemTypeId, { result.Status() });
+                    }
+                    return;
+                }
+
+                map<string, const IVIItemType*> found;
+                for (const IVIItemType& itemType : result.Payload())
+                {
+                    found[itemType.gameItemTypeId] = &itemType;
+                }
+
+                for (const string& gameItemTypeId : gameItemTypeIds)
+                {
+                    auto itemType(found.find(gameItemTypeId));
+                    if (itemType == found.end())
+                    {
+                        flights->Complete(gameItemTypeId, { IVIResultStatus::NOT_FOUND });
+                    }
+                    else
+                    {
+                        flights->Complete(gameItemTypeId, { IVIResultStatus::SUCCESS, *itemType->second });
+                    }
+                }
             });
     }
 
@@ -999,10 +1747,12 @@ namespace ivi
         return request;
     }
 
-    static IVIResultItemTypeList::PayloadT ParseItemTypes(const proto::api::itemtype::ItemTypes& response)
+    static IVIResultItemTypeList::PayloadT ParseItemTypes(proto::api::itemtype::ItemTypes&& response)
     {
-        list<IVIItemType> outItems;
-        transform(response.item_types().begin(), response.item_types().end(), back_inserter(outItems), &IVIItemType::FromProto);
+        IVIItemTypeList outItems;
+        Reserve(outItems, response.item_types_size());
+        transform(std::make_move_iterator(response.mutable_item_types()->begin()), std::make_move_iterator(response.mutable_item_types()->end()),
+            back_inserter(outItems), FromProtoParser<IVIItemType>());
         return outItems;
     }
 
@@ -1025,14 +1775,56 @@ namespace ivi
         IVI_LOG_FUNC();
         IVI_LOG_VERBOSE("GetItemTypes (async) request: ", gameItemTypeIds.size());
 
+        SendItemTypes(GetUnaryTarget(), gameItemTypeIds, callback);
+    }
+
+    /*static*/
+    void IVIItemTypeClientAsync::SendItemTypes(
+        const UnaryTarget& target,
+        const StringList& gameItemTypeIds,
+        const function<void(const IVIResultItemTypeList&)>& callback)
+    {
         using Response = proto::api::itemtype::ItemTypes;
         CallUnaryAsync<IVIResultItemTypeList, Response>(
+            target,
             MakeGetItemTypesRequest(gameItemTypeIds),
             &ServiceT::Stub::AsyncGetItemTypes,
             &ParseItemTypes,
             callback);
     }
 
+    IVIResultCount IVIItemTypeClient::GetItemTypes(
+        const StringList& gameItemTypeIds,
+        const function<void(const IVIItemType&)>& visitor)
+    {
+        IVI_LOG_FUNC();
+        IVI_LOG_VERBOSE("GetItemTypes (visitor) request: ", gameItemTypeIds.size());
+        IVI_CHECK(visitor);
+
+        using Response = proto::api::itemtype::ItemTypes;
+        return CallUnary<IVIResultCount, Response>(
+            MakeGetItemTypesRequest(gameItemTypeIds),
+            &ServiceT::Stub::GetItemTypes,
+            [&visitor](Response&& response) { return VisitEach(*response.mutable_item_types(), visitor); });
+    }
+
+    void IVIItemTypeClientAsync::GetItemTypes(
+        const StringList& gameItemTypeIds,
+        const function<void(const IVIItemType&)>& visitor,
+        const function<void(const IVIResultCount&)>& callback)
+    {
+        IVI_LOG_FUNC();
+        IVI_LOG_VERBOSE("GetItemTypes (async visitor) request: ", gameItemTypeIds.size());
+        IVI_CHECK(visitor);
+
+        using Response = proto::api::itemtype::ItemTypes;
+        CallUnaryAsync<IVIResultCount, Response>(
+            MakeGetItemTypesRequest(gameItemTypeIds),
+            &ServiceT::Stub::AsyncGetItemTypes,
+            [visitor](Response&& response) { return VisitEach(*response.mutable_item_types(), visitor); },
+            callback);
+    }
+
     static proto::api::itemtype::CreateItemTypeRequest MakeCreateItemTypeRequest(
         const string& gameItemTypeId,
         const string& tokenName,
@@ -1055,7 +1847,7 @@ namespace ivi
         request.set_transferable(transferable);
         request.set_sellable(sellable);
         *request.mutable_agreement_ids() = { agreementIds.begin(), agreementIds.end() };
-        *request.mutable_metadata() = metadata.ToProto();
+        metadata.ToProto(request.mutable_metadata());
         return request;
     }
 
@@ -1172,7 +1964,7 @@ namespace ivi
     {
         proto::api::itemtype::UpdateItemTypeMetadataPayload request;
         request.set_game_item_type_id(gameItemTypeId);
-        *request.mutable_metadata() = metadata.ToProto();
+        metadata.ToProto(request.mutable_metadata());
         return request;
     }
 
@@ -1213,7 +2005,16 @@ namespace ivi
     template IVIClientT<IVIPlayerClient::ServiceT>::IVIClientT(
         const IVIConfigurationPtr& configuration,
         const IVIConnectionPtr& conn);
+    template uint32_t IVIClientT<IVIPlayerClient::ServiceT>::InFlightCalls() const;
+    template uint32_t IVIClientT<IVIPlayerClient::ServiceT>::QueuedCalls() const;
     IVIPlayerClient::~IVIPlayerClient() {}
+    IVIPlayerClientAsync::IVIPlayerClientAsync(
+        const IVIConfigurationPtr& configuration,
+        const IVIConnectionPtr& conn)
+        : IVIClientT<ServiceT>(configuration, conn)
+        , m_getPlayerFlights(make_shared<GetPlayerFlights>())
+    {
+    }
     IVIPlayerClientAsync::~IVIPlayerClientAsync() {}
 
     static proto::api::player::LinkPlayerRequest MakeLinkPlayerRequest(
@@ -1294,7 +2095,7 @@ namespace ivi
         return CallUnary<IVIResultPlayer, Response>(
             MakeGetPlayerRequest(playerId),
             &ServiceT::Stub::GetPlayer,
-            &IVIPlayer::FromProto);
+            FromProtoParser<IVIPlayer>());
     }
 
     void IVIPlayerClientAsync::GetPlayer(
@@ -1304,12 +2105,23 @@ namespace ivi
         IVI_LOG_FUNC();
         IVI_LOG_VERBOSE("GetPlayer (async) request: ", playerId);
 
+        if (!m_getPlayerFlights->Join(playerId, callback))
+        {
+            return;
+        }
+
+        shared_ptr<GetPlayerFlights> flights(m_getPlayerFlights);
+        function<void(const IVIResultPlayer&)> fanOut = [flights, playerId](const IVIResultPlayer& result)
+        {
+            flights->Complete(playerId, result);
+        };
+
         using Response = proto::api::player::IVIPlayer;
         CallUnaryAsync<IVIResultPlayer, Response>(
             MakeGetPlayerRequest(playerId),
             &ServiceT::Stub::AsyncGetPlayer,
-            &IVIPlayer::FromProto,
-            callback);
+            FromProtoParser<IVIPlayer>(),
+            fanOut);
     }
 
     static proto::api::player::GetPlayersRequest MakeGetPlayersRequest(
@@ -1324,10 +2136,12 @@ namespace ivi
         return request;
     }
 
-    static IVIResultPlayerList::PayloadT ParseIVIPlayers(const proto::api::player::IVIPlayers& response)
+    static IVIResultPlayerList::PayloadT ParseIVIPlayers(proto::api::player::IVIPlayers&& response)
     {
         IVIPlayerList responseList;
-        transform(response.ivi_players().begin(), response.ivi_players().end(), back_inserter(responseList), &IVIPlayer::FromProto);
+        Reserve(responseList, response.ivi_players_size());
+        transform(std::make_move_iterator(response.mutable_ivi_players()->begin()), std::make_move_iterator(response.mutable_ivi_players()->end()),
+            back_inserter(responseList), FromProtoParser<IVIPlayer>());
         return responseList;
     }
 
@@ -1363,6 +2177,42 @@ namespace ivi
             callback);
     }
 
+    IVIResultCount IVIPlayerClient::GetPlayers(
+        time_t createdTimestamp,
+        int32_t pageSize,
+        SortOrder sortOrder,
+        const function<void(const IVIPlayer&)>& visitor)
+    {
+        IVI_LOG_FUNC();
+        IVI_LOG_VERBOSE("GetPlayers (visitor) request: ", pageSize);
+        IVI_CHECK(visitor);
+
+        using Response = proto::api::player::IVIPlayers;
+        return CallUnary<IVIResultCount, Response>(
+            MakeGetPlayersRequest(createdTimestamp, pageSize, sortOrder),
+            &ServiceT::Stub::GetPlayers,
+            [&visitor](Response&& response) { return VisitEach(*response.mutable_ivi_players(), visitor); });
+    }
+
+    void IVIPlayerClientAsync::GetPlayers(
+        time_t createdTimestamp,
+        int32_t pageSize,
+        SortOrder sortOrder,
+        const function<void(const IVIPlayer&)>& visitor,
+        const function<void(const IVIResultCount&)>& callback)
+    {
+        IVI_LOG_FUNC();
+        IVI_LOG_VERBOSE("GetPlayers (async visitor) request: ", pageSize);
+        IVI_CHECK(visitor);
+
+        using Response = proto::api::player::IVIPlayers;
+        CallUnaryAsync<IVIResultCount, Response>(
+            MakeGetPlayersRequest(createdTimestamp, pageSize, sortOrder),
+            &ServiceT::Stub::AsyncGetPlayers,
+            [visitor](Response&& response) { return VisitEach(*response.mutable_ivi_players(), visitor); },
+            callback);
+    }
+
     //////////////////////////////////////////////////////////////////////////
     // Order request clients
     //////////////////////////////////////////////////////////////////////////
@@ -1370,6 +2220,8 @@ namespace ivi
     template IVIClientT<IVIOrderClient::ServiceT>::IVIClientT(
         const IVIConfigurationPtr& configuration,
         const IVIConnectionPtr& conn);
+    template uint32_t IVIClientT<IVIOrderClient::ServiceT>::InFlightCalls() const;
+    template uint32_t IVIClientT<IVIOrderClient::ServiceT>::QueuedCalls() const;
     IVIOrderClient::~IVIOrderClient() {}
     IVIOrderClientAsync::~IVIOrderClientAsync() {}
 
@@ -1390,7 +2242,7 @@ namespace ivi
         return CallUnary<IVIResultOrder, Response>(
             MakeGetOrderRequest(orderId),
             &ServiceT::Stub::GetOrder,
-            &IVIOrder::FromProto);
+            FromProtoParser<IVIOrder>());
     }
 
     void IVIOrderClientAsync::GetOrder(
@@ -1404,7 +2256,7 @@ namespace ivi
         CallUnaryAsync<IVIResultOrder, Response>(
             MakeGetOrderRequest(orderId),
             &ServiceT::Stub::AsyncGetOrder,
-            &IVIOrder::FromProto, 
+            FromProtoParser<IVIOrder>(), 
             callback);
     }
 
@@ -1422,14 +2274,15 @@ namespace ivi
         request.set_store_id(storeId);
         request.set_buyer_player_id(buyerPlayerId);
         request.set_sub_total(subTotal);
-        *request.mutable_address() = address.ToProto();
+        address.ToProto(request.mutable_address());
         request.set_payment_provider_id(ECast(paymentProviderId));
         if(metadata.size() > 0)
             *request.mutable_metadata() = JsonStringToGoogleStruct(metadata);
         request.set_request_ip(requestIp);
-        transform(purchasedItems.begin(), purchasedItems.end(),
-            google::protobuf::RepeatedPtrFieldBackInserter(request.mutable_purchased_items()->mutable_purchased_items()),
-            [](const IVIPurchasedItems& item) { return item.ToProto(); });
+        for (const IVIPurchasedItems& item : purchasedItems)
+        {
+            item.ToProto(request.mutable_purchased_items()->add_purchased_items());
+        }
         return request;
     }
 
@@ -1450,7 +2303,7 @@ namespace ivi
         return CallUnary<IVIResultOrder, Response>(
             MakeCreateOrderRequest(storeId, buyerPlayerId, subTotal, address, paymentProviderId, purchasedItems, metadata, requestIp),
             &ServiceT::Stub::CreateOrder,
-            &IVIOrder::FromProto);
+            FromProtoParser<IVIOrder>());
     }
 
     void IVIOrderClientAsync::CreatePrimaryOrder(
@@ -1471,7 +2324,7 @@ namespace ivi
         CallUnaryAsync<IVIResultOrder, Response>(
             MakeCreateOrderRequest(storeId, buyerPlayerId, subTotal, address, paymentProviderId, purchasedItems, metadata, requestIp),
             &ServiceT::Stub::AsyncCreateOrder,
-            &IVIOrder::FromProto,
+            FromProtoParser<IVIOrder>(),
             callback);
     }
 
@@ -1539,7 +2392,7 @@ namespace ivi
         return CallUnary<IVIResultFinalizeOrderResponse, Response>(
             MakeFinalizeOrderRequest(orderId, fraudSessionId, move(paymentData)),
             &ServiceT::Stub::FinalizeOrder,
-            &IVIFinalizeOrderResponse::FromProto);
+            FromProtoParser<IVIFinalizeOrderResponse>());
     }
 
     void IVIOrderClientAsync::FinalizeBraintreeOrder(
@@ -1579,7 +2432,7 @@ namespace ivi
         CallUnaryAsync<IVIResultFinalizeOrderResponse, Response>(
             MakeFinalizeOrderRequest(orderId, fraudSessionId, move(paymentData)),
             &ServiceT::Stub::AsyncFinalizeOrder,
-            &IVIFinalizeOrderResponse::FromProto,
+            FromProtoParser<IVIFinalizeOrderResponse>(),
             callback);
     }
 
@@ -1590,6 +2443,8 @@ namespace ivi
     template IVIClientT<IVIPaymentClient::ServiceT>::IVIClientT(
         const IVIConfigurationPtr& configuration,
         const IVIConnectionPtr& conn);
+    template uint32_t IVIClientT<IVIPaymentClient::ServiceT>::InFlightCalls() const;
+    template uint32_t IVIClientT<IVIPaymentClient::ServiceT>::QueuedCalls() const;
     IVIPaymentClient::~IVIPaymentClient() {}
     IVIPaymentClientAsync::~IVIPaymentClientAsync() {}
 
@@ -1614,7 +2469,7 @@ namespace ivi
         return CallUnary<IVIResultToken, Response>(
             MakeCreateTokenRequest(id, playerId),
             &ServiceT::Stub::GenerateClientToken,
-            &IVIToken::FromProto);
+            FromProtoParser<IVIToken>());
     }
 
     void IVIPaymentClientAsync::GetToken(
@@ -1629,7 +2484,7 @@ namespace ivi
         CallUnaryAsync<IVIResultToken, Response>(
             MakeCreateTokenRequest(id, playerId),
             &ServiceT::Stub::AsyncGenerateClientToken,
-            &IVIToken::FromProto,
+            FromProtoParser<IVIToken>(),
             callback);
     }
 
@@ -1650,13 +2505,12 @@ namespace ivi
             conn, 
             onItemUpdated,
             &ServiceT::Stub::AsyncItemStatusStream, // subscribe
-            [this]()    // sendConfirm
+            [this](const IVIItemStatusUpdate& update)    // sendConfirm
             {
-                const rpc::streams::item::ItemStatusUpdate& response(CurrentMessage());
                 Confirm(
-                    response.game_inventory_id(),
-                    response.tracking_id(),
-                    ECast(response.item_state()));
+                    update.gameInventoryId,
+                    update.trackingId,
+                    update.itemState);
             })
     {
         IVI_LOG_FUNC_TRIVIAL();
@@ -1698,13 +2552,12 @@ namespace ivi
             conn,
             onItemTypeUpdated,
             &ServiceT::Stub::AsyncItemTypeStatusStream, // subscribe
-            [this]()    // sendConfirm
+            [this](const IVIItemTypeStatusUpdate& update)    // sendConfirm
             {
-                const rpc::streams::itemtype::ItemTypeStatusUpdate& response(CurrentMessage());
                 Confirm(
-                    response.game_item_type_id(),
-                    response.tracking_id(),
-                    ECast(response.item_type_state()));
+                    update.gameItemTypeId,
+                    update.trackingId,
+                    update.itemTypeState);
             })
     {
         IVI_LOG_FUNC_TRIVIAL();
@@ -1746,12 +2599,11 @@ namespace ivi
             conn,
             onOrderUpdated,
             &ServiceT::Stub::AsyncOrderStatusStream, // subscribe
-            [this]()    // sendConfirm
+            [this](const IVIOrderStatusUpdate& update)    // sendConfirm
             {
-                const rpc::streams::order::OrderStatusUpdate& response(CurrentMessage());
                 Confirm(
-                    response.order_id(),
-                    ECast(response.order_state()));
+                    update.orderId,
+                    update.orderState);
             })
     {
         IVI_LOG_FUNC_TRIVIAL();
@@ -1791,13 +2643,12 @@ namespace ivi
             conn,
             onOrderUpdated,
             &ServiceT::Stub::AsyncPlayerStatusStream, // subscribe
-            [this]()    // sendConfirm
+            [this](const IVIPlayerStatusUpdate& update)    // sendConfirm
             {
-                const rpc::streams::player::PlayerStatusUpdate& response(CurrentMessage());
                 Confirm(
-                    response.player_id(),
-                    response.tracking_id(),
-                    ECast(response.player_state()));
+                    update.playerId,
+                    update.trackingId,
+                    update.playerState);
             })
     {
         IVI_LOG_FUNC_TRIVIAL();
@@ -19,6 +19,9 @@ IVIConfigurationPtr IVIConfiguration::DefaultConfiguration(const string& environ
         ,2
         ,10
         ,true
+        ,0
+        ,5
+        ,IVIAdmissionPolicyMap()
     });
 }
 
@@ -0,0 +1,851 @@
+#include "ivi/ivi-export.h"
+#include "ivi/ivi-paging.h"
+#include "ivi/ivi-util.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace ivi
+{
+    //////////////////////////////////////////////////////////////////////////
+    // File layout
+    //////////////////////////////////////////////////////////////////////////
+
+    // header, row group column chunks (each 8 byte aligned), footer, trailer
+    static const char ColumnarMagic[8] = { 'I', 'V', 'I', 'C', 'O', 'L', 'S', '\0' };
+    static const uint32_t ColumnarVersion = 1;
+    static const uint32_t ColumnarByteOrder = 0x01020304;
+
+    // A row group is cut early once a string column holds this many bytes, which keeps
+    // string offsets within 32 bits and memory bounded even for rows with large metadata
+    static const size_t ColumnarMaxChunkBytes = 256 * 1024 * 1024;
+
+    struct ColumnarFileHeader
+    {
+        char                magic[8];
+        uint32_t            version;
+        uint32_t            byteOrder;
+        uint32_t            table;
+        uint32_t            reserved;
+    };
+
+    struct ColumnarTrailer
+    {
+        uint64_t            footerOffset;
+        uint64_t            footerSize;
+        uint64_t            rowCount;
+        char                magic[8];
+    };
+
+    enum class ColumnType : uint32_t
+    {
+        INT64 = 1,          // int64_t per row
+        STRING = 2,         // uint32_t end offset per row, then the bytes
+        DICTIONARY = 3      // uint32_t code per row into the column dictionary in the footer
+    };
+
+    struct ColumnSpec
+    {
+        const char*         name;
+        ColumnType          type;
+    };
+
+    // Add, ForEachItem and ForEachPlayer rely on this column order
+    static const ColumnSpec ItemColumns[] =
+    {
+        { "gameInventoryId",        ColumnType::STRING },
+        { "gameItemTypeId",         ColumnType::DICTIONARY },
+        { "dgoodsId",               ColumnType::INT64 },
+        { "itemName",               ColumnType::STRING },
+        { "playerId",               ColumnType::STRING },
+        { "ownerSidechainAccount",  ColumnType::STRING },
+        { "serialNumber",           ColumnType::INT64 },
+        { "currencyBase",           ColumnType::DICTIONARY },
+        { "metadataUri",            ColumnType::STRING },
+        { "trackingId",             ColumnType::STRING },
+        { "metadata.name",          ColumnType::STRING },
+        { "metadata.description",   ColumnType::STRING },
+        { "metadata.image",         ColumnType::STRING },
+        { "metadata.properties",    ColumnType::STRING },
+        { "createdTimestamp",       ColumnType::INT64 },
+        { "updatedTimestamp",       ColumnType::INT64 },
+        { "itemState",              ColumnType::INT64 }
+    };
+
+    static const ColumnSpec PlayerColumns[] =
+    {
+        { "playerId",               ColumnType::STRING },
+        { "email",                  ColumnType::STRING },
+        { "displayName",            ColumnType::STRING },
+        { "sidechainAccountName",   ColumnType::STRING },
+        { "trackingId",             ColumnType::STRING },
+        { "createdTimestamp",       ColumnType::INT64 },
+        { "playerState",            ColumnType::INT64 }
+    };
+
+    static const ColumnSpec* TableColumns(IVIColumnarTable table, size_t& outCount)
+    {
+        switch (table)
+        {
+        case IVIColumnarTable::ITEMS:
+            outCount = sizeof(ItemColumns) / sizeof(ItemColumns[0]);
+            return ItemColumns;
+        case IVIColumnarTable::PLAYERS:
+            outCount = sizeof(PlayerColumns) / sizeof(PlayerColumns[0]);
+            return PlayerColumns;
+        }
+        outCount = 0;
+        return nullptr;
+    }
+
+    static uint64_t ColumnarPadding(uint64_t offset)
+    {
+        return (8 - (offset & 7)) & 7;
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // IVIColumnarWriter
+    //////////////////////////////////////////////////////////////////////////
+
+    struct IVIColumnarWriter::Column
+    {
+        string                          name;
+        ColumnType                      type;
+        vector<int64_t>                 ints;           // INT64
+        vector<uint32_t>                offsets;        // STRING
+        string                          bytes;          // STRING
+        vector<uint32_t>                codes;          // DICTIONARY
+        vector<string>                  dictionary;     // DICTIONARY, for the whole file
+        unordered_map<string, uint32_t> dictionaryCodes;
+
+        void PutInt(int64_t value)
+        {
+            ints.push_back(value);
+        }
+
+        void PutString(const string& value)
+        {
+            if (type == ColumnType::DICTIONARY)
+            {
+                auto found(dictionaryCodes.find(value));
+                if (found == dictionaryCodes.end())
+                {
+                    found = dictionaryCodes.emplace(value, static_cast<uint32_t>(dictionary.size())).first;
+                    dictionary.push_back(value);
+                }
+                codes.push_back(found->second);
+            }
+            else
+            {
+                bytes.append(value);
+                offsets.push_back(static_cast<uint32_t>(bytes.size()));
+            }
+        }
+    };
+
+    struct IVIColumnarWriter::RowGroup
+    {
+        uint32_t                        rows;
+        vector<pair<uint64_t, uint64_t>> chunks;        // offset, size per column
+    };
+
+    IVIColumnarWriter::IVIColumnarWriter(IVIColumnarTable table, uint32_t rowGroupRows)
+        : m_table(table)
+        , m_rowGroupRows(std::max<uint32_t>(rowGroupRows, 1))
+        , m_offset(0)
+        , m_rows(0)
+        , m_totalRows(0)
+        , m_closed(false)
+    {
+        size_t count;
+        const ColumnSpec* specs(TableColumns(table, count));
+        m_columns.resize(count);
+        for (size_t column = 0; column < count; ++column)
+        {
+            m_columns[column].name = specs[column].name;
+            m_columns[column].type = specs[column].type;
+        }
+    }
+
+    IVIColumnarWriter::~IVIColumnarWriter()
+    {
+        if (!m_closed)
+        {
+            Close();
+        }
+    }
+
+    /*static*/ unique_ptr<IVIColumnarWriter> IVIColumnarWriter::Create(const string& path, IVIColumnarTable table, uint32_t rowGroupRows)
+    {
+        IVI_LOG_FUNC();
+
+        unique_ptr<IVIColumnarWriter> writer(new IVIColumnarWriter(table, rowGroupRows));
+        writer->m_file.reset(new std::ofstream(path, std::ios::binary | std::ios::trunc));
+        if (!*writer->m_file)
+        {
+            IVI_LOG_WARNING("IVIColumnarWriter could not create ", path);
+            return nullptr;
+        }
+
+        ColumnarFileHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, ColumnarMagic, sizeof(ColumnarMagic));
+        header.version = ColumnarVersion;
+        header.byteOrder = ColumnarByteOrder;
+        header.table = static_cast<uint32_t>(table);
+        writer->Write(&header, sizeof(header));
+        return writer;
+    }
+
+    void IVIColumnarWriter::Write(const void* data, size_t size)
+    {
+        m_file->write(static_cast<const char*>(data), size);
+        m_offset += size;
+    }
+
+    void IVIColumnarWriter::Add(const IVIItem& item)
+    {
+        IVI_CHECK(m_table == IVIColumnarTable::ITEMS && !m_closed);
+
+        Column* column(m_columns.data());
+        (column++)->PutString(item.gameInventoryId);
+        (column++)->PutString(item.gameItemTypeId);
+        (column++)->PutInt(item.dgoodsId);
+        (column++)->PutString(item.itemName);
+        (column++)->PutString(item.playerId);
+        (column++)->PutString(item.ownerSidechainAccount);
+        (column++)->PutInt(item.serialNumber);
+        (column++)->PutString(item.currencyBase);
+        (column++)->PutString(item.metadataUri);
+        (column++)->PutString(item.trackingId);
+        (column++)->PutString(item.metadata.name);
+        (column++)->PutString(item.metadata.description);
+        (column++)->PutString(item.metadata.image);
+        (column++)->PutString(item.metadata.properties);
+        (column++)->PutInt(item.createdTimestamp);
+        (column++)->PutInt(item.updatedTimestamp);
+        (column++)->PutInt(static_cast<int64_t>(item.itemState));
+        EndRow();
+    }
+
+    void IVIColumnarWriter::Add(const IVIPlayer& player)
+    {
+        IVI_CHECK(m_table == IVIColumnarTable::PLAYERS && !m_closed);
+
+        Column* column(m_columns.data());
+        (column++)->PutString(player.playerId);
+        (column++)->PutString(player.email);
+        (column++)->PutString(player.displayName);
+        (column++)->PutString(player.sidechainAccountName);
+        (column++)->PutString(player.trackingId);
+        (column++)->PutInt(player.createdTimestamp);
+        (column++)->PutInt(static_cast<int64_t>(player.playerState));
+        EndRow();
+    }
+
+    void IVIColumnarWriter::EndRow()
+    {
+        ++m_rows;
+        ++m_totalRows;
+
+        bool full(m_rows >= m_rowGroupRows);
+        for (const Column& column : m_columns)
+        {
+            full = full || column.bytes.size() >= ColumnarMaxChunkBytes;
+        }
+        if (full)
+        {
+            FlushRowGroup();
+        }
+    }
+
+    void IVIColumnarWriter::FlushRowGroup()
+    {
+        if (m_rows == 0)
+        {
+            return;
+        }
+
+        static const char zeros[8] = {};
+
+        RowGroup rowGroup;
+        rowGroup.rows = m_rows;
+        for (Column& column : m_columns)
+        {
+            Write(zeros, ColumnarPadding(m_offset));
+            const uint64_t offset(m_offset);
+            switch (column.type)
+            {
+            case ColumnType::INT64:
+                Write(column.ints.data(), column.ints.size() * sizeof(int64_t));
+                break;
+            case ColumnType::STRING:
+                Write(column.offsets.data(), column.offsets.size() * sizeof(uint32_t));
+                Write(column.bytes.data(), column.bytes.size());
+                break;
+            case ColumnType::DICTIONARY:
+                Write(column.codes.data(), column.codes.size() * sizeof(uint32_t));
+                break;
+            }
+            rowGroup.chunks.push_back(std::make_pair(offset, m_offset - offset));
+
+            // Keep the capacity, the next row group is likely the same size
+            column.ints.clear();
+            column.offsets.clear();
+            column.bytes.clear();
+            column.codes.clear();
+        }
+
+        m_rowGroups.push_back(std::move(rowGroup));
+        m_rows = 0;
+    }
+
+    bool IVIColumnarWriter::Close()
+    {
+        IVI_LOG_FUNC();
+
+        if (m_closed)
+        {
+            return false;
+        }
+        m_closed = true;
+
+        FlushRowGroup();
+
+        static const char zeros[8] = {};
+        Write(zeros, ColumnarPadding(m_offset));
+
+        const uint64_t footerOffset(m_offset);
+        const auto writeU32 = [this](uint32_t value) { Write(&value, sizeof(value)); };
+        const auto writeString = [this, &writeU32](const string& value)
+        {
+            writeU32(static_cast<uint32_t>(value.size()));
+            Write(value.data(), value.size());
+        };
+
+        writeU32(static_cast<uint32_t>(m_columns.size()));
+        writeU32(static_cast<uint32_t>(m_rowGroups.size()));
+        for (const Column& column : m_columns)
+        {
+            writeU32(static_cast<uint32_t>(column.type));
+            writeString(column.name);
+        }
+        for (const Column& column : m_columns)
+        {
+            if (column.type == ColumnType::DICTIONARY)
+            {
+                writeU32(static_cast<uint32_t>(column.dictionary.size()));
+                for (const string& entry : column.dictionary)
+                {
+                    writeString(entry);
+                }
+            }
+        }
+        for (const RowGroup& rowGroup : m_rowGroups)
+        {
+            writeU32(rowGroup.rows);
+            writeU32(0);
+            for (const pair<uint64_t, uint64_t>& chunk : rowGroup.chunks)
+            {
+                Write(&chunk.first, sizeof(chunk.first));
+                Write(&chunk.second, sizeof(chunk.second));
+            }
+        }
+
+        ColumnarTrailer trailer;
+        trailer.footerOffset = footerOffset;
+        trailer.footerSize = m_offset - footerOffset;
+        trailer.rowCount = m_totalRows;
+        memcpy(trailer.magic, ColumnarMagic, sizeof(ColumnarMagic));
+        Write(&trailer, sizeof(trailer));
+
+        m_file->flush();
+        const bool ok(!!*m_file);
+        m_file->close();
+        if (!ok)
+        {
+            IVI_LOG_WARNING("IVIColumnarWriter failed writing");
+            return false;
+        }
+
+        IVI_LOG_INFO("IVIColumnarWriter wrote rows=", m_totalRows, " rowGroups=", m_rowGroups.size(), " bytes=", m_offset);
+        return true;
+    }
+
+    uint64_t IVIColumnarWriter::RowCount() const
+    {
+        return m_totalRows;
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // IVIColumnarReader
+    //////////////////////////////////////////////////////////////////////////
+
+    struct IVIColumnarReader::Column
+    {
+        string                          name;
+        ColumnType                      type;
+        vector<string>                  dictionary;
+    };
+
+    struct IVIColumnarReader::RowGroup
+    {
+        uint32_t                        rows;
+        vector<pair<uint64_t, uint64_t>> chunks;        // offset, size per column
+    };
+
+    struct IVIColumnarReader::ColumnData
+    {
+        vector<int64_t>                 ints;
+        vector<string>                  strings;
+    };
+
+    // Bounds checked reads over the mapped footer, which carries no alignment guarantees
+    class ColumnarCursor
+    {
+    public:
+        ColumnarCursor(const char* begin, const char* end)
+            : m_at(begin)
+            , m_end(end)
+            , m_ok(true)
+        {
+        }
+
+        template<typename T>
+        T Read()
+        {
+            T value = T();
+            if (Check(sizeof(T)))
+            {
+                memcpy(&value, m_at, sizeof(T));
+                m_at += sizeof(T);
+            }
+            return value;
+        }
+
+        string ReadString()
+        {
+            const uint32_t size(Read<uint32_t>());
+            if (!Check(size))
+            {
+                return string();
+            }
+            string value(m_at, size);
+            m_at += size;
+            return value;
+        }
+
+        bool Ok() const
+        {
+            return m_ok;
+        }
+
+    private:
+        bool Check(size_t size)
+        {
+            m_ok = m_ok && size <= static_cast<size_t>(m_end - m_at);
+            return m_ok;
+        }
+
+        const char*     m_at;
+        const char*     m_end;
+        bool            m_ok;
+    };
+
+    IVIColumnarReader::IVIColumnarReader()
+        : m_table(IVIColumnarTable::ITEMS)
+        , m_rowCount(0)
+    {
+    }
+
+    IVIColumnarReader::~IVIColumnarReader() {}
+
+    /*static*/ unique_ptr<IVIColumnarReader> IVIColumnarReader::Open(const string& path)
+    {
+        IVI_LOG_FUNC();
+
+        unique_ptr<IVIColumnarReader> reader(new IVIColumnarReader());
+        if (!reader->m_file.Open(path))
+        {
+            IVI_LOG_INFO("IVIColumnarReader could not open ", path);
+            return nullptr;
+        }
+
+        const char* data(reader->m_file.Data());
+        const uint64_t size(reader->m_file.Size());
+
+        if (size < sizeof(ColumnarFileHeader) + sizeof(ColumnarTrailer))
+        {
+            IVI_LOG_WARNING("IVIColumnarReader truncated: ", path);
+            return nullptr;
+        }
+
+        ColumnarFileHeader header;
+        memcpy(&header, data, sizeof(header));
+        ColumnarTrailer trailer;
+        memcpy(&trailer, data + size - sizeof(trailer), sizeof(trailer));
+
+        size_t specCount;
+        const ColumnSpec* specs(TableColumns(static_cast<IVIColumnarTable>(header.table), specCount));
+        if (memcmp(header.magic, ColumnarMagic, sizeof(ColumnarMagic)) != 0
+            || header.version != ColumnarVersion
+            || header.byteOrder != ColumnarByteOrder
+            || specs == nullptr)
+        {
+            IVI_LOG_WARNING("IVIColumnarReader not a version ", ColumnarVersion, " columnar file: ", path);
+            return nullptr;
+        }
+
+        const uint64_t footerEnd(size - sizeof(ColumnarTrailer));
+        if (memcmp(trailer.magic, ColumnarMagic, sizeof(ColumnarMagic)) != 0
+            || trailer.footerOffset < sizeof(ColumnarFileHeader)
+            || trailer.footerOffset > footerEnd
+            || trailer.footerSize != footerEnd - trailer.footerOffset)
+        {
+            IVI_LOG_WARNING("IVIColumnarReader truncated or not closed: ", path);
+            return nullptr;
+        }
+
+        ColumnarCursor cursor(data + trailer.footerOffset, data + footerEnd);
+        const uint32_t columnCount(cursor.Read<uint32_t>());
+        const uint32_t rowGroupCount(cursor.Read<uint32_t>());
+
+        // The schema must be exactly the one of this build for rows to be rebuilt by position
+        bool schemaOk(cursor.Ok() && columnCount == specCount);
+        for (uint32_t column = 0; schemaOk && column < columnCount; ++column)
+        {
+            Column schema;
+            schema.type = static_cast<ColumnType>(cursor.Read<uint32_t>());
+            schema.name = cursor.ReadString();
+            schemaOk = cursor.Ok() && schema.type == specs[column].type && schema.name == specs[column].name;
+            reader->m_columns.push_back(std::move(schema));
+        }
+        if (!schemaOk)
+        {
+            IVI_LOG_WARNING("IVIColumnarReader unexpected schema: ", path);
+            return nullptr;
+        }
+
+        for (Column& column : reader->m_columns)
+        {
+            if (column.type == ColumnType::DICTIONARY)
+            {
+                const uint32_t entries(cursor.Read<uint32_t>());
+                for (uint32_t entry = 0; cursor.Ok() && entry < entries; ++entry)
+                {
+                    column.dictionary.push_back(cursor.ReadString());
+                }
+            }
+        }
+
+        uint64_t rowCount(0);
+        for (uint32_t rowGroupIndex = 0; cursor.Ok() && rowGroupIndex < rowGroupCount; ++rowGroupIndex)
+        {
+            RowGroup rowGroup;
+            rowGroup.rows = cursor.Read<uint32_t>();
+            cursor.Read<uint32_t>();
+            for (const Column& column : reader->m_columns)
+            {
+                const uint64_t offset(cursor.Read<uint64_t>());
+                const uint64_t chunkSize(cursor.Read<uint64_t>());
+
+                // Validated once here so column reads need only check string offsets and codes
+                uint64_t minSize(rowGroup.rows * uint64_t(column.type == ColumnType::INT64 ? sizeof(int64_t) : sizeof(uint32_t)));
+                bool exact(column.type != ColumnType::STRING);
+                if (offset < sizeof(ColumnarFileHeader) || offset > trailer.footerOffset
+                    || chunkSize > trailer.footerOffset - offset
+                    || (exact ? chunkSize != minSize : chunkSize < minSize))
+                {
+                    IVI_LOG_WARNING("IVIColumnarReader corrupt row group ", rowGroupIndex, ": ", path);
+                    return nullptr;
+                }
+                rowGroup.chunks.push_back(std::make_pair(offset, chunkSize));
+            }
+            rowCount += rowGroup.rows;
+            reader->m_rowGroups.push_back(std::move(rowGroup));
+        }
+
+        if (!cursor.Ok() || rowCount != trailer.rowCount)
+        {
+            IVI_LOG_WARNING("IVIColumnarReader corrupt footer: ", path);
+            return nullptr;
+        }
+
+        reader->m_table = static_cast<IVIColumnarTable>(header.table);
+        reader->m_rowCount = rowCount;
+        return reader;
+    }
+
+    IVIColumnarTable IVIColumnarReader::Table() const
+    {
+        return m_table;
+    }
+
+    uint64_t IVIColumnarReader::RowCount() const
+    {
+        return m_rowCount;
+    }
+
+    size_t IVIColumnarReader::RowGroupCount() const
+    {
+        return m_rowGroups.size();
+    }
+
+    size_t IVIColumnarReader::RowGroupRows(size_t rowGroup) const
+    {
+        return rowGroup < m_rowGroups.size() ? m_rowGroups[rowGroup].rows : 0;
+    }
+
+    StringList IVIColumnarReader::ColumnNames() const
+    {
+        StringList names;
+        Reserve(names, m_columns.size());
+        for (const Column& column : m_columns)
+        {
+            names.push_back(column.name);
+        }
+        return names;
+    }
+
+    bool IVIColumnarReader::ReadColumn(size_t rowGroupIndex, size_t columnIndex, ColumnData& outData) const
+    {
+        const RowGroup& rowGroup(m_rowGroups[rowGroupIndex]);
+        const Column& column(m_columns[columnIndex]);
+        const char* chunk(m_file.Data() + rowGroup.chunks[columnIndex].first);
+        const uint64_t chunkSize(rowGroup.chunks[columnIndex].second);
+
+        switch (column.type)
+        {
+        case ColumnType::INT64:
+            outData.ints.resize(rowGroup.rows);
+            memcpy(outData.ints.data(), chunk, rowGroup.rows * sizeof(int64_t));
+            return true;
+
+        case ColumnType::STRING:
+        {
+            const char* bytes(chunk + rowGroup.rows * sizeof(uint32_t));
+            const uint64_t bytesSize(chunkSize - rowGroup.rows * sizeof(uint32_t));
+            outData.strings.resize(rowGroup.rows);
+            uint32_t begin(0);
+            for (uint32_t row = 0; row < rowGroup.rows; ++row)
+            {
+                uint32_t end;
+                memcpy(&end, chunk + row * sizeof(uint32_t), sizeof(end));
+                if (end < begin || end > bytesSize)
+                {
+                    return false;
+                }
+                outData.strings[row].assign(bytes + begin, end - begin);
+                begin = end;
+            }
+            return true;
+        }
+
+        case ColumnType::DICTIONARY:
+            outData.strings.resize(rowGroup.rows);
+            for (uint32_t row = 0; row < rowGroup.rows; ++row)
+            {
+                uint32_t code;
+                memcpy(&code, chunk + row * sizeof(uint32_t), sizeof(code));
+                if (code >= column.dictionary.size())
+                {
+                    return false;
+                }
+                outData.strings[row] = column.dictionary[code];
+            }
+            return true;
+        }
+        return false;
+    }
+
+    bool IVIColumnarReader::ReadRowGroup(size_t rowGroup, vector<ColumnData>& outColumns) const
+    {
+        outColumns.resize(m_columns.size());
+        for (size_t column = 0; column < m_columns.size(); ++column)
+        {
+            if (!ReadColumn(rowGroup, column, outColumns[column]))
+            {
+                IVI_LOG_WARNING("IVIColumnarReader corrupt column ", m_columns[column].name, " in row group ", rowGroup);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool IVIColumnarReader::ReadInt64Column(size_t rowGroup, const string& column, vector<int64_t>& outValues) const
+    {
+        for (size_t index = 0; index < m_columns.size(); ++index)
+        {
+            if (m_columns[index].name == column && m_columns[index].type == ColumnType::INT64 && rowGroup < m_rowGroups.size())
+            {
+                ColumnData data;
+                const bool ok(ReadColumn(rowGroup, index, data));
+                outValues.swap(data.ints);
+                return ok;
+            }
+        }
+        return false;
+    }
+
+    bool IVIColumnarReader::ReadStringColumn(size_t rowGroup, const string& column, vector<string>& outValues) const
+    {
+        for (size_t index = 0; index < m_columns.size(); ++index)
+        {
+            if (m_columns[index].name == column && m_columns[index].type != ColumnType::INT64 && rowGroup < m_rowGroups.size())
+            {
+                ColumnData data;
+                const bool ok(ReadColumn(rowGroup, index, data));
+                outValues.swap(data.strings);
+                return ok;
+            }
+        }
+        return false;
+    }
+
+    size_t IVIColumnarReader::ForEachItem(const function<void(const IVIItem&)>& visitor) const
+    {
+        if (m_table != IVIColumnarTable::ITEMS)
+        {
+            return 0;
+        }
+
+        size_t visited(0);
+        vector<ColumnData> columns;
+        for (size_t rowGroup = 0; rowGroup < m_rowGroups.size() && ReadRowGroup(rowGroup, columns); ++rowGroup)
+        {
+            for (uint32_t row = 0; row < m_rowGroups[rowGroup].rows; ++row)
+            {
+                const ColumnData* column(columns.data());
+                IVIItem item;
+                item.gameInventoryId = std::move((column++)->strings[row]);
+                item.gameItemTypeId = std::move((column++)->strings[row]);
+                item.dgoodsId = (column++)->ints[row];
+                item.itemName = std::move((column++)->strings[row]);
+                item.playerId = std::move((column++)->strings[row]);
+                item.ownerSidechainAccount = std::move((column++)->strings[row]);
+                item.serialNumber = static_cast<int32_t>((column++)->ints[row]);
+                item.currencyBase = std::move((column++)->strings[row]);
+                item.metadataUri = std::move((column++)->strings[row]);
+                item.trackingId = std::move((column++)->strings[row]);
+                item.metadata.name = std::move((column++)->strings[row]);
+                item.metadata.description = std::move((column++)->strings[row]);
+                item.metadata.image = std::move((column++)->strings[row]);
+                item.metadata.properties = std::move((column++)->strings[row]);
+                item.createdTimestamp = static_cast<time_t>((column++)->ints[row]);
+                item.updatedTimestamp = static_cast<time_t>((column++)->ints[row]);
+                item.itemState = static_cast<ItemState>((column++)->ints[row]);
+                visitor(item);
+                ++visited;
+            }
+        }
+        return visited;
+    }
+
+    size_t IVIColumnarReader::ForEachPlayer(const function<void(const IVIPlayer&)>& visitor) const
+    {
+        if (m_table != IVIColumnarTable::PLAYERS)
+        {
+            return 0;
+        }
+
+        size_t visited(0);
+        vector<ColumnData> columns;
+        for (size_t rowGroup = 0; rowGroup < m_rowGroups.size() && ReadRowGroup(rowGroup, columns); ++rowGroup)
+        {
+            for (uint32_t row = 0; row < m_rowGroups[rowGroup].rows; ++row)
+            {
+                const ColumnData* column(columns.data());
+                IVIPlayer player;
+                player.playerId = std::move((column++)->strings[row]);
+                player.email = std::move((column++)->strings[row]);
+                player.displayName = std::move((column++)->strings[row]);
+                player.sidechainAccountName = std::move((column++)->strings[row]);
+                player.trackingId = std::move((column++)->strings[row]);
+                player.createdTimestamp = static_cast<time_t>((column++)->ints[row]);
+                player.playerState = static_cast<PlayerState>((column++)->ints[row]);
+                visitor(player);
+                ++visited;
+            }
+        }
+        return visited;
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // Export
+    //////////////////////////////////////////////////////////////////////////
+
+    static IVIResultCount FinishExport(IVIColumnarWriter& writer, const IVIResult& walk, const string& path)
+    {
+        const bool closed(writer.Close());
+        if (!walk.Success() || !closed)
+        {
+            std::remove(path.c_str());
+            return { walk.Success() ? IVIResultStatus::UNKNOWN_ERROR : walk.Status() };
+        }
+        return { IVIResultStatus::SUCCESS, static_cast<size_t>(writer.RowCount()) };
+    }
+
+    IVIResultCount IVIExportItems(IVIClientManagerAsync& manager, const string& path, int32_t pageSize, uint32_t rowGroupRows)
+    {
+        IVI_LOG_FUNC();
+
+        unique_ptr<IVIColumnarWriter> writer(IVIColumnarWriter::Create(path, IVIColumnarTable::ITEMS, rowGroupRows));
+        if (!writer)
+        {
+            return { IVIResultStatus::UNKNOWN_ERROR };
+        }
+
+        IVIItemPager pager(manager.ItemClient(), 0, pageSize, SortOrder::ASC, Finalized::ALL);
+        const IVIResult walk(pager.ForEachItem(manager, [&writer](const IVIItem& item) { writer->Add(item); }));
+        return FinishExport(*writer, walk, path);
+    }
+
+    // The first player listed in ascending order, an empty list if there are none
+    static IVIResultPlayerList OldestPlayer(IVIClientManagerAsync& manager)
+    {
+        // Shared with the callback, which outlives this if polling fails
+        shared_ptr<IVIResultPlayerList> oldest(make_shared<IVIResultPlayerList>(IVIResultStatus::UNAVAILABLE));
+        shared_ptr<bool> received(make_shared<bool>(false));
+        manager.PlayerClient().GetPlayers(0, 1, SortOrder::ASC,
+            [oldest, received](const IVIResultPlayerList& result)
+            {
+                *oldest = result;
+                *received = true;
+            });
+
+        while (!*received)
+        {
+            if (!manager.Poll())
+            {
+                return { IVIResultStatus::UNAVAILABLE };
+            }
+        }
+        return *oldest;
+    }
+
+    IVIResultCount IVIExportPlayers(IVIClientManagerAsync& manager, const string& path, int32_t pageSize, uint32_t partitions, uint32_t rowGroupRows)
+    {
+        IVI_LOG_FUNC();
+
+        unique_ptr<IVIColumnarWriter> writer(IVIColumnarWriter::Create(path, IVIColumnarTable::PLAYERS, rowGroupRows));
+        if (!writer)
+        {
+            return { IVIResultStatus::UNKNOWN_ERROR };
+        }
+
+        // Players are only spread over the last few years, partitions of the whole range since the epoch
+        // would put nearly all of them in the last one, so the range starts at the oldest player
+        const IVIResultPlayerList oldest(OldestPlayer(manager));
+        if (!oldest.Success() || oldest.Payload().empty())
+        {
+            return FinishExport(*writer, { oldest.Status() }, path);
+        }
+
+        const time_t now(time(nullptr));
+        const time_t from(std::min(oldest.Payload().front().createdTimestamp, now));
+        IVIPlayerScan scan(manager.PlayerClient(), from, now, partitions, pageSize, SortOrder::ASC, false);
+        const IVIResult walk(scan.ForEachPlayer(manager, [&writer](const IVIPlayer& player) { writer->Add(player); }));
+        return FinishExport(*writer, walk, path);
+    }
+} // namespace ivi
@@ -0,0 +1,107 @@
+#include "ivi/ivi-intern.h"
+
+#ifdef IVI_SDK_INTERNED_STRINGS
+
+#include <mutex>
+
+namespace ivi
+{
+    //////////////////////////////////////////////////////////////////////////
+    // Pool
+    //////////////////////////////////////////////////////////////////////////
+
+    // Sharded so parsing threads rarely contend.  Values are held weakly, once no model refers to
+    // one anymore its entry is dropped by the next sweep of its shard.
+    struct InternPoolShard
+    {
+        std::mutex                                          mutex;
+        unordered_map<string, std::weak_ptr<const string>>  values;
+        size_t                                              sweepAt = 1024;
+    };
+
+    static const size_t InternPoolShardCount = 16;
+
+    static InternPoolShard* InternPoolShards()
+    {
+        static InternPoolShard shards[InternPoolShardCount];
+        return shards;
+    }
+
+    static const shared_ptr<const string>& EmptyInternedString()
+    {
+        static const shared_ptr<const string> empty(make_shared<const string>());
+        return empty;
+    }
+
+    static shared_ptr<const string> Intern(const string& value)
+    {
+        if (value.empty())
+        {
+            return EmptyInternedString();
+        }
+
+        InternPoolShard& shard(InternPoolShards()[std::hash<string>()(value) % InternPoolShardCount]);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        const auto found(shard.values.find(value));
+        if (found != shard.values.end())
+        {
+            shared_ptr<const string> interned(found->second.lock());
+            if (!interned)
+            {
+                interned = make_shared<const string>(value);
+                found->second = interned;
+            }
+            return interned;
+        }
+
+        if (shard.values.size() >= shard.sweepAt)
+        {
+            for (auto it = shard.values.begin(); it != shard.values.end(); )
+            {
+                it = it->second.expired() ? shard.values.erase(it) : std::next(it);
+            }
+            shard.sweepAt = std::max<size_t>(1024, 2 * shard.values.size());
+        }
+
+        const shared_ptr<const string> interned(make_shared<const string>(value));
+        shard.values.emplace(value, interned);
+        return interned;
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // IVIInternedString
+    //////////////////////////////////////////////////////////////////////////
+
+    IVIInternedString::IVIInternedString()
+        : m_value(EmptyInternedString())
+    {
+    }
+
+    IVIInternedString::IVIInternedString(const string& value)
+        : m_value(Intern(value))
+    {
+    }
+
+    IVIInternedString::IVIInternedString(const char* value)
+        : m_value(Intern(value ? string(value) : string()))
+    {
+    }
+
+    /*static*/ size_t IVIInternedString::PoolSize()
+    {
+        size_t size(0);
+        for (size_t shard = 0; shard < InternPoolShardCount; ++shard)
+        {
+            InternPoolShard& poolShard(InternPoolShards()[shard]);
+            std::lock_guard<std::mutex> lock(poolShard.mutex);
+            for (const auto& entry : poolShard.values)
+            {
+                size += entry.second.expired() ? 0 : 1;
+            }
+        }
+        return size;
+    }
+} // namespace ivi
+
+#endif // IVI_SDK_INTERNED_STRINGS
@@ -0,0 +1,771 @@
+#include "ivi/ivi-json.h"
+
+#include <clocale>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "google/protobuf/struct.pb.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define IVI_JSON_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace ivi
+{
+    using google::protobuf::ListValue;
+    using google::protobuf::Struct;
+    using google::protobuf::Value;
+
+    //////////////////////////////////////////////////////////////////////////
+    // Scanning
+    //////////////////////////////////////////////////////////////////////////
+
+    static inline uint32_t CountTrailingZeros(uint32_t mask)
+    {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return index;
+#else
+        return __builtin_ctz(mask);
+#endif
+    }
+
+    // Within strings, the bytes both directions stop at: quote, backslash, controls and non-ASCII
+    static inline bool IsStringSpecial(unsigned char c)
+    {
+        return c == '"' || c == '\\' || c < 0x20 || c >= 0x80;
+    }
+
+    // What MessageToJsonString escapes beyond those: DEL, and < > so JSON can be embedded in HTML
+    static inline bool IsEscapedOrSpecial(unsigned char c)
+    {
+        return IsStringSpecial(c) || c == 0x7f || c == '<' || c == '>';
+    }
+
+    static inline bool IsWhitespace(unsigned char c)
+    {
+        return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+    }
+
+#ifdef IVI_JSON_SSE2
+    // Signed compare against 0x20 catches controls and, as negative, every non-ASCII byte
+    static inline __m128i StringSpecialBytes(__m128i bytes)
+    {
+        __m128i special(_mm_cmplt_epi8(bytes, _mm_set1_epi8(0x20)));
+        special = _mm_or_si128(special, _mm_cmpeq_epi8(bytes, _mm_set1_epi8('"')));
+        return _mm_or_si128(special, _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\\')));
+    }
+#endif
+
+    // First byte in [at, end) that is special within a string
+    static inline const char* FindStringSpecial(const char* at, const char* end)
+    {
+#ifdef IVI_JSON_SSE2
+        for (; end - at >= 16; at += 16)
+        {
+            const __m128i bytes(_mm_loadu_si128(reinterpret_cast<const __m128i*>(at)));
+            const uint32_t mask(static_cast<uint32_t>(_mm_movemask_epi8(StringSpecialBytes(bytes))));
+            if (mask != 0)
+            {
+                return at + CountTrailingZeros(mask);
+            }
+        }
+#endif
+        while (at < end && !IsStringSpecial(static_cast<unsigned char>(*at)))
+        {
+            ++at;
+        }
+        return at;
+    }
+
+    // First byte in [at, end) that MessageToJsonString escapes or is non-ASCII
+    static inline const char* FindEscapedOrSpecial(const char* at, const char* end)
+    {
+#ifdef IVI_JSON_SSE2
+        for (; end - at >= 16; at += 16)
+        {
+            const __m128i bytes(_mm_loadu_si128(reinterpret_cast<const __m128i*>(at)));
+            __m128i escaped(StringSpecialBytes(bytes));
+            escaped = _mm_or_si128(escaped, _mm_cmpeq_epi8(bytes, _mm_set1_epi8(0x7f)));
+            escaped = _mm_or_si128(escaped, _mm_cmpeq_epi8(bytes, _mm_set1_epi8('<')));
+            escaped = _mm_or_si128(escaped, _mm_cmpeq_epi8(bytes, _mm_set1_epi8('>')));
+            const uint32_t mask(static_cast<uint32_t>(_mm_movemask_epi8(escaped)));
+            if (mask != 0)
+            {
+                return at + CountTrailingZeros(mask);
+            }
+        }
+#endif
+        while (at < end && !IsEscapedOrSpecial(static_cast<unsigned char>(*at)))
+        {
+            ++at;
+        }
+        return at;
+    }
+
+    // First non-whitespace byte in [at, end), vectorized only once a run is long, eg indentation
+    static inline const char* SkipWhitespace(const char* at, const char* end)
+    {
+        for (int i = 0; i < 4 && at < end; ++i, ++at)
+        {
+            if (!IsWhitespace(static_cast<unsigned char>(*at)))
+            {
+                return at;
+            }
+        }
+#ifdef IVI_JSON_SSE2
+        for (; end - at >= 16; at += 16)
+        {
+            const __m128i bytes(_mm_loadu_si128(reinterpret_cast<const __m128i*>(at)));
+            __m128i space(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(' ')));
+            space = _mm_or_si128(space, _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\n')));
+            space = _mm_or_si128(space, _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\r')));
+            space = _mm_or_si128(space, _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\t')));
+            const uint32_t mask(~static_cast<uint32_t>(_mm_movemask_epi8(space)) & 0xffff);
+            if (mask != 0)
+            {
+                return at + CountTrailingZeros(mask);
+            }
+        }
+#endif
+        while (at < end && IsWhitespace(static_cast<unsigned char>(*at)))
+        {
+            ++at;
+        }
+        return at;
+    }
+
+    // Length of the well-formed UTF-8 sequence at [at, end), 0 if it is not one: no overlong
+    // forms, surrogates, or code points past U+10FFFF
+    static size_t Utf8SequenceLength(const char* at, const char* end)
+    {
+        const unsigned char lead(static_cast<unsigned char>(*at));
+        size_t length;
+        unsigned char low(0x80), high(0xbf);    // bounds of the second byte
+        if (lead < 0x80)                    return 1;
+        else if (lead < 0xc2)               return 0;
+        else if (lead < 0xe0)               length = 2;
+        else if (lead < 0xf0)
+        {
+            length = 3;
+            if (lead == 0xe0)               low = 0xa0;
+            else if (lead == 0xed)          high = 0x9f;
+        }
+        else if (lead < 0xf5)
+        {
+            length = 4;
+            if (lead == 0xf0)               low = 0x90;
+            else if (lead == 0xf4)          high = 0x8f;
+        }
+        else                                return 0;
+
+        if (static_cast<size_t>(end - at) < length)
+        {
+            return 0;
+        }
+        const unsigned char second(static_cast<unsigned char>(at[1]));
+        if (second < low || second > high)
+        {
+            return 0;
+        }
+        for (size_t i = 2; i < length; ++i)
+        {
+            if ((static_cast<unsigned char>(at[i]) & 0xc0) != 0x80)
+            {
+                return 0;
+            }
+        }
+        return length;
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // Writer
+    //////////////////////////////////////////////////////////////////////////
+
+    static void AppendUnicodeEscape(uint32_t codeUnit, string& out)
+    {
+        static const char HexDigits[] = "0123456789abcdef";
+        const char escape[6] =
+        {
+            '\\', 'u',
+            HexDigits[(codeUnit >> 12) & 0xf], HexDigits[(codeUnit >> 8) & 0xf],
+            HexDigits[(codeUnit >> 4) & 0xf], HexDigits[codeUnit & 0xf]
+        };
+        out.append(escape, sizeof(escape));
+    }
+
+    static void AppendString(const string& value, string& out)
+    {
+        out.push_back('"');
+        const char* at(value.data());
+        const char* const end(at + value.size());
+        while (at < end)
+        {
+            const char* special(FindEscapedOrSpecial(at, end));
+            out.append(at, special - at);
+            if (special == end)
+            {
+                break;
+            }
+
+            const unsigned char c(static_cast<unsigned char>(*special));
+            at = special + 1;
+            if (c >= 0x80)
+            {
+                // U+2028 and U+2029 are escaped, they end lines in JavaScript, and invalid bytes
+                // are dropped, the rest of UTF-8 passes through
+                const size_t length(Utf8SequenceLength(special, end));
+                if (length == 3 && c == 0xe2 && static_cast<unsigned char>(special[1]) == 0x80
+                    && (static_cast<unsigned char>(special[2]) & 0xfe) == 0xa8)
+                {
+                    AppendUnicodeEscape(static_cast<unsigned char>(special[2]) == 0xa8 ? 0x2028 : 0x2029, out);
+                }
+                else if (length > 0)
+                {
+                    out.append(special, length);
+                }
+                at = special + std::max<size_t>(length, 1);
+                continue;
+            }
+
+            switch (c)
+            {
+            case '"':   out.append("\\\"", 2);  break;
+            case '\\':  out.append("\\\\", 2);  break;
+            case '\b':  out.append("\\b", 2);   break;
+            case '\f':  out.append("\\f", 2);   break;
+            case '\n':  out.append("\\n", 2);   break;
+            case '\r':  out.append("\\r", 2);   break;
+            case '\t':  out.append("\\t", 2);   break;
+            default:    AppendUnicodeEscape(c, out);    break;
+            }
+        }
+        out.push_back('"');
+    }
+
+    // snprintf and strtod follow the C locale's decimal point, JSON always uses '.'
+    static void ToJsonDecimalPoint(char* number)
+    {
+        const char point(*localeconv()->decimal_point);
+        if (point != '.')
+        {
+            for (char* c = number; *c; ++c)
+            {
+                if (*c == point)
+                {
+                    *c = '.';
+                }
+            }
+        }
+    }
+
+    static void FromJsonDecimalPoint(char* number)
+    {
+        const char point(*localeconv()->decimal_point);
+        if (point != '.')
+        {
+            char* dot(strchr(number, '.'));
+            if (dot)
+            {
+                *dot = point;
+            }
+        }
+    }
+
+    static void AppendNumber(double value, string& out)
+    {
+        if (std::isnan(value))
+        {
+            out.append("\"NaN\"");
+            return;
+        }
+        if (std::isinf(value))
+        {
+            out.append(value > 0 ? "\"Infinity\"" : "\"-Infinity\"");
+            return;
+        }
+
+        // Integers up to 15 digits print as %.15g would, without going through it
+        if (value > -1e15 && value < 1e15 && value == std::floor(value))
+        {
+            char digits[24];
+            char* at(digits + sizeof(digits));
+            uint64_t magnitude(static_cast<uint64_t>(std::fabs(value)));
+            do
+            {
+                *--at = static_cast<char>('0' + magnitude % 10);
+                magnitude /= 10;
+            } while (magnitude != 0);
+            if (std::signbit(value))
+            {
+                *--at = '-';
+            }
+            out.append(at, digits + sizeof(digits) - at);
+            return;
+        }
+
+        // As protobuf's SimpleDtoa: 15 significant digits unless they do not round trip, then 17
+        char buffer[32];
+        snprintf(buffer, sizeof(buffer), "%.15g", value);
+        if (strtod(buffer, nullptr) != value)
+        {
+            snprintf(buffer, sizeof(buffer), "%.17g", value);
+        }
+        ToJsonDecimalPoint(buffer);
+        out.append(buffer);
+    }
+
+    static void AppendValue(const Value& value, string& out);
+
+    static void AppendStruct(const Struct& protoStruct, string& out)
+    {
+        out.push_back('{');
+        bool first(true);
+        for (const auto& field : protoStruct.fields())
+        {
+            if (field.second.kind_case() == Value::KIND_NOT_SET)
+            {
+                continue;
+            }
+            if (!first)
+            {
+                out.push_back(',');
+            }
+            first = false;
+            AppendString(field.first, out);
+            out.push_back(':');
+            AppendValue(field.second, out);
+        }
+        out.push_back('}');
+    }
+
+    static void AppendList(const ListValue& list, string& out)
+    {
+        out.push_back('[');
+        bool first(true);
+        for (const Value& value : list.values())
+        {
+            if (value.kind_case() == Value::KIND_NOT_SET)
+            {
+                continue;
+            }
+            if (!first)
+            {
+                out.push_back(',');
+            }
+            first = false;
+            AppendValue(value, out);
+        }
+        out.push_back(']');
+    }
+
+    static void AppendValue(const Value& value, string& out)
+    {
+        switch (value.kind_case())
+        {
+        case Value::kNullValue:     out.append("null");                             break;
+        case Value::kNumberValue:   AppendNumber(value.number_value(), out);        break;
+        case Value::kStringValue:   AppendString(value.string_value(), out);        break;
+        case Value::kBoolValue:     out.append(value.bool_value() ? "true" : "false"); break;
+        case Value::kStructValue:   AppendStruct(value.struct_value(), out);        break;
+        case Value::kListValue:     AppendList(value.list_value(), out);            break;
+        case Value::KIND_NOT_SET:                                                   break;
+        }
+    }
+
+    void AppendGoogleStructJson(const Struct& protoStruct, string& out)
+    {
+        AppendStruct(protoStruct, out);
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // Parser
+    //////////////////////////////////////////////////////////////////////////
+
+    class StructJsonParser
+    {
+    public:
+        StructJsonParser(const char* json, size_t size)
+            : m_at(json)
+            , m_end(json + size)
+        {
+        }
+
+        bool Parse(Struct& outStruct)
+        {
+            m_at = SkipWhitespace(m_at, m_end);
+            if (!ParseStruct(outStruct, 0))
+            {
+                return false;
+            }
+            m_at = SkipWhitespace(m_at, m_end);
+            return m_at == m_end;
+        }
+
+    private:
+        static const int MaxDepth = 100;
+
+        bool Consume(char c)
+        {
+            m_at = SkipWhitespace(m_at, m_end);
+            if (m_at < m_end && *m_at == c)
+            {
+                ++m_at;
+                return true;
+            }
+            return false;
+        }
+
+        bool ParseStruct(Struct& outStruct, int depth)
+        {
+            if (depth >= MaxDepth || !Consume('{'))
+            {
+                return false;
+            }
+            auto& fields(*outStruct.mutable_fields());
+            if (Consume('}'))
+            {
+                return true;
+            }
+            do
+            {
+                m_at = SkipWhitespace(m_at, m_end);
+                if (!ParseString(m_key) || !Consume(':'))
+                {
+                    return false;
+                }
+                auto inserted(fields.insert(google::protobuf::MapPair<string, Value>(m_key)));
+                if (!inserted.second || !ParseValue(inserted.first->second, depth + 1))
+                {
+                    return false;
+                }
+            } while (Consume(','));
+            return Consume('}');
+        }
+
+        bool ParseList(ListValue& outList, int depth)
+        {
+            if (depth >= MaxDepth || !Consume('['))
+            {
+                return false;
+            }
+            if (Consume(']'))
+            {
+                return true;
+            }
+            do
+            {
+                if (!ParseValue(*outList.add_values(), depth + 1))
+                {
+                    return false;
+                }
+            } while (Consume(','));
+            return Consume(']');
+        }
+
+        bool ParseValue(Value& outValue, int depth)
+        {
+            m_at = SkipWhitespace(m_at, m_end);
+            if (m_at == m_end)
+            {
+                return false;
+            }
+            switch (*m_at)
+            {
+            case '{':
+                return ParseStruct(*outValue.mutable_struct_value(), depth);
+            case '[':
+                return ParseList(*outValue.mutable_list_value(), depth);
+            case '"':
+            {
+                string value;
+                if (!ParseString(value))
+                {
+                    return false;
+                }
+                outValue.set_string_value(move(value));
+                return true;
+            }
+            case 't':
+                outValue.set_bool_value(true);
+                return ParseLiteral("true", 4);
+            case 'f':
+                outValue.set_bool_value(false);
+                return ParseLiteral("false", 5);
+            case 'n':
+                outValue.set_null_value(google::protobuf::NULL_VALUE);
+                return ParseLiteral("null", 4);
+            default:
+            {
+                double number;
+                if (!ParseNumber(number))
+                {
+                    return false;
+                }
+                outValue.set_number_value(number);
+                return true;
+            }
+            }
+        }
+
+        bool ParseLiteral(const char* literal, size_t size)
+        {
+            if (static_cast<size_t>(m_end - m_at) < size || memcmp(m_at, literal, size) != 0)
+            {
+                return false;
+            }
+            m_at += size;
+            return true;
+        }
+
+        bool ParseHex4(uint32_t& outCodeUnit)
+        {
+            if (m_end - m_at < 4)
+            {
+                return false;
+            }
+            outCodeUnit = 0;
+            for (int i = 0; i < 4; ++i)
+            {
+                const char c(*m_at++);
+                uint32_t digit;
+                if (c >= '0' && c <= '9')       digit = c - '0';
+                else if (c >= 'a' && c <= 'f')  digit = c - 'a' + 10;
+                else if (c >= 'A' && c <= 'F')  digit = c - 'A' + 10;
+                else                            return false;
+                outCodeUnit = (outCodeUnit << 4) | digit;
+            }
+            return true;
+        }
+
+        static void AppendUtf8(uint32_t codePoint, string& out)
+        {
+            if (codePoint < 0x80)
+            {
+                out.push_back(static_cast<char>(codePoint));
+            }
+            else if (codePoint < 0x800)
+            {
+                out.push_back(static_cast<char>(0xc0 | (codePoint >> 6)));
+                out.push_back(static_cast<char>(0x80 | (codePoint & 0x3f)));
+            }
+            else if (codePoint < 0x10000)
+            {
+                out.push_back(static_cast<char>(0xe0 | (codePoint >> 12)));
+                out.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3f)));
+                out.push_back(static_cast<char>(0x80 | (codePoint & 0x3f)));
+            }
+            else
+            {
+                out.push_back(static_cast<char>(0xf0 | (codePoint >> 18)));
+                out.push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3f)));
+                out.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3f)));
+                out.push_back(static_cast<char>(0x80 | (codePoint & 0x3f)));
+            }
+        }
+
+        bool ParseEscape(string& out)
+        {
+            if (m_at == m_end)
+            {
+                return false;
+            }
+            switch (*m_at++)
+            {
+            case '"':   out.push_back('"');     return true;
+            case '\\':  out.push_back('\\');    return true;
+            case '/':   out.push_back('/');     return true;
+            case 'b':   out.push_back('\b');    return true;
+            case 'f':   out.push_back('\f');    return true;
+            case 'n':   out.push_back('\n');    return true;
+            case 'r':   out.push_back('\r');    return true;
+            case 't':   out.push_back('\t');    return true;
+            case 'u':
+            {
+                uint32_t codePoint;
+                if (!ParseHex4(codePoint))
+                {
+                    return false;
+                }
+                if (codePoint >= 0xdc00 && codePoint <= 0xdfff)
+                {
+                    return false;
+                }
+                if (codePoint >= 0xd800 && codePoint <= 0xdbff)
+                {
+                    uint32_t low;
+                    if (!ParseLiteral("\\u", 2) || !ParseHex4(low) || low < 0xdc00 || low > 0xdfff)
+                    {
+                        return false;
+                    }
+                    codePoint = 0x10000 + ((codePoint - 0xd800) << 10) + (low - 0xdc00);
+                }
+                AppendUtf8(codePoint, out);
+                return true;
+            }
+            default:
+                return false;
+            }
+        }
+
+        bool ParseString(string& outString)
+        {
+            if (m_at == m_end || *m_at != '"')
+            {
+                return false;
+            }
+            ++m_at;
+            outString.clear();
+            for (;;)
+            {
+                const char* special(FindStringSpecial(m_at, m_end));
+                outString.append(m_at, special - m_at);
+                m_at = special;
+                if (m_at == m_end)
+                {
+                    return false;
+                }
+
+                const unsigned char c(static_cast<unsigned char>(*m_at));
+                if (c == '"')
+                {
+                    ++m_at;
+                    return true;
+                }
+                else if (c == '\\')
+                {
+                    ++m_at;
+                    if (!ParseEscape(outString))
+                    {
+                        return false;
+                    }
+                }
+                else if (c >= 0x80)
+                {
+                    const size_t length(Utf8SequenceLength(m_at, m_end));
+                    if (length == 0)
+                    {
+                        return false;
+                    }
+                    outString.append(m_at, length);
+                    m_at += length;
+                }
+                else
+                {
+                    return false;   // unescaped control character
+                }
+            }
+        }
+
+        static bool IsDigit(char c)
+        {
+            return c >= '0' && c <= '9';
+        }
+
+        bool ParseNumber(double& outNumber)
+        {
+            const char* const begin(m_at);
+            const bool negative(m_at < m_end && *m_at == '-');
+            if (negative)
+            {
+                ++m_at;
+            }
+
+            // Integer part, no leading zeros
+            if (m_at == m_end || !IsDigit(*m_at))
+            {
+                return false;
+            }
+            uint64_t integer(0);
+            const char* const digits(m_at);
+            if (*m_at == '0')
+            {
+                ++m_at;
+            }
+            else
+            {
+                for (; m_at < m_end && IsDigit(*m_at); ++m_at)
+                {
+                    integer = integer * 10 + (*m_at - '0');
+                }
+            }
+            const size_t digitCount(m_at - digits);
+
+            bool simple(true);
+            if (m_at < m_end && *m_at == '.')
+            {
+                simple = false;
+                ++m_at;
+                if (m_at == m_end || !IsDigit(*m_at))
+                {
+                    return false;
+                }
+                while (m_at < m_end && IsDigit(*m_at))
+                {
+                    ++m_at;
+                }
+            }
+            if (m_at < m_end && (*m_at == 'e' || *m_at == 'E'))
+            {
+                simple = false;
+                ++m_at;
+                if (m_at < m_end && (*m_at == '+' || *m_at == '-'))
+                {
+                    ++m_at;
+                }
+                if (m_at == m_end || !IsDigit(*m_at))
+                {
+                    return false;
+                }
+                while (m_at < m_end && IsDigit(*m_at))
+                {
+                    ++m_at;
+                }
+            }
+
+            // Integers of up to 15 digits are exact as doubles
+            if (simple && digitCount <= 15)
+            {
+                outNumber = negative ? -static_cast<double>(integer) : static_cast<double>(integer);
+                return true;
+            }
+
+            // strtod needs a terminated copy
+            char buffer[64];
+            string longNumber;
+            char* number(buffer);
+            const size_t size(m_at - begin);
+            if (size < sizeof(buffer))
+            {
+                memcpy(buffer, begin, size);
+                buffer[size] = '\0';
+            }
+            else
+            {
+                longNumber.assign(begin, size);
+                number = &longNumber[0];
+            }
+            FromJsonDecimalPoint(number);
+            outNumber = strtod(number, nullptr);
+            return !std::isinf(outNumber);
+        }
+
+        const char*                 m_at;
+        const char* const           m_end;
+        string                      m_key;      // reused for every object key
+    };
+
+    bool ParseGoogleStructJson(const char* json, size_t size, Struct& outStruct)
+    {
+        outStruct.Clear();
+        return StructJsonParser(json, size).Parse(outStruct);
+    }
+} // namespace ivi
@@ -1,11 +1,15 @@
 
 #include "ivi/ivi-model.h"
+#include "ivi/ivi-json.h"
 #include "ivi/ivi-util.h"
 
 
 #include <limits>
+#include <list>
+#include <mutex>
 
 #include "google/protobuf/util/json_util.h"
+#include "google/protobuf/util/message_differencer.h"
 #include "google/protobuf/struct.pb.h"
 #include "google/protobuf/stubs/status.h"
 
@@ -27,10 +31,8 @@ namespace ivi
 
 string GoogleStructToJsonString(const google::protobuf::Struct& protoStruct)
 {
-    using namespace google::protobuf::util;
-    string jsonString;    
-    Status status(MessageToJsonString(protoStruct, &jsonString));
-    IVI_CHECK(status.ok());
+    string jsonString;
+    AppendGoogleStructJson(protoStruct, jsonString);
     return jsonString;
 }
 
@@ -38,14 +40,278 @@ google::protobuf::Struct JsonStringToGoogleStruct(const string& jsonString)
 {
     using namespace google::protobuf::util;
     google::protobuf::Struct protoStruct;
-    if (!jsonString.empty())
+    if (!jsonString.empty() && !ParseGoogleStructJson(jsonString.data(), jsonString.size(), protoStruct))
     {
+        // The lenient forms json_util accepts, or an error
+        protoStruct.Clear();
         Status status(JsonStringToMessage(jsonString, &protoStruct));
         IVI_CHECK(status.ok());
     }
     return protoStruct;
 }
 
+// Parsed properties keyed by JSON content, LRU
+class MetadataStructCache
+{
+public:
+    static MetadataStructCache& Instance()
+    {
+        static MetadataStructCache instance;
+        return instance;
+    }
+
+    shared_ptr<const google::protobuf::Struct> Parse(const string& json)
+    {
+        if (json.size() > MaxJsonSize)
+        {
+            return make_shared<const google::protobuf::Struct>(JsonStringToGoogleStruct(json));
+        }
+
+        const size_t hash(std::hash<string>()(json));
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            const auto found(m_index.find(hash));
+            if (found != m_index.end() && found->second->json == json)
+            {
+                m_entries.splice(m_entries.begin(), m_entries, found->second);
+                return found->second->protoStruct;
+            }
+        }
+
+        // Parse outside the lock, racing parses of the same JSON are harmless
+        const shared_ptr<const google::protobuf::Struct> protoStruct(
+            make_shared<const google::protobuf::Struct>(JsonStringToGoogleStruct(json)));
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_capacity > 0)
+        {
+            const auto found(m_index.find(hash));
+            if (found != m_index.end())
+            {
+                m_entries.erase(found->second);   // a hash collision, or a racing parse
+                m_index.erase(found);
+            }
+            m_entries.push_front({ hash, json, protoStruct });
+            m_index[hash] = m_entries.begin();
+            Trim();
+        }
+        return protoStruct;
+    }
+
+    void SetCapacity(size_t entries)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_capacity = entries;
+        Trim();
+    }
+
+private:
+    static const size_t MaxJsonSize = 16 * 1024;
+
+    struct Entry
+    {
+        size_t                                      hash;
+        string                                      json;
+        shared_ptr<const google::protobuf::Struct>  protoStruct;
+    };
+    using EntryList = std::list<Entry>;
+
+    MetadataStructCache()
+        : m_capacity(64)
+    {
+    }
+
+    void Trim()
+    {
+        while (m_entries.size() > m_capacity)
+        {
+            m_index.erase(m_entries.back().hash);
+            m_entries.pop_back();
+        }
+    }
+
+    std::mutex                                      m_mutex;
+    size_t                                          m_capacity;
+    EntryList                                       m_entries;      // most recently used first
+    unordered_map<size_t, EntryList::iterator>      m_index;
+};
+
+#ifdef IVI_SDK_LAZY_METADATA_PROPERTIES
+struct IVIMetadataProperties::State
+{
+    string                                      json;
+    shared_ptr<const google::protobuf::Struct>  protoStruct;    // kept from a proto or FromStruct
+    size_t                                      byteSizeEstimate;
+    std::once_flag                              materialized;
+    shared_ptr<const google::protobuf::Struct>  parsedStruct;   // parsed from json by ToStruct
+    std::once_flag                              parsed;
+};
+
+IVIMetadataProperties::IVIMetadataProperties() {}
+
+IVIMetadataProperties::IVIMetadataProperties(const string& json)
+    : IVIMetadataProperties(string(json))
+{
+}
+
+IVIMetadataProperties::IVIMetadataProperties(string&& json)
+{
+    if (!json.empty())
+    {
+        m_state = make_shared<State>();
+        m_state->json = move(json);
+        m_state->byteSizeEstimate = m_state->json.size();
+    }
+}
+
+IVIMetadataProperties::IVIMetadataProperties(const char* json)
+    : IVIMetadataProperties(string(json ? json : ""))
+{
+}
+
+/*static*/ IVIMetadataProperties IVIMetadataProperties::FromStruct(const google::protobuf::Struct& properties)
+{
+    return FromStruct(make_shared<const google::protobuf::Struct>(properties));
+}
+
+/*static*/ IVIMetadataProperties IVIMetadataProperties::FromStruct(google::protobuf::Struct&& properties)
+{
+    // Swap rather than move construct, a moved-to message only steals when on the same arena
+    shared_ptr<google::protobuf::Struct> protoStruct(make_shared<google::protobuf::Struct>());
+    protoStruct->Swap(&properties);
+    return FromStruct(shared_ptr<const google::protobuf::Struct>(move(protoStruct)));
+}
+
+/*static*/ IVIMetadataProperties IVIMetadataProperties::FromStruct(const shared_ptr<const google::protobuf::Struct>& properties)
+{
+    IVIMetadataProperties retVal;
+    if (properties)
+    {
+        retVal.m_state = make_shared<State>();
+        retVal.m_state->protoStruct = properties;
+        retVal.m_state->byteSizeEstimate = properties->ByteSizeLong();
+    }
+    return retVal;
+}
+
+const string& IVIMetadataProperties::Json() const
+{
+    static const string empty;
+    if (!m_state)
+    {
+        return empty;
+    }
+    if (m_state->protoStruct)
+    {
+        State& state(*m_state);
+        std::call_once(state.materialized, [&state]() { state.json = GoogleStructToJsonString(*state.protoStruct); });
+    }
+    return m_state->json;
+}
+
+shared_ptr<const google::protobuf::Struct> IVIMetadataProperties::Struct() const
+{
+    return m_state ? m_state->protoStruct : nullptr;
+}
+
+shared_ptr<const google::protobuf::Struct> IVIMetadataProperties::ToStruct() const
+{
+    if (!m_state)
+    {
+        return nullptr;
+    }
+    if (m_state->protoStruct)
+    {
+        return m_state->protoStruct;
+    }
+    State& state(*m_state);
+    std::call_once(state.parsed, [&state]() { state.parsedStruct = MetadataStructCache::Instance().Parse(state.json); });
+    return state.parsedStruct;
+}
+
+size_t IVIMetadataProperties::ByteSizeEstimate() const
+{
+    return m_state ? m_state->byteSizeEstimate : 0;
+}
+
+bool operator==(const IVIMetadataProperties& lhs, const IVIMetadataProperties& rhs)
+{
+    // Struct fields are a map with no defined order, so their JSON is only comparable structurally
+    const shared_ptr<const google::protobuf::Struct> lhsStruct(lhs.Struct());
+    const shared_ptr<const google::protobuf::Struct> rhsStruct(rhs.Struct());
+    if (lhsStruct && rhsStruct)
+    {
+        return google::protobuf::util::MessageDifferencer::Equals(*lhsStruct, *rhsStruct);
+    }
+    return lhs.Json() == rhs.Json();
+}
+
+bool operator!=(const IVIMetadataProperties& lhs, const IVIMetadataProperties& rhs)
+{
+    return !(lhs == rhs);
+}
+
+std::ostream& operator<<(std::ostream& out, const IVIMetadataProperties& properties)
+{
+    return out << properties.Json();
+}
+
+IVIMetadataProperties MetadataPropertiesFromStruct(const google::protobuf::Struct& properties)
+{
+    return IVIMetadataProperties::FromStruct(properties);
+}
+
+IVIMetadataProperties MetadataPropertiesFromStruct(google::protobuf::Struct&& properties)
+{
+    return IVIMetadataProperties::FromStruct(move(properties));
+}
+
+shared_ptr<const google::protobuf::Struct> MetadataPropertiesStruct(const IVIMetadataProperties& properties)
+{
+    return properties.Struct();
+}
+
+shared_ptr<const google::protobuf::Struct> MetadataPropertiesToStruct(const IVIMetadataProperties& properties)
+{
+    return properties.ToStruct();
+}
+
+size_t MetadataPropertiesByteSize(const IVIMetadataProperties& properties)
+{
+    return properties.ByteSizeEstimate();
+}
+#else
+IVIMetadataProperties MetadataPropertiesFromStruct(const google::protobuf::Struct& properties)
+{
+    return GoogleStructToJsonString(properties);
+}
+
+IVIMetadataProperties MetadataPropertiesFromStruct(google::protobuf::Struct&& properties)
+{
+    return GoogleStructToJsonString(properties);
+}
+
+shared_ptr<const google::protobuf::Struct> MetadataPropertiesStruct(const IVIMetadataProperties&)
+{
+    return nullptr;
+}
+
+shared_ptr<const google::protobuf::Struct> MetadataPropertiesToStruct(const IVIMetadataProperties& properties)
+{
+    return properties.empty() ? nullptr : MetadataStructCache::Instance().Parse(properties);
+}
+
+size_t MetadataPropertiesByteSize(const IVIMetadataProperties& properties)
+{
+    return properties.size();
+}
+#endif
+
+void SetMetadataStructCacheCapacity(size_t entries)
+{
+    MetadataStructCache::Instance().SetCapacity(entries);
+}
+
 IVIMetadata IVIMetadata::FromProto(const proto::common::Metadata& metadata)
 {
     return
@@ -53,28 +319,59 @@ IVIMetadata IVIMetadata::FromProto(const proto::common::Metadata& metadata)
          metadata.name()
         ,metadata.description()
         ,metadata.image()
-        ,GoogleStructToJsonString(metadata.properties())
+        ,MetadataPropertiesFromStruct(metadata.properties())
+    };
+}
+
+IVIMetadata IVIMetadata::FromProto(proto::common::Metadata&& metadata)
+{
+    return
+    {
+         IVI_TAKE_STRING(metadata, name)
+        ,IVI_TAKE_STRING(metadata, description)
+        ,IVI_TAKE_STRING(metadata, image)
+        ,metadata.has_properties() ?
+            MetadataPropertiesFromStruct(move(*metadata.mutable_properties())) :
+            MetadataPropertiesFromStruct(metadata.properties())
     };
 }
 
 proto::common::Metadata IVIMetadata::ToProto() const
 {
     proto::common::Metadata retVal;
-    retVal.set_name(name);
-    retVal.set_description(description);
-    retVal.set_image(image);
-    *retVal.mutable_properties() = JsonStringToGoogleStruct(properties);
+    ToProto(&retVal);
     return retVal;
 }
 
+void IVIMetadata::ToProto(proto::common::Metadata* out) const
+{
+    out->set_name(name);
+    out->set_description(description);
+    out->set_image(image);
+    const shared_ptr<const google::protobuf::Struct> protoStruct(MetadataPropertiesToStruct(properties));
+    if (protoStruct)
+    {
+        *out->mutable_properties() = *protoStruct;
+    }
+    else
+    {
+        out->mutable_properties()->Clear();
+    }
+}
+
 proto::api::item::UpdateItemMetadata IVIMetadataUpdate::ToProto() const
 {
     proto::api::item::UpdateItemMetadata retVal;
-    retVal.set_game_inventory_id(gameInventoryId);
-    *retVal.mutable_metadata() = metadata.ToProto();
+    ToProto(&retVal);
     return retVal;
 }
 
+void IVIMetadataUpdate::ToProto(proto::api::item::UpdateItemMetadata* out) const
+{
+    out->set_game_inventory_id(gameInventoryId);
+    metadata.ToProto(out->mutable_metadata());
+}
+
 IVIItem IVIItem::FromProto(const proto::api::item::Item& item)
 {
     return
@@ -96,26 +393,52 @@ IVIItem IVIItem::FromProto(const proto::api::item::Item& item)
     };
 }
 
+IVIItem IVIItem::FromProto(proto::api::item::Item&& item)
+{
+    return
+    {
+         IVI_TAKE_STRING(item, game_inventory_id)
+        ,IVI_TAKE_STRING(item, game_item_type_id)
+        ,item.dgoods_id()
+        ,IVI_TAKE_STRING(item, item_name)
+        ,IVI_TAKE_STRING(item, player_id)
+        ,IVI_TAKE_STRING(item, owner_sidechain_account)
+        ,item.serial_number()
+        ,IVI_TAKE_STRING(item, currency_base)
+        ,IVI_TAKE_STRING(item, metadata_uri)
+        ,IVI_TAKE_STRING(item, tracking_id)
+        ,item.has_metadata() ? IVIMetadata::FromProto(move(*item.mutable_metadata())) : IVIMetadata::FromProto(item.metadata())
+        ,item.created_timestamp()
+        ,item.updated_timestamp()
+        ,ECast(item.item_state())
+    };
+}
+
 proto::api::item::Item IVIItem::ToProto() const
 {
     proto::api::item::Item retVal;
-    retVal.set_game_inventory_id(gameInventoryId);
-    retVal.set_game_item_type_id(gameItemTypeId);
-    retVal.set_dgoods_id(dgoodsId);
-    retVal.set_item_name(itemName);
-    retVal.set_player_id(playerId);
-    retVal.set_owner_sidechain_account(ownerSidechainAccount);
-    retVal.set_serial_number(serialNumber);
-    retVal.set_currency_base(currencyBase);
-    retVal.set_metadata_uri(metadataUri);
-    retVal.set_tracking_id(trackingId);
-    *retVal.mutable_metadata() = metadata.ToProto();
-    retVal.set_created_timestamp(createdTimestamp);
-    retVal.set_updated_timestamp(updatedTimestamp);
-    retVal.set_item_state(ECast(itemState));
+    ToProto(&retVal);
     return retVal;
 }
 
+void IVIItem::ToProto(proto::api::item::Item* out) const
+{
+    out->set_game_inventory_id(gameInventoryId);
+    out->set_game_item_type_id(gameItemTypeId);
+    out->set_dgoods_id(dgoodsId);
+    out->set_item_name(itemName);
+    out->set_player_id(playerId);
+    out->set_owner_sidechain_account(ownerSidechainAccount);
+    out->set_serial_number(serialNumber);
+    out->set_currency_base(currencyBase);
+    out->set_metadata_uri(metadataUri);
+    out->set_tracking_id(trackingId);
+    metadata.ToProto(out->mutable_metadata());
+    out->set_created_timestamp(createdTimestamp);
+    out->set_updated_timestamp(updatedTimestamp);
+    out->set_item_state(ECast(itemState));
+}
+
 IVIItemType IVIItemType::FromProto(const proto::api::itemtype::ItemType& itemType)
 {
     return
@@ -143,30 +466,66 @@ IVIItemType IVIItemType::FromProto(const proto::api::itemtype::ItemType& itemTyp
     };
 }
 
+IVIItemType IVIItemType::FromProto(proto::api::itemtype::ItemType&& itemType)
+{
+    return
+    {
+         IVI_TAKE_STRING(itemType, game_item_type_id)
+        ,itemType.max_supply()
+        ,itemType.current_supply()
+        ,itemType.issued_supply()
+        ,IVI_TAKE_STRING(itemType, issuer)
+        ,itemType.issue_time_span()
+        ,IVI_TAKE_STRING(itemType, category)
+        ,IVI_TAKE_STRING(itemType, token_name)
+        ,IVI_TAKE_STRING(itemType, base_uri)
+        ,{ std::make_move_iterator(itemType.mutable_agreement_ids()->begin()), std::make_move_iterator(itemType.mutable_agreement_ids()->end()) }
+        ,IVI_TAKE_STRING(itemType, tracking_id)
+        ,itemType.has_metadata() ? IVIMetadata::FromProto(move(*itemType.mutable_metadata())) : IVIMetadata::FromProto(itemType.metadata())
+        ,itemType.created_timestamp()
+        ,itemType.updated_timestamp()
+        ,ECast(itemType.item_type_state())
+        ,itemType.fungible()
+        ,itemType.burnable()
+        ,itemType.transferable()
+        ,itemType.finalized()
+        ,itemType.sellable()
+    };
+}
+
 proto::api::itemtype::ItemType IVIItemType::ToProto() const
 {
-    proto::api::itemtype::ItemType itemType;
-    itemType.set_game_item_type_id(gameItemTypeId);
-    itemType.set_max_supply(maxSupply);
-    itemType.set_current_supply(currentSupply);
-    itemType.set_issued_supply(issuedSupply);
-    itemType.set_issuer(issuer);
-    itemType.set_issue_time_span(issueTimeSpan);
-    itemType.set_category(category);
-    itemType.set_token_name(tokenName);
-    itemType.set_base_uri(baseUri);
-    *itemType.mutable_agreement_ids() = { agreementIds.begin(), agreementIds.end() };
-    itemType.set_tracking_id(trackingId);
-    *itemType.mutable_metadata() = metadata.ToProto();
-    itemType.set_created_timestamp(createdTimestamp);
-    itemType.set_updated_timestamp(updatedTimestamp);
-    itemType.set_item_type_state(ECast(itemTypeState));
-    itemType.set_fungible(fungible);
-    itemType.set_burnable(burnable);
-    itemType.set_transferable(transferable);
-    itemType.set_finalized(finalized);
-    itemType.set_sellable(sellable);
-    return itemType;
+    proto::api::itemtype::ItemType retVal;
+    ToProto(&retVal);
+    return retVal;
+}
+
+void IVIItemType::ToProto(proto::api::itemtype::ItemType* out) const
+{
+    out->set_game_item_type_id(gameItemTypeId);
+    out->set_max_supply(maxSupply);
+    out->set_current_supply(currentSupply);
+    out->set_issued_supply(issuedSupply);
+    out->set_issuer(issuer);
+    out->set_issue_time_span(issueTimeSpan);
+    out->set_category(category);
+    out->set_token_name(tokenName);
+    out->set_base_uri(baseUri);
+    out->clear_agreement_ids();
+    for (const UUID& agreementId : agreementIds)
+    {
+        out->add_agreement_ids(agreementId);
+    }
+    out->set_tracking_id(trackingId);
+    metadata.ToProto(out->mutable_metadata());
+    out->set_created_timestamp(createdTimestamp);
+    out->set_updated_timestamp(updatedTimestamp);
+    out->set_item_type_state(ECast(itemTypeState));
+    out->set_fungible(fungible);
+    out->set_burnable(burnable);
+    out->set_transferable(transferable);
+    out->set_finalized(finalized);
+    out->set_sellable(sellable);
 }
 
 IVIOrderAddress IVIOrderAddress::FromProto(const proto::api::order::Address& address)
@@ -185,21 +544,42 @@ IVIOrderAddress IVIOrderAddress::FromProto(const proto::api::order::Address& add
     };
 }
 
+IVIOrderAddress IVIOrderAddress::FromProto(proto::api::order::Address&& address)
+{
+    return
+    {
+         IVI_TAKE_STRING(address, first_name)
+        ,IVI_TAKE_STRING(address, last_name)
+        ,IVI_TAKE_STRING(address, address_line_1)
+        ,IVI_TAKE_STRING(address, address_line_2)
+        ,IVI_TAKE_STRING(address, city)
+        ,IVI_TAKE_STRING(address, state)
+        ,IVI_TAKE_STRING(address, postal_code)
+        ,IVI_TAKE_STRING(address, country_name)
+        ,IVI_TAKE_STRING(address, country_iso_alpha_2)
+    };
+}
+
 proto::api::order::Address IVIOrderAddress::ToProto() const
 {
     proto::api::order::Address retVal;
-    retVal.set_first_name(firstName);
-    retVal.set_last_name(lastName);
-    retVal.set_address_line_1(addressLine1);
-    retVal.set_address_line_2(addressLine2);
-    retVal.set_city(city);
-    retVal.set_state(state);
-    retVal.set_postal_code(postalCode);
-    retVal.set_country_name(countryName);
-    retVal.set_country_iso_alpha_2(countryIsoAlpha2);
+    ToProto(&retVal);
     return retVal;
 }
 
+void IVIOrderAddress::ToProto(proto::api::order::Address* out) const
+{
+    out->set_first_name(firstName);
+    out->set_last_name(lastName);
+    out->set_address_line_1(addressLine1);
+    out->set_address_line_2(addressLine2);
+    out->set_city(city);
+    out->set_state(state);
+    out->set_postal_code(postalCode);
+    out->set_country_name(countryName);
+    out->set_country_iso_alpha_2(countryIsoAlpha2);
+}
+
 IVIPurchasedItems IVIPurchasedItems::FromProto(const proto::api::order::ItemTypeOrder& purchasedItems)
 {
     return
@@ -213,18 +593,42 @@ IVIPurchasedItems IVIPurchasedItems::FromProto(const proto::api::order::ItemType
     };
 }
 
+IVIPurchasedItems IVIPurchasedItems::FromProto(proto::api::order::ItemTypeOrder&& purchasedItems)
+{
+    return
+    {
+        { std::make_move_iterator(purchasedItems.mutable_game_inventory_ids()->begin()), std::make_move_iterator(purchasedItems.mutable_game_inventory_ids()->end()) }
+        ,IVI_TAKE_STRING(purchasedItems, item_name)
+        ,IVI_TAKE_STRING(purchasedItems, game_item_type_id)
+        ,IVI_TAKE_STRING(purchasedItems, amount_paid)
+        ,IVI_TAKE_STRING(purchasedItems, currency)
+        ,purchasedItems.has_metadata() ?
+            IVIMetadata::FromProto(move(*purchasedItems.mutable_metadata())) :
+            IVIMetadata::FromProto(purchasedItems.metadata())
+    };
+}
+
 proto::api::order::ItemTypeOrder IVIPurchasedItems::ToProto() const
 {
     proto::api::order::ItemTypeOrder retVal;
-    *retVal.mutable_game_inventory_ids() = { gameInventoryIds.begin(), gameInventoryIds.end() };
-    retVal.set_item_name(itemName);
-    retVal.set_game_item_type_id(gameItemTypeId);
-    retVal.set_amount_paid(amountPaid);
-    retVal.set_currency(currency);
-    retVal.set_allocated_metadata(new proto::common::Metadata(metadata.ToProto()));
+    ToProto(&retVal);
     return retVal;
 }
 
+void IVIPurchasedItems::ToProto(proto::api::order::ItemTypeOrder* out) const
+{
+    out->clear_game_inventory_ids();
+    for (const string& gameInventoryId : gameInventoryIds)
+    {
+        out->add_game_inventory_ids(gameInventoryId);
+    }
+    out->set_item_name(itemName);
+    out->set_game_item_type_id(gameItemTypeId);
+    out->set_amount_paid(amountPaid);
+    out->set_currency(currency);
+    metadata.ToProto(out->mutable_metadata());
+}
+
 IVIOrder IVIOrder::FromProto(const proto::api::order::Order& order)
 {
     return
@@ -248,26 +652,58 @@ IVIOrder IVIOrder::FromProto(const proto::api::order::Order& order)
     };
 }
 
+IVIOrder IVIOrder::FromProto(proto::api::order::Order&& order)
+{
+    return
+    {
+         IVI_TAKE_STRING(order, order_id)
+        ,IVI_TAKE_STRING(order, store_id)
+        ,IVI_TAKE_STRING(order, buyer_player_id)
+        ,IVI_TAKE_STRING(order, tax)
+        ,IVI_TAKE_STRING(order, total)
+        ,order.has_address() ? IVIOrderAddress::FromProto(move(*order.mutable_address())) : IVIOrderAddress::FromProto(order.address())
+        ,order.has_metadata() ? GoogleStructToJsonString(order.metadata()) : ""
+        ,IVI_TAKE_STRING(order, created_by)
+        ,IVI_TAKE_STRING(order, request_ip)
+        ,IVI_TAKE_STRING(order, environment_id)
+        ,order.created_timestamp()
+        ,order.has_payment_provider_data() && order.payment_provider_data().has_bitpay() ? 
+               GoogleStructToJsonString(order.payment_provider_data().bitpay().invoice()) :
+               ""
+        ,ECast(order.payment_provider_id())
+        ,ECast(order.order_status())
+    };
+}
+
 proto::api::order::Order IVIOrder::ToProto() const
 {
     proto::api::order::Order retVal;
-    retVal.set_order_id(orderId);
-    retVal.set_store_id(storeId);
-    retVal.set_buyer_player_id(buyerPlayerId);
-    retVal.set_tax(tax);
-    retVal.set_total(total);
-    *retVal.mutable_address() = address.ToProto();
-    retVal.set_payment_provider_id(ECast(paymentProviderId));
+    ToProto(&retVal);
+    return retVal;
+}
+
+void IVIOrder::ToProto(proto::api::order::Order* out) const
+{
+    out->set_order_id(orderId);
+    out->set_store_id(storeId);
+    out->set_buyer_player_id(buyerPlayerId);
+    out->set_tax(tax);
+    out->set_total(total);
+    address.ToProto(out->mutable_address());
+    out->set_payment_provider_id(ECast(paymentProviderId));
     if (metadata.size() > 0)
-        *retVal.mutable_metadata() = JsonStringToGoogleStruct(metadata);
-    retVal.set_created_by(createdBy);
-    retVal.set_request_ip(requestIp);
-    retVal.set_environment_id(environmentId);
-    retVal.set_order_status(ECast(orderStatus));
-    retVal.set_created_timestamp(createdTimestamp);
+        *out->mutable_metadata() = JsonStringToGoogleStruct(metadata);
+    else
+        out->clear_metadata();
+    out->set_created_by(createdBy);
+    out->set_request_ip(requestIp);
+    out->set_environment_id(environmentId);
+    out->set_order_status(ECast(orderStatus));
+    out->set_created_timestamp(createdTimestamp);
     if (bitpayInvoice.size() > 0)
-        *retVal.mutable_payment_provider_data()->mutable_bitpay()->mutable_invoice() = JsonStringToGoogleStruct(bitpayInvoice);
-    return retVal;
+        *out->mutable_payment_provider_data()->mutable_bitpay()->mutable_invoice() = JsonStringToGoogleStruct(bitpayInvoice);
+    else
+        out->clear_payment_provider_data();
 }
 
 IVIFinalizeOrderResponse IVIFinalizeOrderResponse::FromProto(const proto::api::order::FinalizeOrderAsyncResponse& response)
@@ -285,6 +721,21 @@ IVIFinalizeOrderResponse IVIFinalizeOrderResponse::FromProto(const proto::api::o
     };
 }
 
+IVIFinalizeOrderResponse IVIFinalizeOrderResponse::FromProto(proto::api::order::FinalizeOrderAsyncResponse&& response)
+{
+    return
+    {
+         IVI_TAKE_STRING(response, payment_instrument_type)
+        ,IVI_TAKE_STRING(response, transaction_id)
+        ,IVI_TAKE_STRING(response, processor_response)
+        ,response.has_fraud_score() ? response.fraud_score().fraud_score() : numeric_limits<int32_t>::max()
+        ,response.has_fraud_score() ? IVI_TAKE_STRING(*response.mutable_fraud_score(), fraud_omniscore) : string()
+        ,ECast(response.order_status())
+        ,response.success()
+        ,response.has_fraud_score()
+    };
+}
+
 IVIPlayer IVIPlayer::FromProto(const proto::api::player::IVIPlayer& player)
 {
     return
@@ -299,19 +750,38 @@ IVIPlayer IVIPlayer::FromProto(const proto::api::player::IVIPlayer& player)
     };
 }
 
+IVIPlayer IVIPlayer::FromProto(proto::api::player::IVIPlayer&& player)
+{
+    return
+    {
+         IVI_TAKE_STRING(player, player_id)
+        ,IVI_TAKE_STRING(player, email)
+        ,IVI_TAKE_STRING(player, display_name)
+        ,IVI_TAKE_STRING(player, sidechain_account_name)
+        ,IVI_TAKE_STRING(player, tracking_id)
+        ,player.created_timestamp()
+        ,ECast(player.player_state())
+    };
+}
+
 proto::api::player::IVIPlayer IVIPlayer::ToProto() const
 {
     proto::api::player::IVIPlayer retVal;
-    retVal.set_player_id(playerId);
-    retVal.set_email(email);
-    retVal.set_display_name(displayName);
-    retVal.set_sidechain_account_name(sidechainAccountName);
-    retVal.set_tracking_id(trackingId);
-    retVal.set_player_state(ECast(playerState));
-    retVal.set_created_timestamp(createdTimestamp);
+    ToProto(&retVal);
     return retVal;
 }
 
+void IVIPlayer::ToProto(proto::api::player::IVIPlayer* out) const
+{
+    out->set_player_id(playerId);
+    out->set_email(email);
+    out->set_display_name(displayName);
+    out->set_sidechain_account_name(sidechainAccountName);
+    out->set_tracking_id(trackingId);
+    out->set_player_state(ECast(playerState));
+    out->set_created_timestamp(createdTimestamp);
+}
+
 IVIToken IVIToken::FromProto(const proto::api::payment::Token& token)
 {
     if (!token.has_braintree())
@@ -333,6 +803,20 @@ IVIToken IVIToken::FromProto(const proto::api::payment::Token& token)
     };
 }
 
+IVIToken IVIToken::FromProto(proto::api::payment::Token&& token)
+{
+    if (!token.has_braintree())
+    {
+        return FromProto(static_cast<const proto::api::payment::Token&>(token));
+    }
+
+    return
+    {
+         IVI_TAKE_STRING(*token.mutable_braintree(), token)
+        ,PaymentProviderId::BRAINTREE
+    };
+}
+
 IVIPlayerStatusUpdate IVIPlayerStatusUpdate::FromProto(const rpc::streams::player::PlayerStatusUpdate& psu)
 {
     return
@@ -343,6 +827,16 @@ IVIPlayerStatusUpdate IVIPlayerStatusUpdate::FromProto(const rpc::streams::playe
     };
 }
 
+IVIPlayerStatusUpdate IVIPlayerStatusUpdate::FromProto(rpc::streams::player::PlayerStatusUpdate&& psu)
+{
+    return
+    {
+         IVI_TAKE_STRING(psu, player_id)
+        ,IVI_TAKE_STRING(psu, tracking_id)
+        ,ECast(psu.player_state())
+    };
+}
+
 IVIItemStatusUpdate IVIItemStatusUpdate::FromProto(const rpc::streams::item::ItemStatusUpdate& isu)
 {
     return
@@ -358,6 +852,21 @@ IVIItemStatusUpdate IVIItemStatusUpdate::FromProto(const rpc::streams::item::Ite
     };
 }
 
+IVIItemStatusUpdate IVIItemStatusUpdate::FromProto(rpc::streams::item::ItemStatusUpdate&& isu)
+{
+    return
+    {
+         IVI_TAKE_STRING(isu, game_inventory_id)
+        ,IVI_TAKE_STRING(isu, game_item_type_id)
+        ,IVI_TAKE_STRING(isu, player_id)
+        ,IVI_TAKE_STRING(isu, metadata_uri)
+        ,IVI_TAKE_STRING(isu, tracking_id)
+        ,isu.dgoods_id()
+        ,isu.serial_number()
+        ,ECast(isu.item_state())
+    };
+}
+
 IVIItemTypeStatusUpdate IVIItemTypeStatusUpdate::FromProto(const rpc::streams::itemtype::ItemTypeStatusUpdate& itsu)
 {
     return
@@ -372,6 +881,20 @@ IVIItemTypeStatusUpdate IVIItemTypeStatusUpdate::FromProto(const rpc::streams::i
     };
 }
 
+IVIItemTypeStatusUpdate IVIItemTypeStatusUpdate::FromProto(rpc::streams::itemtype::ItemTypeStatusUpdate&& itsu)
+{
+    return
+    {
+         IVI_TAKE_STRING(itsu, game_item_type_id)
+        ,IVI_TAKE_STRING(itsu, base_uri)
+        ,IVI_TAKE_STRING(itsu, tracking_id)
+        ,itsu.current_supply()
+        ,itsu.issued_supply()
+        ,itsu.issue_time_span()
+        ,ECast(itsu.item_type_state())
+    };
+}
+
 IVIOrderStatusUpdate IVIOrderStatusUpdate::FromProto(const rpc::streams::order::OrderStatusUpdate& osu)
 {
     return
@@ -381,4 +904,13 @@ IVIOrderStatusUpdate IVIOrderStatusUpdate::FromProto(const rpc::streams::order::
     };
 }
 
+IVIOrderStatusUpdate IVIOrderStatusUpdate::FromProto(rpc::streams::order::OrderStatusUpdate&& osu)
+{
+    return
+    {
+         IVI_TAKE_STRING(osu, order_id)
+        ,ECast(osu.order_state())
+    };
+}
+
 } // namespace ivi
@@ -0,0 +1,650 @@
+#include "ivi/ivi-paging.h"
+#include "ivi/ivi-table.h"
+#include "ivi/ivi-util.h"
+
+#include <deque>
+#include <set>
+
+namespace ivi
+{
+    //////////////////////////////////////////////////////////////////////////
+    // IVIPagerState
+    //////////////////////////////////////////////////////////////////////////
+
+    static const string& PageKey(const IVIItem& item)           { return item.gameInventoryId; }
+    static const string& PageKey(const IVIPlayer& player)       { return player.playerId; }
+
+    // How the pager state walks the rows of a page: the model lists, or the columns of an IVIItemTable
+    template<typename TPage>
+    struct IVIPageRows;
+
+    template<typename TItem>
+    struct IVIPageRows<IVIListT<TItem>>
+    {
+        using Page                  = IVIListT<TItem>;
+        using Row                   = typename Page::const_iterator;
+
+        static Row                  Begin(const Page& page)                         { return page.begin(); }
+        static Row                  End(const Page& page)                           { return page.end(); }
+        static time_t               Created(const Page& /*page*/, Row row)          { return row->createdTimestamp; }
+        static const string&        Key(const Page& /*page*/, Row row)              { return PageKey(*row); }
+        static time_t               LastCreated(const Page& page)                   { return page.back().createdTimestamp; }
+        static void                 Append(Page& out, const Page& /*page*/, Row row) { out.push_back(*row); }
+    };
+
+    template<>
+    struct IVIPageRows<IVIItemTable>
+    {
+        using Page                  = IVIItemTable;
+        using Row                   = size_t;
+
+        static Row                  Begin(const Page& /*page*/)                     { return 0; }
+        static Row                  End(const Page& page)                           { return page.size(); }
+        static time_t               Created(const Page& page, Row row)              { return page.createdTimestamp()[row]; }
+        static const string&        Key(const Page& page, Row row)                  { return page.gameInventoryId()[row]; }
+        static time_t               LastCreated(const Page& page)                   { return page.createdTimestamp().back(); }
+        static void                 Append(Page& out, const Page& page, Row row)    { out.AppendRow(page, row); }
+    };
+
+    template<typename TPage>
+    class IVIPagerState
+        : public std::enable_shared_from_this<IVIPagerState<TPage>>
+        , private NonCopyable<IVIPagerState<TPage>>
+    {
+    public:
+        using ItemList              = TPage;
+        using Rows                  = IVIPageRows<TPage>;
+        using ResultList            = IVIResultT<ItemList>;
+        using OnPage                = function<void(const ResultList&, bool)>;
+        using Fetch                 = function<void(time_t, const function<void(const ResultList&)>&)>;
+
+        IVIPagerState(const Fetch& fetch, time_t createdTimestamp, int32_t pageSize)
+            : m_fetch(fetch)
+            , m_cursor(createdTimestamp)
+            , m_pageSize(pageSize)
+            , m_bounded(false)
+            , m_ascending(true)
+            , m_from(0)
+            , m_until(0)
+            , m_requesting(false)
+            , m_delivering(false)
+            , m_finished(false)
+            , m_delivered(false)
+        {
+        }
+
+        // Only returns items created in [from, until), the walk ends at the first item past the range
+        void SetBounds(time_t from, time_t until, bool ascending)
+        {
+            m_bounded = true;
+            m_from = from;
+            m_until = until;
+            m_ascending = ascending;
+        }
+
+        // Push style
+        void Start(const OnPage& onPage)
+        {
+            IVI_CHECK(!m_onPage && m_pages.empty());
+            m_onPage = onPage;
+            Request();
+        }
+
+        // Buffered style, onBuffered is called whenever a page can be taken
+        void SetOnBuffered(const function<void()>& onBuffered)
+        {
+            m_onBuffered = onBuffered;
+        }
+
+        void Prefetch()
+        {
+            IVI_CHECK(!m_onPage);
+            Request();
+        }
+
+        bool TryTakePage(ResultList& outPage, bool& outLast)
+        {
+            IVI_CHECK(!m_onPage);
+            if (m_pages.empty())
+            {
+                return false;
+            }
+
+            outPage = move(m_pages.front());
+            m_pages.pop_front();
+            if (m_pages.empty())
+            {
+                // The page being taken was the only one buffered, so start on the next
+                if (m_finished)
+                    m_delivered = true;
+                else
+                    Request();
+            }
+            outLast = m_delivered;
+            return true;
+        }
+
+        // Pull style
+        ResultList NextPage(IVIClientManagerAsync& manager)
+        {
+            if (m_delivered)
+            {
+                return { IVIResultStatus::SUCCESS, ItemList() };
+            }
+
+            Prefetch();
+            ResultList page;
+            bool last = false;
+            while (!TryTakePage(page, last))
+            {
+                if (!manager.Poll())
+                {
+                    m_finished = m_delivered = true;
+                    return { IVIResultStatus::UNAVAILABLE };
+                }
+            }
+            return page;
+        }
+
+        bool Done() const
+        {
+            return m_delivered;
+        }
+
+    private:
+
+        void Request()
+        {
+            if (m_requesting || m_finished)
+            {
+                return;
+            }
+
+            m_requesting = true;
+            std::weak_ptr<IVIPagerState> weakSelf(this->shared_from_this());
+            m_fetch(m_cursor,
+                [weakSelf](const ResultList& result)
+                {
+                    shared_ptr<IVIPagerState> self(weakSelf.lock());
+                    if (self)
+                    {
+                        self->Receive(result);
+                    }
+                });
+        }
+
+        bool IsPastEnd(time_t createdTimestamp) const
+        {
+            return m_bounded && (m_ascending ? createdTimestamp >= m_until : createdTimestamp < m_from);
+        }
+
+        bool IsInRange(time_t createdTimestamp) const
+        {
+            return !m_bounded || (createdTimestamp >= m_from && createdTimestamp < m_until);
+        }
+
+        void Receive(const ResultList& result)
+        {
+            m_requesting = false;
+
+            if (!result.Success())
+            {
+                IVI_LOG_WARNING("IVIPager page request failed with status ", static_cast<int32_t>(result.Status()));
+                m_finished = true;
+                Deliver(ResultList{ result.Status() });
+                return;
+            }
+
+            const ItemList& items(result.Payload());
+            ItemList fresh;
+            bool progressed = false;
+            for (typename Rows::Row row = Rows::Begin(items); row != Rows::End(items); ++row)
+            {
+                const time_t createdTimestamp(Rows::Created(items, row));
+                if (createdTimestamp == m_cursor && m_boundaryKeys.find(Rows::Key(items, row)) != m_boundaryKeys.end())
+                {
+                    continue;
+                }
+
+                progressed = true;
+                if (IsPastEnd(createdTimestamp))
+                {
+                    // Pages are in walk order, nothing after this item is in range either
+                    m_finished = true;
+                    break;
+                }
+                if (IsInRange(createdTimestamp))
+                {
+                    Rows::Append(fresh, items, row);
+                }
+            }
+
+            if (!m_finished && (m_pageSize <= 0 || items.size() < static_cast<size_t>(m_pageSize)))
+            {
+                m_finished = true;
+            }
+            else if (!m_finished && !progressed)
+            {
+                // The whole page shares the cursor timestamp, the cursor cannot move past it
+                IVI_LOG_WARNING("IVIPager more than a page of items at createdTimestamp=", m_cursor, ", stopping");
+                m_finished = true;
+            }
+            else if (!m_finished)
+            {
+                const time_t nextCursor(Rows::LastCreated(items));
+                if (nextCursor != m_cursor)
+                {
+                    m_boundaryKeys.clear();
+                    m_cursor = nextCursor;
+                }
+                for (typename Rows::Row row = Rows::Begin(items); row != Rows::End(items); ++row)
+                {
+                    if (Rows::Created(items, row) == m_cursor)
+                    {
+                        m_boundaryKeys.insert(Rows::Key(items, row));
+                    }
+                }
+            }
+
+            Deliver(ResultList{ IVIResultStatus::SUCCESS, move(fresh) });
+        }
+
+        void Deliver(ResultList&& page)
+        {
+            // onPage and onBuffered may destroy the pager, keep the state alive until they return
+            shared_ptr<IVIPagerState> self(this->shared_from_this());
+
+            if (!m_onPage)
+            {
+                // Buffered or pull style, the next request goes out once this page is taken
+                m_pages.push_back(move(page));
+                if (m_onBuffered)
+                {
+                    function<void()> onBuffered(m_onBuffered);
+                    onBuffered();
+                }
+                return;
+            }
+
+            // Push style, a page completing while another is delivered, eg the prefetch failing synchronously
+            // in Request or a page polled from onPage, waits for the loop below so pages stay in order
+            m_pages.push_back(move(page));
+            if (m_delivering)
+            {
+                return;
+            }
+
+            m_delivering = true;
+            while (!m_pages.empty())
+            {
+                ResultList next(move(m_pages.front()));
+                m_pages.pop_front();
+
+                // The next page transfers while this one is processed
+                Request();
+                const bool last(m_finished && m_pages.empty());
+                if (last)
+                {
+                    m_delivered = true;
+                }
+
+                OnPage onPage(m_onPage);
+                onPage(next, last);
+            }
+            m_delivering = false;
+        }
+
+        const Fetch                 m_fetch;
+        time_t                      m_cursor;
+        const int32_t               m_pageSize;
+        bool                        m_bounded;
+        bool                        m_ascending;
+        time_t                      m_from;
+        time_t                      m_until;
+        std::set<string>            m_boundaryKeys;     // keys seen with createdTimestamp == m_cursor
+        std::deque<ResultList>      m_pages;            // buffered and pull style, push style only while delivering
+        OnPage                      m_onPage;           // push style only
+        function<void()>            m_onBuffered;
+        bool                        m_requesting;
+        bool                        m_delivering;       // push style onPage loop running
+        bool                        m_finished;         // no more requests
+        bool                        m_delivered;        // and the last page has been handed out
+    };
+
+    //////////////////////////////////////////////////////////////////////////
+    // IVIItemPager
+    //////////////////////////////////////////////////////////////////////////
+
+    IVIItemPager::IVIItemPager(
+        IVIItemClientAsync& client,
+        time_t createdTimestamp,
+        int32_t pageSize,
+        SortOrder sortOrder,
+        Finalized finalized)
+        : m_state(make_shared<IVIPagerState<IVIItemList>>(
+            [&client, pageSize, sortOrder, finalized](time_t cursor, const function<void(const IVIResultItemList&)>& callback)
+            {
+                client.GetItems(cursor, pageSize, sortOrder, finalized, callback);
+            },
+            createdTimestamp,
+            pageSize))
+    {
+    }
+
+    IVIItemPager::~IVIItemPager() {}
+
+    void IVIItemPager::Start(const OnPage& onPage)
+    {
+        m_state->Start(onPage);
+    }
+
+    IVIResultItemList IVIItemPager::NextPage(IVIClientManagerAsync& manager)
+    {
+        return m_state->NextPage(manager);
+    }
+
+    IVIResult IVIItemPager::ForEachItem(IVIClientManagerAsync& manager, const function<void(const IVIItem&)>& visitor)
+    {
+        while (!Done())
+        {
+            const IVIResultItemList page(NextPage(manager));
+            if (!page.Success())
+            {
+                return { page.Status() };
+            }
+            for (const IVIItem& item : page.Payload())
+            {
+                visitor(item);
+            }
+        }
+        return { IVIResultStatus::SUCCESS };
+    }
+
+    bool IVIItemPager::Done() const
+    {
+        return m_state->Done();
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // IVIItemTablePager
+    //////////////////////////////////////////////////////////////////////////
+
+    IVIItemTablePager::IVIItemTablePager(
+        IVIItemClientAsync& client,
+        time_t createdTimestamp,
+        int32_t pageSize,
+        SortOrder sortOrder,
+        Finalized finalized)
+        : m_state(make_shared<IVIPagerState<IVIItemTable>>(
+            [&client, pageSize, sortOrder, finalized](time_t cursor, const function<void(const IVIResultItemTable&)>& callback)
+            {
+                client.GetItems(cursor, pageSize, sortOrder, finalized, callback);
+            },
+            createdTimestamp,
+            pageSize))
+    {
+    }
+
+    IVIItemTablePager::~IVIItemTablePager() {}
+
+    void IVIItemTablePager::Start(const OnPage& onPage)
+    {
+        m_state->Start(onPage);
+    }
+
+    IVIResultItemTable IVIItemTablePager::NextPage(IVIClientManagerAsync& manager)
+    {
+        return m_state->NextPage(manager);
+    }
+
+    IVIResultCount IVIItemTablePager::AppendAll(IVIClientManagerAsync& manager, IVIItemTable& outTable)
+    {
+        const size_t initialSize(outTable.size());
+        while (!Done())
+        {
+            const IVIResultItemTable page(NextPage(manager));
+            if (!page.Success())
+            {
+                return { page.Status(), outTable.size() - initialSize };
+            }
+            outTable.Append(page.Payload());
+        }
+        return { IVIResultStatus::SUCCESS, outTable.size() - initialSize };
+    }
+
+    bool IVIItemTablePager::Done() const
+    {
+        return m_state->Done();
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // IVIPlayerScanState
+    //////////////////////////////////////////////////////////////////////////
+
+    class IVIPlayerScanState
+        : public std::enable_shared_from_this<IVIPlayerScanState>
+        , private NonCopyable<IVIPlayerScanState>
+    {
+    public:
+        using Partition             = IVIPagerState<IVIPlayerList>;
+        using PartitionPtr          = shared_ptr<Partition>;
+        using OnPage                = IVIPlayerScan::OnPage;
+
+        IVIPlayerScanState(
+            IVIPlayerClientAsync& client,
+            time_t fromTimestamp,
+            time_t toTimestamp,
+            uint32_t partitions,
+            int32_t pageSize,
+            SortOrder sortOrder,
+            bool ordered)
+            : m_ordered(ordered)
+            , m_current(0)
+            , m_remaining(0)
+            , m_done(false)
+        {
+            IVI_CHECK(fromTimestamp <= toTimestamp);
+            IVI_CHECK(partitions > 0);
+
+            // [from, to] split into count half-open ranges as equal as possible
+            const uint64_t span(static_cast<uint64_t>(toTimestamp - fromTimestamp) + 1);
+            const uint64_t count(std::min<uint64_t>(partitions, span));
+            const uint64_t base(span / count), extra(span % count);
+            const bool ascending(sortOrder == SortOrder::ASC);
+            for (uint64_t i = 0; i < count; ++i)
+            {
+                const time_t from(static_cast<time_t>(fromTimestamp + i * base + std::min(i, extra)));
+                const time_t until(static_cast<time_t>(from + base + (i < extra ? 1 : 0)));
+
+                // Starting just outside the range finds the items at its edge whether or not
+                // the server includes the cursor timestamp, SetBounds drops the ones outside
+                const time_t start(ascending ? (from > 0 ? from - 1 : 0) : until);
+                PartitionPtr partition(make_shared<Partition>(
+                    [&client, pageSize, sortOrder](time_t cursor, const function<void(const IVIResultPlayerList&)>& callback)
+                    {
+                        client.GetPlayers(cursor, pageSize, sortOrder, callback);
+                    },
+                    start,
+                    pageSize));
+                partition->SetBounds(from, until, ascending);
+                m_partitions.push_back(partition);
+            }
+
+            // Ordered delivery takes the partitions in walk order
+            if (!ascending)
+            {
+                std::reverse(m_partitions.begin(), m_partitions.end());
+            }
+            m_remaining = m_partitions.size();
+        }
+
+        void Start(const OnPage& onPage)
+        {
+            IVI_CHECK(!m_onPage);
+            m_onPage = onPage;
+
+            for (const PartitionPtr& partition : m_partitions)
+            {
+                // Partitions are owned by this state, so they never call back into a destroyed one
+                if (m_ordered)
+                {
+                    partition->SetOnBuffered([this]() { Drain(); });
+                    partition->Prefetch();
+                }
+                else
+                {
+                    partition->Start([this](const IVIResultPlayerList& page, bool last) { OnPartitionPage(page, last); });
+                }
+            }
+        }
+
+        void Cancel()
+        {
+            m_done = true;
+        }
+
+        bool Done() const
+        {
+            return m_done;
+        }
+
+        size_t PartitionCount() const
+        {
+            return m_partitions.size();
+        }
+
+    private:
+
+        void OnPartitionPage(const IVIResultPlayerList& page, bool partitionLast)
+        {
+            if (m_done)
+            {
+                return;
+            }
+
+            if (!page.Success())
+            {
+                Deliver(page, true);
+                return;
+            }
+
+            if (partitionLast)
+            {
+                --m_remaining;
+            }
+            if (m_remaining == 0 || !page.Payload().empty())
+            {
+                Deliver(page, m_remaining == 0);
+            }
+        }
+
+        void Drain()
+        {
+            shared_ptr<IVIPlayerScanState> self(shared_from_this());
+            IVIResultPlayerList page;
+            bool partitionLast = false;
+            while (!m_done && m_partitions[m_current]->TryTakePage(page, partitionLast))
+            {
+                if (!page.Success())
+                {
+                    Deliver(page, true);
+                    return;
+                }
+
+                if (partitionLast)
+                {
+                    ++m_current;
+                }
+                const bool last(m_current == m_partitions.size());
+                if (last || !page.Payload().empty())
+                {
+                    Deliver(page, last);
+                }
+            }
+        }
+
+        void Deliver(const IVIResultPlayerList& page, bool last)
+        {
+            if (last)
+            {
+                m_done = true;
+            }
+
+            shared_ptr<IVIPlayerScanState> self(shared_from_this());
+            OnPage onPage(m_onPage);
+            onPage(page, last);
+        }
+
+        const bool                  m_ordered;
+        vector<PartitionPtr>        m_partitions;
+        size_t                      m_current;      // ordered only, the partition being delivered
+        size_t                      m_remaining;    // unordered only, partitions not yet done
+        OnPage                      m_onPage;
+        bool                        m_done;
+    };
+
+    //////////////////////////////////////////////////////////////////////////
+    // IVIPlayerScan
+    //////////////////////////////////////////////////////////////////////////
+
+    IVIPlayerScan::IVIPlayerScan(
+        IVIPlayerClientAsync& client,
+        time_t fromTimestamp,
+        time_t toTimestamp,
+        uint32_t partitions,
+        int32_t pageSize,
+        SortOrder sortOrder,
+        bool ordered)
+        : m_state(make_shared<IVIPlayerScanState>(client, fromTimestamp, toTimestamp, partitions, pageSize, sortOrder, ordered))
+    {
+    }
+
+    IVIPlayerScan::~IVIPlayerScan()
+    {
+        // The state may outlive this while a callback is running
+        m_state->Cancel();
+    }
+
+    void IVIPlayerScan::Start(const OnPage& onPage)
+    {
+        IVI_LOG_VERBOSE("IVIPlayerScan starting over ", m_state->PartitionCount(), " partitions");
+        m_state->Start(onPage);
+    }
+
+    IVIResult IVIPlayerScan::ForEachPlayer(IVIClientManagerAsync& manager, const function<void(const IVIPlayer&)>& visitor)
+    {
+        IVIResultStatus status(IVIResultStatus::SUCCESS);
+        Start([&status, &visitor](const IVIResultPlayerList& page, bool)
+            {
+                if (!page.Success())
+                {
+                    status = page.Status();
+                    return;
+                }
+                for (const IVIPlayer& player : page.Payload())
+                {
+                    visitor(player);
+                }
+            });
+
+        while (!Done())
+        {
+            if (!manager.Poll())
+            {
+                m_state->Cancel();
+                return { IVIResultStatus::UNAVAILABLE };
+            }
+        }
+        return { status };
+    }
+
+    bool IVIPlayerScan::Done() const
+    {
+        return m_state->Done();
+    }
+
+    size_t IVIPlayerScan::PartitionCount() const
+    {
+        return m_state->PartitionCount();
+    }
+} // namespace ivi
@@ -0,0 +1,559 @@
+#include "ivi/ivi-snapshot.h"
+#include "ivi/ivi-util.h"
+
+#include "ivi/generated/api/item/definition.pb.h"
+#include "ivi/generated/api/itemtype/definition.pb.h"
+#include "ivi/generated/api/player/definition.pb.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ivi
+{
+    //////////////////////////////////////////////////////////////////////////
+    // IVIMappedFile
+    //////////////////////////////////////////////////////////////////////////
+
+    IVIMappedFile::IVIMappedFile()
+        : m_data(nullptr)
+        , m_size(0)
+    {
+    }
+
+    IVIMappedFile::~IVIMappedFile()
+    {
+        Close();
+    }
+
+    bool IVIMappedFile::Open(const string& path)
+    {
+        Close();
+
+#ifdef _WIN32
+        HANDLE file(CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr));
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+        {
+            CloseHandle(file);
+            return false;
+        }
+
+        // The view keeps the mapping alive, neither handle is needed once it exists
+        HANDLE mapping(CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr));
+        CloseHandle(file);
+        if (mapping == nullptr)
+        {
+            return false;
+        }
+
+        const void* data(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        CloseHandle(mapping);
+        if (data == nullptr)
+        {
+            return false;
+        }
+
+        m_data = static_cast<const char*>(data);
+        m_size = static_cast<size_t>(fileSize.QuadPart);
+#else
+        const int fd(open(path.c_str(), O_RDONLY));
+        if (fd < 0)
+        {
+            return false;
+        }
+
+        struct stat fileStat;
+        if (fstat(fd, &fileStat) != 0 || fileStat.st_size <= 0)
+        {
+            close(fd);
+            return false;
+        }
+
+        // The mapping outlives the descriptor
+        void* data(mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, fd, 0));
+        close(fd);
+        if (data == MAP_FAILED)
+        {
+            return false;
+        }
+
+        m_data = static_cast<const char*>(data);
+        m_size = static_cast<size_t>(fileStat.st_size);
+#endif
+        return true;
+    }
+
+    void IVIMappedFile::Close()
+    {
+        if (m_data == nullptr)
+        {
+            return;
+        }
+
+#ifdef _WIN32
+        UnmapViewOfFile(m_data);
+#else
+        munmap(const_cast<char*>(m_data), m_size);
+#endif
+        m_data = nullptr;
+        m_size = 0;
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // Snapshot file layout, all integers in host byte order:
+    //   FileHeader
+    //   SectionHeader[sectionCount]
+    //   per section: IndexEntry[count] sorted by keyHash, then the serialized records
+    //////////////////////////////////////////////////////////////////////////
+
+    static const char       SnapshotMagic[8] = { 'I', 'V', 'I', 'S', 'N', 'A', 'P', '\0' };
+    static const uint32_t   SnapshotVersion = 1;
+    static const uint32_t   SnapshotByteOrder = 0x01020304;
+
+    struct SnapshotFileHeader
+    {
+        char                magic[8];
+        uint32_t            version;
+        uint32_t            byteOrder;
+        int64_t             createdTimestamp;
+        uint32_t            sectionCount;
+        uint32_t            reserved;
+    };
+
+    struct SnapshotSectionHeader
+    {
+        uint32_t            section;
+        uint32_t            count;
+        uint64_t            indexOffset;
+        uint64_t            dataOffset;
+        uint64_t            dataSize;
+    };
+
+    struct SnapshotIndexEntry
+    {
+        uint64_t            keyHash;
+        uint64_t            offset;     // from the start of the section data
+        uint32_t            size;
+        uint32_t            reserved;
+    };
+
+    static const IVISnapshotSection AllSections[] =
+    {
+        IVISnapshotSection::ITEM_TYPES,
+        IVISnapshotSection::PLAYERS,
+        IVISnapshotSection::ITEMS
+    };
+
+    // FNV-1a, std::hash is not guaranteed to be stable across builds
+    static uint64_t SnapshotKeyHash(const string& key)
+    {
+        uint64_t hash = 14695981039346656037ULL;
+        for (char c : key)
+        {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    static const string& SnapshotKey(const proto::api::itemtype::ItemType& itemType)   { return itemType.game_item_type_id(); }
+    static const string& SnapshotKey(const proto::api::player::IVIPlayer& player)       { return player.player_id(); }
+    static const string& SnapshotKey(const proto::api::item::Item& item)                { return item.game_inventory_id(); }
+
+    // Mapped memory carries no alignment guarantees, always copy out
+    template<typename T>
+    static T ReadAt(const char* data)
+    {
+        T value;
+        memcpy(&value, data, sizeof(T));
+        return value;
+    }
+
+    // Flushes the file to disk, so a crash after the rename cannot leave a truncated snapshot in place
+    static bool SyncFile(const string& path)
+    {
+#ifdef _WIN32
+        HANDLE file(CreateFileA(path.c_str(), GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr));
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+        const bool synced(FlushFileBuffers(file) != 0);
+        CloseHandle(file);
+#else
+        const int fd(open(path.c_str(), O_WRONLY));
+        if (fd < 0)
+        {
+            return false;
+        }
+        const bool synced(fsync(fd) == 0);
+        close(fd);
+#endif
+        return synced;
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // IVISnapshotWriter
+    //////////////////////////////////////////////////////////////////////////
+
+    IVISnapshotWriter::IVISnapshotWriter() {}
+    IVISnapshotWriter::~IVISnapshotWriter() {}
+
+    void IVISnapshotWriter::Add(const IVIItemType& itemType)
+    {
+        m_itemTypes.push_back({ SnapshotKeyHash(itemType.gameItemTypeId), itemType.ToProto().SerializeAsString() });
+    }
+
+    void IVISnapshotWriter::Add(const IVIPlayer& player)
+    {
+        m_players.push_back({ SnapshotKeyHash(player.playerId), player.ToProto().SerializeAsString() });
+    }
+
+    void IVISnapshotWriter::Add(const IVIItem& item)
+    {
+        m_items.push_back({ SnapshotKeyHash(item.gameInventoryId), item.ToProto().SerializeAsString() });
+    }
+
+    void IVISnapshotWriter::Add(const IVIItemTypeCache& cache)
+    {
+        cache.ForEach([this](const IVIItemType& itemType) { Add(itemType); });
+    }
+
+    void IVISnapshotWriter::Add(const IVIPlayerCache& cache)
+    {
+        cache.ForEach([this](const IVIPlayer& player) { Add(player); });
+    }
+
+    void IVISnapshotWriter::Add(const IVIItemCache& cache)
+    {
+        cache.ForEach([this](const IVIItem& item) { Add(item); });
+    }
+
+    bool IVISnapshotWriter::Write(const string& path, time_t createdTimestamp) const
+    {
+        IVI_LOG_FUNC();
+
+        const RecordList* sections[] = { &m_itemTypes, &m_players, &m_items };
+        const uint32_t sectionCount(sizeof(sections) / sizeof(sections[0]));
+
+        SnapshotFileHeader fileHeader;
+        memset(&fileHeader, 0, sizeof(fileHeader));
+        memcpy(fileHeader.magic, SnapshotMagic, sizeof(SnapshotMagic));
+        fileHeader.version = SnapshotVersion;
+        fileHeader.byteOrder = SnapshotByteOrder;
+        fileHeader.createdTimestamp = createdTimestamp;
+        fileHeader.sectionCount = sectionCount;
+
+        // Lay out every section before writing anything
+        vector<SnapshotSectionHeader> sectionHeaders(sectionCount);
+        vector<vector<const Record*>> sortedRecords(sectionCount);
+        uint64_t offset(sizeof(SnapshotFileHeader) + sectionCount * sizeof(SnapshotSectionHeader));
+        for (uint32_t section = 0; section < sectionCount; ++section)
+        {
+            vector<const Record*>& sorted(sortedRecords[section]);
+            for (const Record& record : *sections[section])
+            {
+                sorted.push_back(&record);
+            }
+            std::stable_sort(sorted.begin(), sorted.end(),
+                [](const Record* lhs, const Record* rhs) { return lhs->keyHash < rhs->keyHash; });
+
+            SnapshotSectionHeader& header(sectionHeaders[section]);
+            header.section = static_cast<uint32_t>(AllSections[section]);
+            header.count = static_cast<uint32_t>(sorted.size());
+            header.indexOffset = offset;
+            header.dataOffset = offset + sorted.size() * sizeof(SnapshotIndexEntry);
+            header.dataSize = 0;
+            for (const Record* record : sorted)
+            {
+                header.dataSize += record->bytes.size();
+            }
+            offset = header.dataOffset + header.dataSize;
+        }
+
+        const string tempPath(path + ".tmp");
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            file.write(reinterpret_cast<const char*>(&fileHeader), sizeof(fileHeader));
+            file.write(reinterpret_cast<const char*>(sectionHeaders.data()), sectionHeaders.size() * sizeof(SnapshotSectionHeader));
+
+            for (uint32_t section = 0; section < sectionCount; ++section)
+            {
+                uint64_t dataOffset = 0;
+                for (const Record* record : sortedRecords[section])
+                {
+                    const SnapshotIndexEntry entry{ record->keyHash, dataOffset, static_cast<uint32_t>(record->bytes.size()), 0 };
+                    file.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+                    dataOffset += record->bytes.size();
+                }
+                for (const Record* record : sortedRecords[section])
+                {
+                    file.write(record->bytes.data(), record->bytes.size());
+                }
+            }
+
+            file.close();
+            if (!file || !SyncFile(tempPath))
+            {
+                IVI_LOG_WARNING("IVISnapshotWriter failed writing ", tempPath);
+                std::remove(tempPath.c_str());
+                return false;
+            }
+        }
+
+#ifdef _WIN32
+        const bool renamed(MoveFileExA(tempPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0);
+#else
+        const bool renamed(std::rename(tempPath.c_str(), path.c_str()) == 0);
+#endif
+        if (!renamed)
+        {
+            IVI_LOG_WARNING("IVISnapshotWriter failed replacing ", path);
+            std::remove(tempPath.c_str());
+            return false;
+        }
+
+        IVI_LOG_INFO("IVISnapshotWriter wrote ", path, " itemTypes=", m_itemTypes.size(), " players=", m_players.size(), " items=", m_items.size());
+        return true;
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // IVISnapshot
+    //////////////////////////////////////////////////////////////////////////
+
+    IVISnapshot::IVISnapshot()
+        : m_createdTimestamp(0)
+    {
+        memset(m_sections, 0, sizeof(m_sections));
+    }
+
+    IVISnapshot::~IVISnapshot() {}
+
+    /*static*/ unique_ptr<IVISnapshot> IVISnapshot::Open(const string& path)
+    {
+        IVI_LOG_FUNC();
+
+        unique_ptr<IVISnapshot> snapshot(new IVISnapshot());
+        if (!snapshot->m_file.Open(path))
+        {
+            IVI_LOG_INFO("IVISnapshot could not open ", path);
+            return nullptr;
+        }
+
+        const char* data(snapshot->m_file.Data());
+        const uint64_t size(snapshot->m_file.Size());
+
+        if (size < sizeof(SnapshotFileHeader))
+        {
+            IVI_LOG_WARNING("IVISnapshot truncated: ", path);
+            return nullptr;
+        }
+
+        const SnapshotFileHeader fileHeader(ReadAt<SnapshotFileHeader>(data));
+        if (memcmp(fileHeader.magic, SnapshotMagic, sizeof(SnapshotMagic)) != 0
+            || fileHeader.version != SnapshotVersion
+            || fileHeader.byteOrder != SnapshotByteOrder)
+        {
+            IVI_LOG_WARNING("IVISnapshot not a version ", SnapshotVersion, " snapshot: ", path);
+            return nullptr;
+        }
+
+        if (size < sizeof(SnapshotFileHeader) + uint64_t(fileHeader.sectionCount) * sizeof(SnapshotSectionHeader))
+        {
+            IVI_LOG_WARNING("IVISnapshot truncated: ", path);
+            return nullptr;
+        }
+
+        for (uint32_t section = 0; section < fileHeader.sectionCount; ++section)
+        {
+            const SnapshotSectionHeader header(ReadAt<SnapshotSectionHeader>(
+                data + sizeof(SnapshotFileHeader) + section * sizeof(SnapshotSectionHeader)));
+
+            // Checked without computing end offsets, which a corrupt header could make wrap around
+            if (header.section < 1 || header.section > 3
+                || header.indexOffset > size
+                || header.count > (size - header.indexOffset) / sizeof(SnapshotIndexEntry)
+                || header.dataOffset > size
+                || header.dataSize > size - header.dataOffset)
+            {
+                IVI_LOG_WARNING("IVISnapshot corrupt section ", header.section, ": ", path);
+                return nullptr;
+            }
+
+            SectionView& view(snapshot->m_sections[header.section - 1]);
+            view.index = data + header.indexOffset;
+            view.data = data + header.dataOffset;
+            view.count = header.count;
+
+            // Validated once here so lookups need not bounds check
+            for (uint32_t entry = 0; entry < header.count; ++entry)
+            {
+                const SnapshotIndexEntry indexEntry(ReadAt<SnapshotIndexEntry>(view.index + entry * sizeof(SnapshotIndexEntry)));
+                if (indexEntry.offset > header.dataSize || indexEntry.size > header.dataSize - indexEntry.offset)
+                {
+                    IVI_LOG_WARNING("IVISnapshot corrupt index in section ", header.section, ": ", path);
+                    return nullptr;
+                }
+            }
+        }
+
+        snapshot->m_createdTimestamp = static_cast<time_t>(fileHeader.createdTimestamp);
+        return snapshot;
+    }
+
+    time_t IVISnapshot::CreatedTimestamp() const
+    {
+        return m_createdTimestamp;
+    }
+
+    const IVISnapshot::SectionView& IVISnapshot::Section(IVISnapshotSection section) const
+    {
+        return m_sections[static_cast<uint32_t>(section) - 1];
+    }
+
+    size_t IVISnapshot::Count(IVISnapshotSection section) const
+    {
+        return Section(section).count;
+    }
+
+    template<typename TProto>
+    bool IVISnapshot::FindRecord(IVISnapshotSection section, const string& key, TProto& outProto) const
+    {
+        const SectionView& view(Section(section));
+        const uint64_t keyHash(SnapshotKeyHash(key));
+
+        // lower_bound over the mapped index
+        uint32_t first = 0, count = view.count;
+        while (count > 0)
+        {
+            const uint32_t step(count / 2);
+            if (ReadAt<SnapshotIndexEntry>(view.index + (first + step) * sizeof(SnapshotIndexEntry)).keyHash < keyHash)
+            {
+                first += step + 1;
+                count -= step + 1;
+            }
+            else
+            {
+                count = step;
+            }
+        }
+
+        for (; first < view.count; ++first)
+        {
+            const SnapshotIndexEntry entry(ReadAt<SnapshotIndexEntry>(view.index + first * sizeof(SnapshotIndexEntry)));
+            if (entry.keyHash != keyHash)
+            {
+                break;
+            }
+            if (outProto.ParseFromArray(view.data + entry.offset, static_cast<int>(entry.size)) && SnapshotKey(outProto) == key)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    template<typename TProto>
+    size_t IVISnapshot::ForEachRecord(IVISnapshotSection section, const function<void(const TProto&)>& visitor) const
+    {
+        const SectionView& view(Section(section));
+        TProto record;
+        size_t parsed = 0;
+        for (uint32_t index = 0; index < view.count; ++index)
+        {
+            const SnapshotIndexEntry entry(ReadAt<SnapshotIndexEntry>(view.index + index * sizeof(SnapshotIndexEntry)));
+            if (record.ParseFromArray(view.data + entry.offset, static_cast<int>(entry.size)))
+            {
+                visitor(record);
+                ++parsed;
+            }
+            else
+            {
+                IVI_LOG_WARNING("IVISnapshot skipping unparseable record in section ", static_cast<uint32_t>(section));
+            }
+        }
+        return parsed;
+    }
+
+    bool IVISnapshot::FindItemType(const string& gameItemTypeId, IVIItemType& outItemType) const
+    {
+        proto::api::itemtype::ItemType itemType;
+        if (!FindRecord(IVISnapshotSection::ITEM_TYPES, gameItemTypeId, itemType))
+        {
+            return false;
+        }
+        outItemType = IVIItemType::FromProto(itemType);
+        return true;
+    }
+
+    bool IVISnapshot::FindPlayer(const string& playerId, IVIPlayer& outPlayer) const
+    {
+        proto::api::player::IVIPlayer player;
+        if (!FindRecord(IVISnapshotSection::PLAYERS, playerId, player))
+        {
+            return false;
+        }
+        outPlayer = IVIPlayer::FromProto(player);
+        return true;
+    }
+
+    bool IVISnapshot::FindItem(const string& gameInventoryId, IVIItem& outItem) const
+    {
+        proto::api::item::Item item;
+        if (!FindRecord(IVISnapshotSection::ITEMS, gameInventoryId, item))
+        {
+            return false;
+        }
+        outItem = IVIItem::FromProto(item);
+        return true;
+    }
+
+    size_t IVISnapshot::LoadInto(IVIItemTypeCache& cache) const
+    {
+        IVIItemTypeList itemTypes;
+        ForEachRecord<proto::api::itemtype::ItemType>(IVISnapshotSection::ITEM_TYPES,
+            [&itemTypes](const proto::api::itemtype::ItemType& itemType) { itemTypes.push_back(IVIItemType::FromProto(itemType)); });
+        cache.Seed(itemTypes);
+        return itemTypes.size();
+    }
+
+    size_t IVISnapshot::LoadInto(IVIPlayerCache& cache) const
+    {
+        return ForEachRecord<proto::api::player::IVIPlayer>(IVISnapshotSection::PLAYERS,
+            [&cache](const proto::api::player::IVIPlayer& player) { cache.Put(IVIPlayer::FromProto(player)); });
+    }
+
+    size_t IVISnapshot::LoadInto(IVIItemCache& cache) const
+    {
+        return ForEachRecord<proto::api::item::Item>(IVISnapshotSection::ITEMS,
+            [&cache](const proto::api::item::Item& item) { cache.Put(IVIItem::FromProto(item)); });
+    }
+
+    size_t IVISnapshot::ForEachItem(const function<void(const IVIItem&)>& visitor) const
+    {
+        return ForEachRecord<proto::api::item::Item>(IVISnapshotSection::ITEMS,
+            [&visitor](const proto::api::item::Item& item) { visitor(IVIItem::FromProto(item)); });
+    }
+} // namespace ivi
@@ -0,0 +1,243 @@
+#include "ivi/ivi-table.h"
+#include "ivi/ivi-util.h"
+
+#include "ivi/generated/api/item/definition.pb.h"
+
+namespace ivi
+{
+    //////////////////////////////////////////////////////////////////////////
+    // IVIDictionaryColumn
+    //////////////////////////////////////////////////////////////////////////
+
+    IVIDictionaryColumn::Code IVIDictionaryColumn::Append(const string& value)
+    {
+        const auto inserted(m_index.emplace(value, static_cast<Code>(m_values.size())));
+        if (inserted.second)
+        {
+            m_values.push_back(value);
+        }
+        m_codes.push_back(inserted.first->second);
+        return inserted.first->second;
+    }
+
+    void IVIDictionaryColumn::Append(const IVIDictionaryColumn& other)
+    {
+        vector<Code> remap;
+        remap.reserve(other.m_values.size());
+        for (const string& value : other.m_values)
+        {
+            const auto inserted(m_index.emplace(value, static_cast<Code>(m_values.size())));
+            if (inserted.second)
+            {
+                m_values.push_back(value);
+            }
+            remap.push_back(inserted.first->second);
+        }
+
+        m_codes.reserve(m_codes.size() + other.m_codes.size());
+        for (const Code code : other.m_codes)
+        {
+            m_codes.push_back(remap[code]);
+        }
+    }
+
+    bool IVIDictionaryColumn::Find(const string& value, Code& outCode) const
+    {
+        const auto found(m_index.find(value));
+        if (found == m_index.end())
+        {
+            return false;
+        }
+        outCode = found->second;
+        return true;
+    }
+
+    void IVIDictionaryColumn::clear()
+    {
+        m_codes.clear();
+        m_values.clear();
+        m_index.clear();
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // IVIItemTable
+    //////////////////////////////////////////////////////////////////////////
+
+    void IVIItemTable::Append(const proto::api::item::Item& item)
+    {
+        const proto::common::Metadata& metadata(item.metadata());
+        m_gameInventoryId.push_back(item.game_inventory_id());
+        m_gameItemTypeId.Append(item.game_item_type_id());
+        m_dgoodsId.push_back(item.dgoods_id());
+        m_itemName.Append(item.item_name());
+        m_playerId.push_back(item.player_id());
+        m_ownerSidechainAccount.Append(item.owner_sidechain_account());
+        m_serialNumber.push_back(item.serial_number());
+        m_currencyBase.Append(item.currency_base());
+        m_metadataUri.push_back(item.metadata_uri());
+        m_trackingId.push_back(item.tracking_id());
+        m_metadataName.push_back(metadata.name());
+        m_metadataDescription.push_back(metadata.description());
+        m_metadataImage.Append(metadata.image());
+        m_metadataProperties.push_back(MetadataPropertiesFromStruct(metadata.properties()));
+        m_createdTimestamp.push_back(item.created_timestamp());
+        m_updatedTimestamp.push_back(item.updated_timestamp());
+        m_itemState.push_back(ECast(item.item_state()));
+    }
+
+    void IVIItemTable::Append(proto::api::item::Item&& item)
+    {
+        proto::common::Metadata& metadata(*item.mutable_metadata());
+        m_gameInventoryId.push_back(IVI_TAKE_STRING(item, game_inventory_id));
+        m_gameItemTypeId.Append(item.game_item_type_id());
+        m_dgoodsId.push_back(item.dgoods_id());
+        m_itemName.Append(item.item_name());
+        m_playerId.push_back(IVI_TAKE_STRING(item, player_id));
+        m_ownerSidechainAccount.Append(item.owner_sidechain_account());
+        m_serialNumber.push_back(item.serial_number());
+        m_currencyBase.Append(item.currency_base());
+        m_metadataUri.push_back(IVI_TAKE_STRING(item, metadata_uri));
+        m_trackingId.push_back(IVI_TAKE_STRING(item, tracking_id));
+        m_metadataName.push_back(IVI_TAKE_STRING(metadata, name));
+        m_metadataDescription.push_back(IVI_TAKE_STRING(metadata, description));
+        m_metadataImage.Append(metadata.image());
+        m_metadataProperties.push_back(MetadataPropertiesFromStruct(move(*metadata.mutable_properties())));
+        m_createdTimestamp.push_back(item.created_timestamp());
+        m_updatedTimestamp.push_back(item.updated_timestamp());
+        m_itemState.push_back(ECast(item.item_state()));
+    }
+
+    void IVIItemTable::Append(const IVIItem& item)
+    {
+        m_gameInventoryId.push_back(item.gameInventoryId);
+        m_gameItemTypeId.Append(item.gameItemTypeId);
+        m_dgoodsId.push_back(item.dgoodsId);
+        m_itemName.Append(item.itemName);
+        m_playerId.push_back(item.playerId);
+        m_ownerSidechainAccount.Append(item.ownerSidechainAccount);
+        m_serialNumber.push_back(item.serialNumber);
+        m_currencyBase.Append(item.currencyBase);
+        m_metadataUri.push_back(item.metadataUri);
+        m_trackingId.push_back(item.trackingId);
+        m_metadataName.push_back(item.metadata.name);
+        m_metadataDescription.push_back(item.metadata.description);
+        m_metadataImage.Append(item.metadata.image);
+        m_metadataProperties.push_back(item.metadata.properties);
+        m_createdTimestamp.push_back(item.createdTimestamp);
+        m_updatedTimestamp.push_back(item.updatedTimestamp);
+        m_itemState.push_back(item.itemState);
+    }
+
+    template<typename T>
+    static void AppendColumn(vector<T>& column, const vector<T>& other)
+    {
+        column.insert(column.end(), other.begin(), other.end());
+    }
+
+    void IVIItemTable::Append(const IVIItemTable& other)
+    {
+        AppendColumn(m_gameInventoryId, other.m_gameInventoryId);
+        m_gameItemTypeId.Append(other.m_gameItemTypeId);
+        AppendColumn(m_dgoodsId, other.m_dgoodsId);
+        m_itemName.Append(other.m_itemName);
+        AppendColumn(m_playerId, other.m_playerId);
+        m_ownerSidechainAccount.Append(other.m_ownerSidechainAccount);
+        AppendColumn(m_serialNumber, other.m_serialNumber);
+        m_currencyBase.Append(other.m_currencyBase);
+        AppendColumn(m_metadataUri, other.m_metadataUri);
+        AppendColumn(m_trackingId, other.m_trackingId);
+        AppendColumn(m_metadataName, other.m_metadataName);
+        AppendColumn(m_metadataDescription, other.m_metadataDescription);
+        m_metadataImage.Append(other.m_metadataImage);
+        AppendColumn(m_metadataProperties, other.m_metadataProperties);
+        AppendColumn(m_createdTimestamp, other.m_createdTimestamp);
+        AppendColumn(m_updatedTimestamp, other.m_updatedTimestamp);
+        AppendColumn(m_itemState, other.m_itemState);
+    }
+
+    void IVIItemTable::AppendRow(const IVIItemTable& other, size_t row)
+    {
+        IVI_CHECK(row < other.size());
+        m_gameInventoryId.push_back(other.m_gameInventoryId[row]);
+        m_gameItemTypeId.Append(other.m_gameItemTypeId[row]);
+        m_dgoodsId.push_back(other.m_dgoodsId[row]);
+        m_itemName.Append(other.m_itemName[row]);
+        m_playerId.push_back(other.m_playerId[row]);
+        m_ownerSidechainAccount.Append(other.m_ownerSidechainAccount[row]);
+        m_serialNumber.push_back(other.m_serialNumber[row]);
+        m_currencyBase.Append(other.m_currencyBase[row]);
+        m_metadataUri.push_back(other.m_metadataUri[row]);
+        m_trackingId.push_back(other.m_trackingId[row]);
+        m_metadataName.push_back(other.m_metadataName[row]);
+        m_metadataDescription.push_back(other.m_metadataDescription[row]);
+        m_metadataImage.Append(other.m_metadataImage[row]);
+        m_metadataProperties.push_back(other.m_metadataProperties[row]);
+        m_createdTimestamp.push_back(other.m_createdTimestamp[row]);
+        m_updatedTimestamp.push_back(other.m_updatedTimestamp[row]);
+        m_itemState.push_back(other.m_itemState[row]);
+    }
+
+    IVIItem IVIItemTable::Row(size_t row) const
+    {
+        IVI_CHECK(row < size());
+        return
+        {
+             m_gameInventoryId[row]
+            ,m_gameItemTypeId[row]
+            ,m_dgoodsId[row]
+            ,m_itemName[row]
+            ,m_playerId[row]
+            ,m_ownerSidechainAccount[row]
+            ,m_serialNumber[row]
+            ,m_currencyBase[row]
+            ,m_metadataUri[row]
+            ,m_trackingId[row]
+            ,IVIMetadata{ m_metadataName[row], m_metadataDescription[row], m_metadataImage[row], m_metadataProperties[row] }
+            ,m_createdTimestamp[row]
+            ,m_updatedTimestamp[row]
+            ,m_itemState[row]
+        };
+    }
+
+    void IVIItemTable::reserve(size_t rows)
+    {
+        m_gameInventoryId.reserve(rows);
+        m_gameItemTypeId.reserve(rows);
+        m_dgoodsId.reserve(rows);
+        m_itemName.reserve(rows);
+        m_playerId.reserve(rows);
+        m_ownerSidechainAccount.reserve(rows);
+        m_serialNumber.reserve(rows);
+        m_currencyBase.reserve(rows);
+        m_metadataUri.reserve(rows);
+        m_trackingId.reserve(rows);
+        m_metadataName.reserve(rows);
+        m_metadataDescription.reserve(rows);
+        m_metadataImage.reserve(rows);
+        m_metadataProperties.reserve(rows);
+        m_createdTimestamp.reserve(rows);
+        m_updatedTimestamp.reserve(rows);
+        m_itemState.reserve(rows);
+    }
+
+    void IVIItemTable::clear()
+    {
+        m_gameInventoryId.clear();
+        m_gameItemTypeId.clear();
+        m_dgoodsId.clear();
+        m_itemName.clear();
+        m_playerId.clear();
+        m_ownerSidechainAccount.clear();
+        m_serialNumber.clear();
+        m_currencyBase.clear();
+        m_metadataUri.clear();
+        m_trackingId.clear();
+        m_metadataName.clear();
+        m_metadataDescription.clear();
+        m_metadataImage.clear();
+        m_metadataProperties.clear();
+        m_createdTimestamp.clear();
+        m_updatedTimestamp.clear();
+        m_itemState.clear();
+    }
+} // namespace ivi
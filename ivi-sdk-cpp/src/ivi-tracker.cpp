@@ -0,0 +1,573 @@
+#include "ivi/ivi-tracker.h"
+#include "ivi/ivi-util.h"
+
+namespace ivi
+{
+    //////////////////////////////////////////////////////////////////////////
+    // IVIOrderTracker
+    //////////////////////////////////////////////////////////////////////////
+
+    constexpr uint32_t IVIOrderTracker::DefaultFinalStateTtlMs;
+    constexpr size_t IVIOrderTracker::DefaultMaxFinalStates;
+
+    IVIOrderTracker::IVIOrderTracker(uint32_t finalStateTtlMs, size_t maxFinalStates)
+        : m_finalStateTtl(finalStateTtlMs)
+        , m_maxFinalStates(maxFinalStates)
+        , m_waiterCount(0)
+    {
+        IVI_CHECK(m_maxFinalStates > 0);
+    }
+
+    IVIOrderTracker::~IVIOrderTracker() {}
+
+    /*static*/ bool IVIOrderTracker::IsFinalState(OrderState state)
+    {
+        switch (state)
+        {
+        case OrderState::COMPLETE:
+        case OrderState::DECLINED:
+        case OrderState::FAILED:
+        case OrderState::EXPIRED:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    void IVIOrderTracker::Track(const IVIOrder& order)
+    {
+        SetState(order.orderId, order.orderStatus);
+    }
+
+    void IVIOrderTracker::ApplyUpdate(const IVIOrderStatusUpdate& update)
+    {
+        SetState(update.orderId, update.orderState);
+    }
+
+    void IVIOrderTracker::SetState(const string& orderId, OrderState state)
+    {
+        IVI_LOG_VERBOSE("IVIOrderTracker orderId=", orderId, " state=", static_cast<int32_t>(state));
+
+        vector<Notification> notifications;
+        {
+            const bool finalState(IsFinalState(state));
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto known(m_states.find(orderId));
+            if (known == m_states.end())
+            {
+                known = m_states.emplace(orderId, State{ state, false, m_finalStates.end() }).first;
+            }
+            else if (known->second.final)
+            {
+                m_finalStates.erase(known->second.finalState);
+                known->second.final = false;
+            }
+            known->second.state = state;
+
+            // Final states have no waiters left once notified below, they are only kept to answer late WaitFor calls
+            if (finalState)
+            {
+                if (m_finalStates.size() >= m_maxFinalStates)
+                {
+                    EraseStateLocked(m_states.find(m_finalStates.front().orderId));
+                }
+                known->second.final = true;
+                known->second.finalState = m_finalStates.insert(m_finalStates.end(), { orderId, Clock::now() + m_finalStateTtl });
+            }
+
+            auto waiters(m_waiters.find(orderId));
+            if (waiters == m_waiters.end())
+            {
+                return;
+            }
+
+            WaiterList& orderWaiters(waiters->second);
+            for (auto waiter(orderWaiters.begin()); waiter != orderWaiters.end(); )
+            {
+                if ((*waiter)->targetState == state)
+                {
+                    notifications.push_back({ *waiter, { IVIResultStatus::SUCCESS, state } });
+                }
+                else if (finalState)
+                {
+                    notifications.push_back({ *waiter, { IVIResultStatus::ABORTED, state } });
+                }
+                else
+                {
+                    ++waiter;
+                    continue;
+                }
+
+                // its deadline entry is skipped once done
+                (*waiter)->done = true;
+                --m_waiterCount;
+                waiter = orderWaiters.erase(waiter);
+            }
+
+            if (orderWaiters.empty())
+            {
+                m_waiters.erase(waiters);
+            }
+        }
+
+        Notify(notifications);
+    }
+
+    OnOrderUpdated IVIOrderTracker::Hook(const OnOrderUpdated& next)
+    {
+        return [this, next](const IVIOrderStatusUpdate& update)
+        {
+            ApplyUpdate(update);
+            if (next)
+            {
+                next(update);
+            }
+        };
+    }
+
+    void IVIOrderTracker::WaitFor(
+        const string& orderId,
+        OrderState targetState,
+        uint32_t timeoutMs,
+        const OnOrderState& callback)
+    {
+        IVI_CHECK(callback);
+
+        OrderState state;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto knownState(m_states.find(orderId));
+            if (knownState == m_states.end() || (knownState->second.state != targetState && !knownState->second.final))
+            {
+                WaiterPtr waiter(make_shared<Waiter>(Waiter{ orderId, targetState, callback, false }));
+                m_waiters[orderId].push_back(waiter);
+                m_deadlines.insert({ Clock::now() + std::chrono::milliseconds(timeoutMs), waiter });
+                ++m_waiterCount;
+                return;
+            }
+            state = knownState->second.state;
+        }
+
+        // Already settled, a final state can no longer change so there is nothing to wait for
+        callback({ state == targetState ? IVIResultStatus::SUCCESS : IVIResultStatus::ABORTED, state });
+    }
+
+    size_t IVIOrderTracker::ProcessTimeouts(Clock::time_point now)
+    {
+        vector<Notification> notifications;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto expired(m_deadlines.upper_bound(now));
+            for (auto deadline(m_deadlines.begin()); deadline != expired; ++deadline)
+            {
+                const WaiterPtr& waiter(deadline->second);
+                if (waiter->done)
+                {
+                    continue;
+                }
+
+                waiter->done = true;
+                --m_waiterCount;
+
+                auto state(m_states.find(waiter->orderId));
+                notifications.push_back({ waiter, { IVIResultStatus::TIMEOUT, state != m_states.end() ? state->second.state : OrderState() } });
+
+                auto waiters(m_waiters.find(waiter->orderId));
+                if (waiters != m_waiters.end())
+                {
+                    waiters->second.remove(waiter);
+                    if (waiters->second.empty())
+                    {
+                        m_waiters.erase(waiters);
+                    }
+                }
+            }
+            m_deadlines.erase(m_deadlines.begin(), expired);
+
+            while (!m_finalStates.empty() && m_finalStates.front().expires <= now)
+            {
+                EraseStateLocked(m_states.find(m_finalStates.front().orderId));
+            }
+        }
+
+        Notify(notifications);
+        return notifications.size();
+    }
+
+    void IVIOrderTracker::Forget(const string& orderId)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto state(m_states.find(orderId));
+        if (state != m_states.end())
+        {
+            EraseStateLocked(state);
+        }
+    }
+
+    void IVIOrderTracker::EraseStateLocked(StateMap::iterator state)
+    {
+        if (state->second.final)
+        {
+            m_finalStates.erase(state->second.finalState);
+        }
+        m_states.erase(state);
+    }
+
+    bool IVIOrderTracker::GetState(const string& orderId, OrderState& outState) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto state(m_states.find(orderId));
+        if (state == m_states.end())
+        {
+            return false;
+        }
+        outState = state->second.state;
+        return true;
+    }
+
+    size_t IVIOrderTracker::WaiterCount() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_waiterCount;
+    }
+
+    /*static*/ void IVIOrderTracker::Notify(const vector<Notification>& notifications)
+    {
+        for (const Notification& notification : notifications)
+        {
+            notification.first->callback(notification.second);
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // IVIItemTracker
+    //////////////////////////////////////////////////////////////////////////
+
+    constexpr uint32_t IVIItemTracker::NoEntry;
+    constexpr uint32_t IVIItemTracker::TombstoneEntry;
+
+    IVIItemTracker::IVIItemTracker(uint32_t maxTracked, uint32_t maxBuffered, uint32_t expiryMs)
+        : m_maxTracked(maxTracked)
+        , m_maxBuffered(maxBuffered)
+        , m_expiry(expiryMs)
+        , m_tombstones(0)
+        , m_tracked{ NoEntry, NoEntry, 0 }
+        , m_buffered{ NoEntry, NoEntry, 0 }
+    {
+        IVI_CHECK(m_maxTracked > 0);
+
+        const uint32_t poolSize(m_maxTracked + m_maxBuffered);
+        m_entries.resize(poolSize);
+        m_freeEntries.reserve(poolSize);
+        for (uint32_t entry = poolSize; entry > 0; --entry)
+        {
+            m_freeEntries.push_back(entry - 1);
+        }
+
+        // At most half full, keeps linear probe sequences short
+        size_t slotCount = 8;
+        while (slotCount < size_t(poolSize) * 2)
+        {
+            slotCount <<= 1;
+        }
+        m_slots.assign(slotCount, Slot{ 0, NoEntry });
+    }
+
+    IVIItemTracker::~IVIItemTracker() {}
+
+    /*static*/ bool IVIItemTracker::IsFinalState(ItemState state)
+    {
+        switch (state)
+        {
+        case ItemState::PENDING_ISSUED:
+        case ItemState::PENDING_LISTED:
+        case ItemState::PENDING_TRANSFERRED:
+        case ItemState::PENDING_SALE:
+        case ItemState::PENDING_BURNED:
+        case ItemState::PENDING_CLOSE_LISTING:
+            return false;
+        default:
+            return true;
+        }
+    }
+
+    void IVIItemTracker::Track(const string& trackingId, const OnCompleted& onCompleted)
+    {
+        IVI_CHECK(onCompleted);
+
+        const size_t hash(std::hash<string>()(trackingId));
+        vector<Completion> completions;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            const uint32_t entry(FindLocked(trackingId, hash));
+            if (entry != NoEntry)
+            {
+                Entry& existing(m_entries[entry]);
+                if (existing.onCompleted)
+                {
+                    // Tracked twice, both complete together
+                    OnCompleted first(move(existing.onCompleted));
+                    existing.onCompleted = [first, onCompleted](const IVIResultItemStatusUpdate& result)
+                    {
+                        first(result);
+                        onCompleted(result);
+                    };
+                }
+                else
+                {
+                    completions.push_back({ onCompleted, { IVIResultStatus::SUCCESS, existing.update } });
+                    EraseLocked(entry, m_buffered);
+                }
+            }
+            else if (m_tracked.count >= m_maxTracked)
+            {
+                IVI_LOG_WARNING("IVIItemTracker full, not tracking trackingId=", trackingId);
+                completions.push_back({ onCompleted, { IVIResultStatus::RESOURCE_EXHAUSTED } });
+            }
+            else
+            {
+                m_entries[InsertLocked(trackingId, hash, m_tracked)].onCompleted = onCompleted;
+            }
+        }
+
+        Complete(completions);
+    }
+
+    std::future<IVIResultItemStatusUpdate> IVIItemTracker::Await(const string& trackingId)
+    {
+        shared_ptr<std::promise<IVIResultItemStatusUpdate>> promise(make_shared<std::promise<IVIResultItemStatusUpdate>>());
+        std::future<IVIResultItemStatusUpdate> future(promise->get_future());
+        Track(trackingId, [promise](const IVIResultItemStatusUpdate& result) { promise->set_value(result); });
+        return future;
+    }
+
+    IVIItemTracker::OnStateChange IVIItemTracker::TrackOnSuccess(const OnCompleted& onCompleted)
+    {
+        return [this, onCompleted](const IVIResultItemStateChange& result)
+        {
+            if (result.Success())
+            {
+                Track(result.Payload().trackingId, onCompleted);
+            }
+            else
+            {
+                onCompleted({ result.Status() });
+            }
+        };
+    }
+
+    void IVIItemTracker::ApplyUpdate(const IVIItemStatusUpdate& update)
+    {
+        if (!IsFinalState(update.itemState) || update.trackingId.empty())
+        {
+            return;
+        }
+
+        const size_t hash(std::hash<string>()(update.trackingId));
+        vector<Completion> completions;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            const uint32_t entry(FindLocked(update.trackingId, hash));
+            if (entry != NoEntry)
+            {
+                Entry& existing(m_entries[entry]);
+                if (existing.onCompleted)
+                {
+                    completions.push_back({ move(existing.onCompleted), { IVIResultStatus::SUCCESS, update } });
+                    EraseLocked(entry, m_tracked);
+                }
+                else
+                {
+                    existing.update = update;
+                }
+            }
+            else if (m_maxBuffered > 0)
+            {
+                if (m_buffered.count >= m_maxBuffered)
+                {
+                    EraseLocked(m_buffered.head, m_buffered);
+                }
+                m_entries[InsertLocked(update.trackingId, hash, m_buffered)].update = update;
+            }
+        }
+
+        Complete(completions);
+    }
+
+    OnItemUpdated IVIItemTracker::Hook(const OnItemUpdated& next)
+    {
+        return [this, next](const IVIItemStatusUpdate& update)
+        {
+            ApplyUpdate(update);
+            if (next)
+            {
+                next(update);
+            }
+        };
+    }
+
+    size_t IVIItemTracker::ProcessTimeouts(Clock::time_point now)
+    {
+        vector<Completion> completions;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            // Deadlines are insertion time + a fixed expiry, so each age list is also deadline ordered
+            while (m_tracked.head != NoEntry && m_entries[m_tracked.head].deadline <= now)
+            {
+                Entry& expired(m_entries[m_tracked.head]);
+                IVI_LOG_VERBOSE("IVIItemTracker timed out trackingId=", expired.trackingId);
+                completions.push_back({ move(expired.onCompleted), { IVIResultStatus::TIMEOUT } });
+                EraseLocked(m_tracked.head, m_tracked);
+            }
+
+            while (m_buffered.head != NoEntry && m_entries[m_buffered.head].deadline <= now)
+            {
+                EraseLocked(m_buffered.head, m_buffered);
+            }
+        }
+
+        Complete(completions);
+        return completions.size();
+    }
+
+    size_t IVIItemTracker::TrackedCount() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_tracked.count;
+    }
+
+    size_t IVIItemTracker::BufferedCount() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_buffered.count;
+    }
+
+    uint32_t IVIItemTracker::FindLocked(const string& trackingId, size_t hash) const
+    {
+        const size_t mask(m_slots.size() - 1);
+        const uint32_t hashTag(static_cast<uint32_t>(hash));
+        for (size_t slot = hash & mask; ; slot = (slot + 1) & mask)
+        {
+            const Slot& probe(m_slots[slot]);
+            if (probe.entry == NoEntry)
+            {
+                return NoEntry;
+            }
+            if (probe.entry != TombstoneEntry && probe.hashTag == hashTag && m_entries[probe.entry].trackingId == trackingId)
+            {
+                return probe.entry;
+            }
+        }
+    }
+
+    uint32_t IVIItemTracker::InsertLocked(const string& trackingId, size_t hash, AgeList& ageList)
+    {
+        const uint32_t entry(m_freeEntries.back());
+        m_freeEntries.pop_back();
+
+        Entry& inserted(m_entries[entry]);
+        inserted.trackingId = trackingId;
+        inserted.hash = hash;
+        inserted.deadline = Clock::now() + m_expiry;
+        inserted.prev = ageList.tail;
+        inserted.next = NoEntry;
+        if (ageList.tail != NoEntry)
+        {
+            m_entries[ageList.tail].next = entry;
+        }
+        else
+        {
+            ageList.head = entry;
+        }
+        ageList.tail = entry;
+        ++ageList.count;
+
+        const size_t mask(m_slots.size() - 1);
+        for (size_t slot = hash & mask; ; slot = (slot + 1) & mask)
+        {
+            Slot& probe(m_slots[slot]);
+            if (probe.entry == NoEntry || probe.entry == TombstoneEntry)
+            {
+                if (probe.entry == TombstoneEntry)
+                {
+                    --m_tombstones;
+                }
+                probe = { static_cast<uint32_t>(hash), entry };
+                return entry;
+            }
+        }
+    }
+
+    void IVIItemTracker::EraseLocked(uint32_t entry, AgeList& ageList)
+    {
+        Entry& erased(m_entries[entry]);
+
+        const size_t mask(m_slots.size() - 1);
+        for (size_t slot = erased.hash & mask; ; slot = (slot + 1) & mask)
+        {
+            if (m_slots[slot].entry == entry)
+            {
+                m_slots[slot].entry = TombstoneEntry;
+                ++m_tombstones;
+                break;
+            }
+        }
+
+        if (erased.prev != NoEntry)
+        {
+            m_entries[erased.prev].next = erased.next;
+        }
+        else
+        {
+            ageList.head = erased.next;
+        }
+        if (erased.next != NoEntry)
+        {
+            m_entries[erased.next].prev = erased.prev;
+        }
+        else
+        {
+            ageList.tail = erased.prev;
+        }
+        --ageList.count;
+
+        // Keeps the string capacity for reuse, releases whatever the callback captured
+        erased.trackingId.clear();
+        erased.onCompleted = nullptr;
+        m_freeEntries.push_back(entry);
+
+        if (m_tombstones > m_slots.size() / 4)
+        {
+            RebuildIndexLocked();
+        }
+    }
+
+    void IVIItemTracker::RebuildIndexLocked()
+    {
+        m_slots.assign(m_slots.size(), Slot{ 0, NoEntry });
+        m_tombstones = 0;
+
+        const size_t mask(m_slots.size() - 1);
+        for (const AgeList* ageList : { &m_tracked, &m_buffered })
+        {
+            for (uint32_t entry = ageList->head; entry != NoEntry; entry = m_entries[entry].next)
+            {
+                size_t slot(m_entries[entry].hash & mask);
+                while (m_slots[slot].entry != NoEntry)
+                {
+                    slot = (slot + 1) & mask;
+                }
+                m_slots[slot] = { static_cast<uint32_t>(m_entries[entry].hash), entry };
+            }
+        }
+    }
+
+    /*static*/ void IVIItemTracker::Complete(vector<Completion>& completions)
+    {
+        for (Completion& completion : completions)
+        {
+            completion.first(completion.second);
+        }
+    }
+} // namespace ivi
@@ -1,14 +1,26 @@
 #include <atomic>
 #include <chrono>
+#include <cstdio>
+#include <fstream>
 #include <map>
+#include <mutex>
 #include <random>
+#include <set>
 #include <sstream>
 #include <thread>
 #include <type_traits>
 
+#include "ivi/ivi-binary.h"
+#include "ivi/ivi-cache.h"
 #include "ivi/ivi-client-mgr.h"
 #include "ivi/ivi-config.h"
+#include "ivi/ivi-export.h"
+#include "ivi/ivi-json.h"
 #include "ivi/ivi-model.h"
+#include "ivi/ivi-paging.h"
+#include "ivi/ivi-snapshot.h"
+#include "ivi/ivi-table.h"
+#include "ivi/ivi-tracker.h"
 #include "ivi/ivi-types.h"
 #include "ivi/ivi-util.h"
 
@@ -26,6 +38,8 @@
 #include "ivi/generated/streams/order/stream.grpc.pb.h"
 #include "ivi/generated/streams/player/stream.grpc.pb.h"
 
+#include "google/protobuf/util/json_util.h"
+#include "google/protobuf/util/message_differencer.h"
 #include "grpcpp/grpcpp.h"
 #include "gtest/gtest.h"
 
@@ -40,6 +54,7 @@
 */
 
 using namespace ivi;
+using google::protobuf::util::MessageDifferencer;
 
 std::mt19937& RandomEng()
 {
@@ -110,9 +125,9 @@ string RandomString(uint32_t len)
     return retVal;
 }
 
-list<string> RandomStringList(int32_t strLen, int32_t maxListLen)
+StringList RandomStringList(int32_t strLen, int32_t maxListLen)
 {
-    list<string> retVal;
+    StringList retVal;
     const int count = RandomInt(maxListLen);
     for (int i = 0; i < maxListLen; ++i)
         retVal.push_back(RandomString(strLen));
@@ -371,6 +386,240 @@ TEST(DefaultConfiguration, Initialization)
 	EXPECT_EQ(config->autoconfirmStreamUpdates, true);
 }
 
+#ifdef IVI_SDK_LAZY_METADATA_PROPERTIES
+TEST(Metadata, LazyProperties)
+{
+    const string json(GenerateJsonString());
+    proto::common::Metadata proto;
+    proto.set_name(RandomString(10));
+    *proto.mutable_properties() = JsonStringToGoogleStruct(json);
+
+    // parsed metadata keeps the Struct, the JSON is built on first read and shared by copies
+    const IVIMetadata parsed(IVIMetadata::FromProto(proto));
+    const IVIMetadata copy(parsed);
+    ASSERT_NE(parsed.properties.Struct(), nullptr);
+    ASSERT_EQ(parsed.properties.Struct(), copy.properties.Struct());
+    const size_t estimate(parsed.properties.ByteSizeEstimate());
+    ASSERT_EQ(copy.properties.Json(), GoogleStructToJsonString(proto.properties()));
+    ASSERT_EQ(&copy.properties.Json(), &parsed.properties.Json());
+    ASSERT_EQ(parsed.properties.ByteSizeEstimate(), estimate);
+
+    // the kept Struct goes back out untouched
+    ASSERT_TRUE(MessageDifferencer::Equals(parsed.ToProto(), proto));
+
+    // plain JSON still works both ways, and compares by text against a Struct
+    IVIMetadata assigned(parsed);
+    assigned.properties = json;
+    ASSERT_EQ(assigned.properties.Struct(), nullptr);
+    ASSERT_EQ(static_cast<const string&>(assigned.properties), json);
+    ASSERT_EQ(IVIMetadata::FromProto(assigned.ToProto()).properties, parsed.properties);
+    ASSERT_EQ(IVIMetadataProperties(parsed.properties.Json()), parsed.properties);
+    ASSERT_TRUE(IVIMetadataProperties().empty());
+    ASSERT_EQ(IVIMetadataProperties(""), IVIMetadataProperties());
+}
+#endif
+
+TEST(Metadata, StructProperties)
+{
+    google::protobuf::Struct properties;
+    (*properties.mutable_fields())["rarity"].set_string_value("legendary");
+    (*properties.mutable_fields())["level"].set_number_value(42);
+    const google::protobuf::Struct expected(properties);
+
+    // by copy or by move, the properties go out as the Struct they were built from
+    const IVIMetadata first{ RandomString(10), RandomString(10), RandomString(10), MetadataPropertiesFromStruct(properties) };
+    ASSERT_TRUE(MessageDifferencer::Equals(first.ToProto().properties(), expected));
+    const IVIMetadataProperties moved(MetadataPropertiesFromStruct(std::move(properties)));
+    ASSERT_TRUE(MessageDifferencer::Equals(*MetadataPropertiesToStruct(moved), expected));
+    ASSERT_EQ(moved, first.properties);
+    ASSERT_TRUE(MessageDifferencer::Equals(JsonStringToGoogleStruct(moved), expected));
+
+#ifdef IVI_SDK_LAZY_METADATA_PROPERTIES
+    // a shared Struct is sent as is by every metadata built from it
+    const shared_ptr<const google::protobuf::Struct> shared(make_shared<google::protobuf::Struct>(expected));
+    const IVIMetadata second{ RandomString(10), RandomString(10), RandomString(10), IVIMetadataProperties::FromStruct(shared) };
+    const IVIMetadata third{ RandomString(10), RandomString(10), RandomString(10), IVIMetadataProperties::FromStruct(shared) };
+    ASSERT_EQ(MetadataPropertiesStruct(second.properties), shared);
+    ASSERT_EQ(MetadataPropertiesToStruct(third.properties), shared);
+    ASSERT_TRUE(MessageDifferencer::Equals(second.ToProto().properties(), expected));
+    ASSERT_EQ(second.properties, first.properties);
+    ASSERT_TRUE(IVIMetadataProperties::FromStruct(shared_ptr<const google::protobuf::Struct>()).empty());
+#else
+    ASSERT_EQ(MetadataPropertiesStruct(first.properties), nullptr);
+#endif
+}
+
+TEST(Metadata, StructCache)
+{
+    // separately built metadata with the same JSON is parsed once
+    const string json("{\"id\":\"" + RandomString(16) + "\",\"level\":7}");
+    const IVIMetadata first{ "name", "description", "image", string(json) };
+    const IVIMetadata second{ "name", "description", "image", string(json) };
+    const IVIMetadata copy(first);
+    ASSERT_EQ(MetadataPropertiesStruct(first.properties), nullptr);
+    const shared_ptr<const google::protobuf::Struct> parsed(MetadataPropertiesToStruct(first.properties));
+    ASSERT_NE(parsed, nullptr);
+    ASSERT_EQ(MetadataPropertiesToStruct(second.properties), parsed);
+    ASSERT_EQ(MetadataPropertiesToStruct(copy.properties), parsed);
+    ASSERT_TRUE(MessageDifferencer::Equals(second.ToProto().properties(), JsonStringToGoogleStruct(json)));
+    ASSERT_EQ(MetadataPropertiesToStruct(IVIMetadataProperties()), nullptr);
+    ASSERT_TRUE(IVIMetadata().ToProto().has_properties());
+
+    const IVIMetadataProperties other(json + " ");
+    ASSERT_NE(MetadataPropertiesToStruct(other), parsed);
+    ASSERT_TRUE(MessageDifferencer::Equals(*MetadataPropertiesToStruct(other), *parsed));
+
+    SetMetadataStructCacheCapacity(0);
+    const IVIMetadataProperties uncached(json);
+    ASSERT_NE(MetadataPropertiesToStruct(uncached), parsed);
+    SetMetadataStructCacheCapacity(64);
+}
+
+TEST(Model, InternedStrings)
+{
+    proto::api::item::Item proto(GenerateItem().ToProto());
+    const IVIItem first(IVIItem::FromProto(proto));
+    proto.set_game_inventory_id(RandomString(12));
+    const IVIItem second(IVIItem::FromProto(proto));
+
+    ASSERT_EQ(first.gameItemTypeId, second.gameItemTypeId);
+    ASSERT_EQ(first.gameItemTypeId, proto.game_item_type_id());
+    ASSERT_EQ(static_cast<const string&>(second.currencyBase), proto.currency_base());
+    ASSERT_EQ(second.ToProto().item_name(), proto.item_name());
+    ASSERT_EQ(second.ToProto().metadata().image(), proto.metadata().image());
+    ASSERT_TRUE(IVIInternedString().empty());
+
+#ifdef IVI_SDK_INTERNED_STRINGS
+    // one copy of each value however many items carry it, dropped once none do
+    ASSERT_EQ(&first.gameItemTypeId.str(), &second.gameItemTypeId.str());
+    ASSERT_EQ(&first.itemName.str(), &second.itemName.str());
+    ASSERT_EQ(&first.ownerSidechainAccount.str(), &second.ownerSidechainAccount.str());
+    ASSERT_EQ(&first.currencyBase.str(), &second.currencyBase.str());
+    ASSERT_EQ(&first.metadata.image.str(), &second.metadata.image.str());
+
+    const size_t pooled(IVIInternedString::PoolSize());
+    {
+        const IVIInternedString transient(RandomString(40));
+        ASSERT_EQ(IVIInternedString::PoolSize(), pooled + 1);
+        ASSERT_EQ(&IVIInternedString(transient.str()).str(), &transient.str());
+    }
+    ASSERT_EQ(IVIInternedString::PoolSize(), pooled);
+#endif
+}
+
+// Any mix of ASCII, escapes, multi-byte UTF-8, and U+2028 which MessageToJsonString escapes
+string RandomJsonText()
+{
+    static const char* const pieces[] =
+    {
+        "a", "Z", "0", " ", "\"", "\\", "/", "<", ">", "&", "'", "\x7f", "\x01", "\x1f", "\b", "\f", "\n", "\r", "\t",
+        "\xc3\xa9", "\xe2\x82\xac", "\xe2\x80\xa8", "\xe2\x80\xa9", "\xf0\x9f\x98\x80", "\xef\xbf\xbf"
+    };
+    string text;
+    const uint32_t length(RandomInt<uint32_t>(0, 40));
+    for (uint32_t i = 0; i < length; ++i)
+    {
+        // long ASCII runs take the vectorized paths
+        text.append(RandomInt(4) == 0 ? RandomString(RandomInt<uint32_t>(1, 40)) : pieces[RandomInt(sizeof(pieces) / sizeof(pieces[0]))]);
+    }
+    return text;
+}
+
+void RandomJsonValue(google::protobuf::Value& value, int depth)
+{
+    switch (RandomInt(depth < 4 ? 8 : 6))
+    {
+    case 0: value.set_null_value(google::protobuf::NULL_VALUE);                      break;
+    case 1: value.set_bool_value(RandomBool());                                      break;
+    case 2: value.set_number_value(RandomInt<int64_t>(-1000000, 1000000));           break;
+    case 3:
+    {
+        static const double edges[] = { 0.0, -0.0, 0.1, 1e15, 1e16, 1e21, 1e-7, 5e-324, 1.7976931348623157e308, 9007199254740993.0 };
+        value.set_number_value(RandomBool() ? edges[RandomInt(sizeof(edges) / sizeof(edges[0]))]
+            : RandomFloat<double>(-1e6, 1e6) * std::pow(10.0, RandomInt<int>(-30, 30)));
+        break;
+    }
+    case 4:
+    case 5: value.set_string_value(RandomJsonText());                                break;
+    case 6:
+    {
+        google::protobuf::ListValue& list(*value.mutable_list_value());
+        const uint32_t count(RandomInt<uint32_t>(0, 5));
+        for (uint32_t i = 0; i < count; ++i)
+            RandomJsonValue(*list.add_values(), depth + 1);
+        break;
+    }
+    case 7:
+    {
+        google::protobuf::Struct& nested(*value.mutable_struct_value());
+        const uint32_t count(RandomInt<uint32_t>(0, 5));
+        for (uint32_t i = 0; i < count; ++i)
+            RandomJsonValue((*nested.mutable_fields())[RandomJsonText()], depth + 1);
+        break;
+    }
+    }
+}
+
+TEST(Json, Differential)
+{
+    using namespace google::protobuf::util;
+    JsonPrintOptions pretty;
+    pretty.add_whitespace = true;
+
+    for (int i = 0; i < 500; ++i)
+    {
+        google::protobuf::Struct original;
+        const uint32_t count(RandomInt<uint32_t>(0, 8));
+        for (uint32_t field = 0; field < count; ++field)
+            RandomJsonValue((*original.mutable_fields())[RandomJsonText()], 0);
+
+        // the writer matches json_util byte for byte
+        string expected, actual, prettyJson;
+        ASSERT_TRUE(MessageToJsonString(original, &expected).ok());
+        AppendGoogleStructJson(original, actual);
+        ASSERT_EQ(actual, expected);
+        ASSERT_EQ(GoogleStructToJsonString(original), expected);
+
+        // the parser reads json_util output, compact or indented, back to the same Struct
+        ASSERT_TRUE(MessageToJsonString(original, &prettyJson, pretty).ok());
+        for (const string& json : { expected, prettyJson })
+        {
+            google::protobuf::Struct parsed, reference;
+            ASSERT_TRUE(ParseGoogleStructJson(json.data(), json.size(), parsed)) << json;
+            ASSERT_TRUE(JsonStringToMessage(json, &reference).ok());
+            ASSERT_TRUE(MessageDifferencer::Equals(parsed, original)) << json;
+            ASSERT_TRUE(MessageDifferencer::Equals(parsed, reference)) << json;
+        }
+    }
+
+    // non-finite numbers are written as json_util does, as strings
+    google::protobuf::Struct special;
+    (*special.mutable_fields())["nan"].set_number_value(std::nan(""));
+    string expected, actual;
+    ASSERT_TRUE(MessageToJsonString(special, &expected).ok());
+    AppendGoogleStructJson(special, actual);
+    ASSERT_EQ(actual, expected);
+
+    // strict parsing, json_util also rejects these
+    google::protobuf::Struct parsed;
+    for (const string& json : StringList{ "", "[1]", "1", "{", "{\"a\":01}", "{\"a\":1e999}", "{\"a\":\"\\ud800\"}", "{\"a\":NaN}",
+        "{\"a\":\"\xff\"}", "{\"a\":\"\xed\xa0\x80\"}", "{} x", "{\"a\":.5}", "{\"a\":+1}", "{\"a\":-}", "{\"a\":1,\"a\":2}",
+        string(101, '[') + string(101, ']') })
+    {
+        ASSERT_FALSE(ParseGoogleStructJson(json.data(), json.size(), parsed)) << json;
+        ASSERT_FALSE(JsonStringToMessage(json, &parsed).ok()) << json;
+    }
+    const string deep("{\"a\":" + string(98, '[') + string(98, ']') + "}");
+    ASSERT_TRUE(ParseGoogleStructJson(deep.data(), deep.size(), parsed));
+
+    // forms json_util tolerates fail here and fall back to it
+    for (const string& json : StringList{ "{\"a\":1,}", "{'a':1}", "{\"a\":1.}", "{\"a\":\"\x01\"}" })
+    {
+        ASSERT_FALSE(ParseGoogleStructJson(json.data(), json.size(), parsed)) << json;
+        ASSERT_EQ(JsonStringToGoogleStruct(json).fields().count("a"), 1) << json;
+    }
+}
+
 ::grpc::Status AnError(::grpc::StatusCode code)
 {
     return ::grpc::Status{ code, "an error occurred" };
@@ -420,9 +669,11 @@ public:
 
     string lastTrackingId;
 
+    std::mutex issueItemMutex; // IssueItems pipelines concurrent requests
     proto::api::item::IssueItemRequest lastIssueItemRequest;
     ::grpc::Status IssueItem(::grpc::ServerContext* context, const proto::api::item::IssueItemRequest* request, proto::api::item::IssueItemStartedResponse* response) override
     {
+        std::lock_guard<std::mutex> lock(issueItemMutex);
         lastIssueItemRequest = *request;
 
         if (request->game_inventory_id().size() == 0)
@@ -456,8 +707,10 @@ public:
     }
 
     proto::api::item::GetItemRequest lastGetItemRequest;
+    std::atomic<int> getItemCalls{ 0 };
     ::grpc::Status GetItem(::grpc::ServerContext* context, const proto::api::item::GetItemRequest* request, proto::api::item::Item* response) override
     {
+        ++getItemCalls;
         lastGetItemRequest = *request;
         auto item(SomeItems().find(request->game_inventory_id()));
         if (item != SomeItems().end())
@@ -469,14 +722,37 @@ public:
     }
 
     bool getItemsReturnsNothing = false;
+    // When not empty GetItems pages over these instead, items at the cursor timestamp included
+    std::vector<IVIItem> pagedItems;
+    std::atomic<int> getItemsCalls{ 0 };
     proto::api::item::GetItemsRequest lastGetItemsRequest;
     ::grpc::Status GetItems(::grpc::ServerContext* context, const proto::api::item::GetItemsRequest* request, ::ivi::proto::api::item::Items* response) override
     {
+        ++getItemsCalls;
         lastGetItemsRequest = *request;
 
         if(getItemsReturnsNothing)
             return ::grpc::Status::OK;
 
+        if (!pagedItems.empty())
+        {
+            const bool ascending(request->sort_order() == ECast(SortOrder::ASC));
+            std::vector<IVIItem> sorted(pagedItems);
+            std::stable_sort(sorted.begin(), sorted.end(), [ascending](const IVIItem& lhs, const IVIItem& rhs)
+                { return ascending ? lhs.createdTimestamp < rhs.createdTimestamp : lhs.createdTimestamp > rhs.createdTimestamp; });
+            for (const IVIItem& item : sorted)
+            {
+                const time_t cursor(request->created_timestamp());
+                if (cursor == 0 || (ascending ? item.createdTimestamp >= cursor : item.createdTimestamp <= cursor))
+                {
+                    *response->add_items() = item.ToProto();
+                    if (response->items_size() == request->page_size())
+                        break;
+                }
+            }
+            return ::grpc::Status::OK;
+        }
+
         transform(SomeItems().begin(), SomeItems().end(), google::protobuf::RepeatedPtrFieldBackInserter(response->mutable_items()),
             [](const ItemMap::value_type& itemPair) { return itemPair.second.ToProto();  });
         return ::grpc::Status::OK;
@@ -561,6 +837,159 @@ TEST_F(ItemClientTest, IssueItem)
     ClientTest::template UnaryTest<BadRPCTestData>(checkResultFail, syncCaller, asyncCaller);
 }
 
+TEST_F(ItemClientTest, IssueItems)
+{
+    const size_t count = 50;
+    const uint32_t windowSize = 4;
+    IVIIssueItemSpecList specs;
+    std::set<string> badIds;
+    for (size_t i = 0; i < count; ++i)
+    {
+        IVIItem item(GenerateItem());
+        if (i % 10 == 3)
+        {
+            item.gameInventoryId = "";  // fake service fails these
+            badIds.insert(std::to_string(i));
+        }
+        specs.push_back({ item.gameInventoryId, item.playerId, item.itemName, item.gameItemTypeId, "1.00", "USD", item.metadata, RandomString(8), std::to_string(i), "127.0.0.1" });
+    }
+
+    size_t itemResults = 0, failures = 0, progressCalls = 0;
+    IVIIssueItemsBatchPtr batch;
+    batch = m_asyncManager->ItemClient().IssueItems(
+        specs,
+        windowSize,
+        [&](const IVIIssueItemSpec& spec, const IVIResultItemStateChange& result)
+        {
+            ++itemResults;
+            ASSERT_EQ(result.Success(), badIds.count(spec.orderId) == 0);
+            if (result.Success())
+            {
+                ASSERT_EQ(result.Payload().gameInventoryId, spec.gameInventoryId);
+                ASSERT_EQ(result.Payload().itemState, ItemState::PENDING_ISSUED);
+            }
+            else
+            {
+                ++failures;
+            }
+        },
+        [&](const IVIIssueItemsProgress& progress)
+        {
+            ++progressCalls;
+            ASSERT_LE(progress.InFlight(), windowSize);
+            ASSERT_EQ(progress.total, count);
+            if (progress.Completed() == count / 2)
+                batch->Pause();
+        });
+
+    ASSERT_EQ(batch->Progress().sent, windowSize);
+
+    while (!batch->IsPaused())
+        ASSERT_TRUE(m_asyncManager->Poll());
+
+    // drain whatever was already in flight, nothing new may be dispatched while paused
+    const size_t sentAtPause = batch->Progress().sent;
+    while (batch->Progress().InFlight() > 0)
+        ASSERT_TRUE(m_asyncManager->Poll());
+    ASSERT_EQ(batch->Progress().sent, sentAtPause);
+    ASSERT_FALSE(batch->Progress().Done());
+
+    batch->Resume();
+    while (!batch->Progress().Done())
+        ASSERT_TRUE(m_asyncManager->Poll());
+
+    ASSERT_EQ(itemResults, count);
+    ASSERT_EQ(progressCalls, count);
+    ASSERT_EQ(failures, badIds.size());
+    ASSERT_EQ(batch->Progress().failed, badIds.size());
+    ASSERT_EQ(batch->Progress().succeeded, count - badIds.size());
+}
+
+TEST_F(ItemClientTest, IssueItems_Rejected)
+{
+    const size_t count = 100000;
+    IVIConfigurationPtr config(new IVIConfiguration(m_asyncManager->GetConfig()));
+    config->admissionPolicies["ivi.rpc.api.item.ItemService"] = { 1, 0, IVIOverflowPolicy::REJECT, 0 };
+    IVIClientManagerAsync manager(config, IVIConnection::InsecureConnection(config->host), NoStreamCallbacks);
+
+    IVIItem item(GenerateItem());
+    IVIIssueItemSpecList specs(count, { item.gameInventoryId, item.playerId, item.itemName, item.gameItemTypeId, "1.00", "USD", item.metadata, RandomString(8), RandomString(8), "127.0.0.1" });
+
+    size_t rejected = 0;
+    IVIIssueItemsBatchPtr batch(manager.ItemClient().IssueItems(
+        specs,
+        8,
+        [&](const IVIIssueItemSpec&, const IVIResultItemStateChange& result)
+        {
+            if (result.Status() == IVIResultStatus::RESOURCE_EXHAUSTED)
+                ++rejected;
+        }));
+
+    // every rejection refilled the window from the same loop rather than a nested call
+    ASSERT_EQ(batch->Progress().sent, count);
+    ASSERT_EQ(rejected, count - 1);
+
+    while (!batch->Progress().Done())
+        ASSERT_TRUE(manager.Poll());
+    ASSERT_EQ(batch->Progress().succeeded, 1);
+    ASSERT_EQ(batch->Progress().failed, count - 1);
+}
+
+TEST_F(ItemClientTest, AdmissionControl)
+{
+    const uint32_t maxInFlight = 2, maxQueued = 3, calls = 10;
+
+    using StatusCounts = std::map<IVIResultStatus, uint32_t>;
+    auto runPolicy = [&](IVIOverflowPolicy overflowPolicy, uint32_t blockTimeoutMs, StatusCounts& statusCounts)
+    {
+        uint32_t results = 0;
+
+        IVIConfigurationPtr config(new IVIConfiguration(m_asyncManager->GetConfig()));
+        config->admissionPolicies["ivi.rpc.api.item.ItemService"] = { maxInFlight, maxQueued, overflowPolicy, blockTimeoutMs };
+        IVIClientManagerAsync manager(config, IVIConnection::InsecureConnection(config->host), NoStreamCallbacks);
+        IVIItemClientAsync& client(manager.ItemClient());
+
+        for (uint32_t i = 0; i < calls; ++i)
+        {
+            client.BurnItem(RandomString(12),
+                [&](const IVIResultItemStateChange& result)
+                {
+                    ++statusCounts[result.Status()];
+                    ++results;
+                });
+            ASSERT_LE(client.InFlightCalls(), maxInFlight);
+            ASSERT_LE(client.QueuedCalls(), maxQueued);
+        }
+
+        // everything beyond the in-flight and queued limits was refused without touching the network
+        ASSERT_EQ(results, calls - maxInFlight - maxQueued);
+        ASSERT_EQ(client.InFlightCalls(), maxInFlight);
+        ASSERT_EQ(client.QueuedCalls(), maxQueued);
+
+        while (results < calls)
+        {
+            ASSERT_TRUE(manager.Poll());
+            ASSERT_LE(client.InFlightCalls(), maxInFlight);
+        }
+
+        ASSERT_EQ(client.InFlightCalls(), 0);
+        ASSERT_EQ(client.QueuedCalls(), 0);
+        ASSERT_EQ(statusCounts[IVIResultStatus::SUCCESS], maxInFlight + maxQueued);
+    };
+
+    StatusCounts rejected, dropped, blocked;
+    runPolicy(IVIOverflowPolicy::REJECT, 0, rejected);
+    ASSERT_EQ(rejected[IVIResultStatus::RESOURCE_EXHAUSTED], calls - maxInFlight - maxQueued);
+
+    // the oldest queued calls are dropped, the newest ones run
+    runPolicy(IVIOverflowPolicy::DROP_OLDEST, 0, dropped);
+    ASSERT_EQ(dropped[IVIResultStatus::ABORTED], calls - maxInFlight - maxQueued);
+
+    // nothing polls while the caller blocks, so each blocked call times out
+    runPolicy(IVIOverflowPolicy::BLOCK, 10, blocked);
+    ASSERT_EQ(blocked[IVIResultStatus::RESOURCE_EXHAUSTED], calls - maxInFlight - maxQueued);
+}
+
 TEST_F(ItemClientTest, TransferItem)
 {
     struct RPCTestData
@@ -675,6 +1104,191 @@ TEST_F(ItemClientTest, GetItem)
     }
 }
 
+TEST_F(ItemClientTest, GetItem_SingleFlight)
+{
+    const string gameInventoryId(RandomKey(FakeItemService::SomeItems()));
+    const int callers = 8;
+    int results = 0;
+
+    // history is part of the request, so those callers get a flight of their own
+    for (int i = 0; i < callers; ++i)
+    {
+        m_asyncManager->ItemClient().GetItem(gameInventoryId, i % 2 == 0,
+            [&](const IVIResultItem& result)
+            {
+                ASSERT_TRUE(result.Success());
+                CheckEq(result.Payload(), FakeItemService::SomeItems().at(gameInventoryId));
+                ++results;
+            });
+    }
+
+    while (results < callers)
+        ASSERT_TRUE(m_asyncManager->Poll());
+    ASSERT_EQ(m_service.getItemCalls, 2);
+
+    // the flight is over, a later call goes to the server again
+    bool resultReceived = false;
+    m_asyncManager->ItemClient().GetItem(gameInventoryId,
+        [&](const IVIResultItem& result)
+        {
+            ASSERT_TRUE(result.Success());
+            resultReceived = true;
+        });
+    while (!resultReceived)
+        ASSERT_TRUE(m_asyncManager->Poll());
+    ASSERT_EQ(m_service.getItemCalls, 3);
+}
+
+TEST_F(ItemClientTest, ItemCache)
+{
+    const string gameInventoryId(RandomKey(FakeItemService::SomeItems()));
+    const IVIItem& expected(FakeItemService::SomeItems().at(gameInventoryId));
+    IVIItemCache cache(1024 * 1024, 0);
+
+    auto getItem = [&]()
+    {
+        bool resultReceived = false;
+        cache.GetItem(m_asyncManager->ItemClient(), gameInventoryId,
+            [&](const IVIResultItem& result)
+            {
+                ASSERT_TRUE(result.Success());
+                CheckEq(result.Payload(), expected);
+                resultReceived = true;
+            });
+        while (!resultReceived)
+            ASSERT_TRUE(m_asyncManager->Poll());
+    };
+
+    // read-through, then served locally until a stream update for the item arrives
+    getItem();
+    getItem();
+    ASSERT_EQ(m_service.getItemCalls, 1);
+
+    int nextCalls = 0;
+    OnItemUpdated onUpdated(cache.Hook([&](const IVIItemStatusUpdate&) { ++nextCalls; }));
+    onUpdated({ gameInventoryId, expected.gameItemTypeId, expected.playerId, expected.metadataUri, RandomString(12), expected.dgoodsId, expected.serialNumber, ItemState::TRANSFERRED });
+    ASSERT_EQ(nextCalls, 1);
+    ASSERT_EQ(cache.Find(gameInventoryId), nullptr);
+    getItem();
+    ASSERT_EQ(m_service.getItemCalls, 2);
+    ASSERT_EQ(cache.Stats().hits, 1);
+    ASSERT_EQ(cache.Stats().bytes, IVIItemCache::EstimateBytes(expected));
+
+    // only an update for the same item keeps a read-through result out of the cache
+    for (const bool sameItem : { false, true })
+    {
+        cache.Erase(gameInventoryId);
+        bool resultReceived = false;
+        cache.GetItem(m_asyncManager->ItemClient(), gameInventoryId, [&](const IVIResultItem&) { resultReceived = true; });
+        onUpdated({ sameItem ? gameInventoryId : RandomString(23), expected.gameItemTypeId, expected.playerId, expected.metadataUri, RandomString(12), expected.dgoodsId, expected.serialNumber, ItemState::TRANSFERRED });
+        while (!resultReceived)
+            ASSERT_TRUE(m_asyncManager->Poll());
+        ASSERT_EQ(cache.Find(gameInventoryId) == nullptr, sameItem);
+    }
+
+    // the memory cap evicts, both policies keep the item that was just used
+    for (IVICacheEviction eviction : { IVICacheEviction::LRU, IVICacheEviction::CLOCK })
+    {
+        const IVIItem first(GenerateItem()), second(GenerateItem()), third(GenerateItem());
+        IVIItemCache bounded(IVIItemCache::EstimateBytes(first) + IVIItemCache::EstimateBytes(second) + IVIItemCache::EstimateBytes(third) - 1, 0, eviction);
+        bounded.Put(first);
+        bounded.Put(second);
+        ASSERT_NE(bounded.Find(first.gameInventoryId), nullptr);
+        bounded.Put(third);
+        ASSERT_EQ(bounded.Find(second.gameInventoryId), nullptr);
+        CheckEq(*bounded.Find(first.gameInventoryId), first);
+        CheckEq(*bounded.Find(third.gameInventoryId), third);
+        ASSERT_EQ(bounded.Stats().evictions, 1);
+        ASSERT_LE(bounded.Stats().bytes, bounded.Stats().capacity);
+
+        IVIItemCache tooSmall(IVIItemCache::EstimateBytes(first) - 1, 0, eviction);
+        tooSmall.Put(first);
+        ASSERT_EQ(tooSmall.Stats().size, 0);
+    }
+
+    // expiry
+    IVIItemCache expiring(1024 * 1024, 1);
+    expiring.Put(expected);
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    ASSERT_EQ(expiring.Find(gameInventoryId), nullptr);
+    ASSERT_EQ(expiring.Stats().size, 0);
+    ASSERT_EQ(expiring.Stats().bytes, 0);
+}
+
+TEST_F(ItemClientTest, NotFoundCache)
+{
+    const string gameInventoryId(RandomString(23));
+    IVINotFoundCache cache(2, 60 * 60 * 1000);
+
+    auto getItem = [&](IVINotFoundCache& notFound)
+    {
+        bool resultReceived = false;
+        notFound.GetItem(m_asyncManager->ItemClient(), gameInventoryId,
+            [&](const IVIResultItem& result)
+            {
+                ASSERT_EQ(result.Status(), IVIResultStatus::NOT_FOUND);
+                resultReceived = true;
+            });
+        while (!resultReceived)
+            ASSERT_TRUE(m_asyncManager->Poll());
+    };
+
+    // repeated misses are answered locally
+    getItem(cache);
+    getItem(cache);
+    getItem(cache);
+    ASSERT_EQ(m_service.getItemCalls, 1);
+    ASSERT_EQ(cache.Stats().hits, 2);
+    ASSERT_EQ(cache.Stats().size, 1);
+
+    // an update means the item exists now
+    int nextCalls = 0;
+    OnItemUpdated onUpdated(cache.HookItemUpdates([&](const IVIItemStatusUpdate&) { ++nextCalls; }));
+    onUpdated({ gameInventoryId, RandomString(8), RandomString(8), RandomString(8), RandomString(8), 1, 1, ItemState::ISSUED });
+    ASSERT_EQ(nextCalls, 1);
+    ASSERT_EQ(cache.Stats().size, 0);
+    getItem(cache);
+    ASSERT_EQ(m_service.getItemCalls, 2);
+
+    // only an update for the same kind and id during the call keeps a NOT_FOUND from being remembered
+    OnPlayerUpdated onPlayerUpdated(cache.HookPlayerUpdates(nullptr));
+    for (const bool sameItem : { false, true })
+    {
+        onUpdated({ gameInventoryId, RandomString(8), RandomString(8), RandomString(8), RandomString(8), 1, 1, ItemState::ISSUED });
+        bool resultReceived = false;
+        cache.GetItem(m_asyncManager->ItemClient(), gameInventoryId, [&](const IVIResultItem&) { resultReceived = true; });
+        onPlayerUpdated({ gameInventoryId, RandomString(8), PlayerState::LINKED });
+        if (sameItem)
+            onUpdated({ gameInventoryId, RandomString(8), RandomString(8), RandomString(8), RandomString(8), 1, 1, ItemState::ISSUED });
+        while (!resultReceived)
+            ASSERT_TRUE(m_asyncManager->Poll());
+        ASSERT_EQ(cache.Stats().size, sameItem ? 0 : 1);
+    }
+    getItem(cache);
+    ASSERT_EQ(m_service.getItemCalls, 5);
+
+    // items that exist are never remembered
+    const string existingId(RandomKey(FakeItemService::SomeItems()));
+    bool resultReceived = false;
+    cache.GetItem(m_asyncManager->ItemClient(), existingId,
+        [&](const IVIResultItem& result)
+        {
+            ASSERT_TRUE(result.Success());
+            resultReceived = true;
+        });
+    while (!resultReceived)
+        ASSERT_TRUE(m_asyncManager->Poll());
+    ASSERT_EQ(cache.Stats().size, 1);
+
+    // expiry
+    IVINotFoundCache expiring(2, 1);
+    getItem(expiring);
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    getItem(expiring);
+    ASSERT_EQ(m_service.getItemCalls, 8);
+    ASSERT_EQ(expiring.Stats().hits, 0);
+}
+
 TEST_F(ItemClientTest, GetItems)
 {
     struct RPCTestData
@@ -729,6 +1343,340 @@ TEST_F(ItemClientTest, GetItems)
     ClientTest::template UnaryTest<RPCTestData>(checkEmptyResultSuccess, syncCaller, asyncCaller);
 }
 
+TEST_F(ItemClientTest, GetItems_Visitor)
+{
+    struct RPCTestData
+    {
+        time_t timestamp = Now() - RandomInt(100000);
+        int32_t pageSize = RandomInt(128);
+        SortOrder sortOrder = static_cast<SortOrder>(RandomInt(proto::common::sort::SortOrder_ARRAYSIZE));
+        Finalized finalized = static_cast<Finalized>(RandomInt(proto::common::finalization::Finalized_ARRAYSIZE));
+        shared_ptr<std::set<string>> visited = make_shared<std::set<string>>();
+    };
+
+    auto checkResultSuccess = [&](const RPCTestData& data, const IVIResultCount& result)
+    {
+        const proto::api::item::GetItemsRequest& request(m_service.lastGetItemsRequest);
+        ASSERT_TRUE(result.Success());
+        ASSERT_EQ(data.pageSize, request.page_size());
+        ASSERT_EQ(data.finalized, ECast(request.finalized()));
+        ASSERT_EQ(result.Payload(), FakeItemService::SomeItems().size());
+        ASSERT_EQ(data.visited->size(), FakeItemService::SomeItems().size());
+    };
+
+    auto visitor = [](const RPCTestData& data)
+    {
+        shared_ptr<std::set<string>> visited(data.visited);
+        return [visited](const IVIItem& item)
+        {
+            CheckEq(FakeItemService::SomeItems().at(item.gameInventoryId), item);
+            visited->insert(item.gameInventoryId);
+        };
+    };
+
+    auto syncCaller = [&](const RPCTestData& data)
+    {
+        return m_syncManager->ItemClient().GetItems(
+            data.timestamp, data.pageSize, data.sortOrder, data.finalized, visitor(data));
+    };
+
+    auto asyncCaller = [&](const RPCTestData& data, const function<void(const IVIResultCount&)>& callback)
+    {
+        m_asyncManager->ItemClient().GetItems(
+            data.timestamp, data.pageSize, data.sortOrder, data.finalized, visitor(data), callback);
+    };
+
+    ClientTest::template UnaryTest<RPCTestData>(checkResultSuccess, syncCaller, asyncCaller);
+}
+
+TEST_F(ItemClientTest, ItemPager)
+{
+    // pairs of items share a timestamp, so some pages end in the middle of a pair
+    const int32_t itemCount = 25, pageSize = 4;
+    for (int32_t i = 0; i < itemCount; ++i)
+    {
+        IVIItem item(GenerateItem());
+        item.createdTimestamp = 1000 + i / 2;
+        m_service.pagedItems.push_back(item);
+    }
+
+    for (SortOrder sortOrder : { SortOrder::ASC, SortOrder::DESC })
+    {
+        std::map<string, int> seen;
+        time_t lastTimestamp = sortOrder == SortOrder::ASC ? 0 : numeric_limits<time_t>::max();
+        auto visit = [&](const IVIItem& item)
+        {
+            ++seen[item.gameInventoryId];
+            if (sortOrder == SortOrder::ASC)
+                ASSERT_GE(item.createdTimestamp, lastTimestamp);
+            else
+                ASSERT_LE(item.createdTimestamp, lastTimestamp);
+            lastTimestamp = item.createdTimestamp;
+        };
+
+        // pull, the next page is requested before the current one is returned
+        m_service.getItemsCalls = 0;
+        IVIItemPager pager(m_asyncManager->ItemClient(), 0, pageSize, sortOrder, Finalized::ALL);
+        const IVIResultItemList first(pager.NextPage(*m_asyncManager));
+        ASSERT_TRUE(first.Success());
+        ASSERT_EQ(first.Payload().size(), pageSize);
+        for (int i = 0; i < 100 && m_service.getItemsCalls < 2; ++i)
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        ASSERT_EQ(m_service.getItemsCalls, 2);
+        for (const IVIItem& item : first.Payload())
+            visit(item);
+        ASSERT_TRUE(pager.ForEachItem(*m_asyncManager, visit).Success());
+        ASSERT_TRUE(pager.Done());
+        ASSERT_EQ(seen.size(), itemCount);
+        for (const auto& entry : seen)
+            ASSERT_EQ(entry.second, 1);
+
+        // push
+        seen.clear();
+        lastTimestamp = sortOrder == SortOrder::ASC ? 0 : numeric_limits<time_t>::max();
+        bool last = false;
+        IVIItemPager pushPager(m_asyncManager->ItemClient(), 0, pageSize, sortOrder, Finalized::ALL);
+        pushPager.Start([&](const IVIResultItemList& page, bool isLast)
+            {
+                ASSERT_TRUE(page.Success());
+                ASSERT_FALSE(last);
+                for (const IVIItem& item : page.Payload())
+                    visit(item);
+                last = isLast;
+            });
+        while (!last)
+            ASSERT_TRUE(m_asyncManager->Poll());
+        ASSERT_TRUE(pushPager.Done());
+        ASSERT_EQ(seen.size(), itemCount);
+    }
+
+    // a pager destroyed mid-walk drops its outstanding page
+    {
+        IVIItemPager abandoned(m_asyncManager->ItemClient(), 0, pageSize, SortOrder::ASC, Finalized::ALL);
+        ASSERT_TRUE(abandoned.NextPage(*m_asyncManager).Success());
+    }
+    const int calls(m_service.getItemsCalls);
+    for (int i = 0; i < 100 && m_service.getItemsCalls == calls; ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    m_asyncManager->Poll();
+    m_service.pagedItems.clear();
+}
+
+TEST_F(ItemClientTest, ItemPager_Rejected)
+{
+    const int32_t itemCount = 40, pageSize = 4;
+    for (int32_t i = 0; i < itemCount; ++i)
+    {
+        IVIItem item(GenerateItem());
+        item.createdTimestamp = 1000 + i;
+        m_service.pagedItems.push_back(item);
+    }
+
+    IVIConfigurationPtr config(new IVIConfiguration(m_asyncManager->GetConfig()));
+    config->admissionPolicies["ivi.rpc.api.item.ItemService"] = { 1, 0, IVIOverflowPolicy::REJECT, 0 };
+    IVIClientManagerAsync manager(config, IVIConnection::InsecureConnection(config->host), NoStreamCallbacks);
+
+    // whether the competitor gets in at the right moment is down to scheduling, walk until it has
+    const string burnId(RandomString(12));
+    int failedWalks = 0;
+    for (int walk = 0; walk < 2000 && failedWalks == 0; ++walk)
+    {
+        std::atomic<bool> last(false);
+        bool inOnPage = false;
+        time_t lastTimestamp = 0;
+        IVIItemPager pager(manager.ItemClient(), 0, pageSize, SortOrder::ASC, Finalized::ALL);
+        pager.Start([&](const IVIResultItemList& page, bool isLast)
+            {
+                ASSERT_FALSE(inOnPage);
+                ASSERT_FALSE(last);
+                inOnPage = true;
+                if (page.Success())
+                {
+                    for (const IVIItem& item : page.Payload())
+                    {
+                        ASSERT_GT(item.createdTimestamp, lastTimestamp);
+                        lastTimestamp = item.createdTimestamp;
+                    }
+                }
+                else
+                {
+                    // a failure ends the walk, after every page before it
+                    ASSERT_EQ(page.Status(), IVIResultStatus::RESOURCE_EXHAUSTED);
+                    ASSERT_TRUE(isLast);
+                    ++failedWalks;
+                }
+                last = isLast;
+                inOnPage = false;
+            });
+        ASSERT_FALSE(last);
+
+        // Another thread takes the single slot as soon as a page completes, so the prefetch sent while
+        // that page is delivered is rejected and fails synchronously
+        std::atomic<bool> burning(false);
+        std::thread competitor([&]()
+            {
+                while (!last)
+                {
+                    shared_ptr<std::atomic<bool>> rejected(make_shared<std::atomic<bool>>(false));
+                    burning = true;
+                    manager.ItemClient().BurnItem(burnId,
+                        [&burning, rejected](const IVIResultItemStateChange& result)
+                        {
+                            if (result.Status() == IVIResultStatus::RESOURCE_EXHAUSTED)
+                                *rejected = true;
+                            burning = false;
+                        });
+                    if (!*rejected)
+                        return;
+                }
+            });
+        while (!last)
+            ASSERT_TRUE(manager.Poll());
+        competitor.join();
+        while (burning)
+            ASSERT_TRUE(manager.Poll());
+        ASSERT_TRUE(pager.Done());
+    }
+    ASSERT_GT(failedWalks, 0);
+    m_service.pagedItems.clear();
+}
+
+TEST_F(ItemClientTest, ItemTable)
+{
+    const int32_t itemCount = 25, pageSize = 4;
+    const vector<string> itemTypeIds{ RandomString(12), RandomString(12), RandomString(12) };
+    std::map<string, IVIItem> items;
+    for (int32_t i = 0; i < itemCount; ++i)
+    {
+        IVIItem item(GenerateItem());
+        item.gameItemTypeId = itemTypeIds[i % itemTypeIds.size()];
+        item.createdTimestamp = 1000 + i / 2;
+        m_service.pagedItems.push_back(item);
+        items[item.gameInventoryId] = item;
+    }
+
+    // one page, straight from the response
+    IVIItemTable table;
+    const IVIResultCount result(m_syncManager->ItemClient().GetItems(0, pageSize, SortOrder::ASC, Finalized::ALL, table));
+    ASSERT_TRUE(result.Success());
+    ASSERT_EQ(result.Payload(), pageSize);
+    ASSERT_EQ(table.size(), pageSize);
+    for (size_t row = 0; row < table.size(); ++row)
+        CheckEq(items.at(table.gameInventoryId()[row]), table.Row(row));
+
+    // every page, counted per itemState per gameItemTypeId over the code columns only
+    table.clear();
+    IVIItemTablePager pager(m_asyncManager->ItemClient(), 0, pageSize, SortOrder::ASC, Finalized::ALL);
+    const IVIResultCount all(pager.AppendAll(*m_asyncManager, table));
+    ASSERT_TRUE(all.Success());
+    ASSERT_TRUE(pager.Done());
+    ASSERT_EQ(all.Payload(), itemCount);
+    ASSERT_EQ(table.size(), itemCount);
+    ASSERT_EQ(table.gameItemTypeId().Values().size(), itemTypeIds.size());
+
+    const size_t stateCount(proto::common::item::ItemState_ARRAYSIZE);
+    vector<size_t> counts(table.gameItemTypeId().Values().size() * stateCount);
+    for (size_t row = 0; row < table.size(); ++row)
+        ++counts[table.gameItemTypeId().Codes()[row] * stateCount + static_cast<size_t>(table.itemState()[row])];
+
+    std::map<std::pair<string, ItemState>, size_t> expected;
+    for (const auto& entry : items)
+        ++expected[{ entry.second.gameItemTypeId, entry.second.itemState }];
+    for (const auto& entry : expected)
+    {
+        IVIDictionaryColumn::Code code;
+        ASSERT_TRUE(table.gameItemTypeId().Find(entry.first.first, code));
+        ASSERT_EQ(counts[code * stateCount + static_cast<size_t>(entry.first.second)], entry.second);
+    }
+
+    std::set<string> seen;
+    for (size_t row = 0; row < table.size(); ++row)
+    {
+        ASSERT_TRUE(seen.insert(table.gameInventoryId()[row]).second);
+        ASSERT_EQ(table.gameItemTypeId()[row], items.at(table.gameInventoryId()[row]).gameItemTypeId);
+        if (row > 0)
+            ASSERT_GE(table.createdTimestamp()[row], table.createdTimestamp()[row - 1]);
+        CheckEq(items.at(table.gameInventoryId()[row]), table.Row(row));
+    }
+
+    // appending a table onto one with other dictionary codes
+    IVIItemTable merged;
+    merged.Append(items.rbegin()->second);
+    merged.Append(table);
+    ASSERT_EQ(merged.size(), itemCount + 1);
+    ASSERT_EQ(merged.gameItemTypeId().Values().size(), itemTypeIds.size());
+    for (size_t row = 0; row < table.size(); ++row)
+        CheckEq(table.Row(row), merged.Row(row + 1));
+
+    m_service.pagedItems.clear();
+}
+
+TEST_F(ItemClientTest, ColumnarExport)
+{
+    const string path("ivi-sdk-test-" + RandomString(8) + ".cols");
+    const vector<string> itemTypeIds{ RandomString(12), RandomString(12), RandomString(12) };
+    std::map<string, IVIItem> items;
+    for (int i = 0; i < 25; ++i)
+    {
+        IVIItem item(GenerateItem());
+        item.gameItemTypeId = itemTypeIds[i % 3];
+        item.createdTimestamp = 1000 + i;
+        items[item.gameInventoryId] = item;
+        m_service.pagedItems.push_back(item);
+    }
+
+    const IVIResultCount exported(IVIExportItems(*m_asyncManager, path, 4, 7));
+    ASSERT_TRUE(exported.Success());
+    ASSERT_EQ(exported.Payload(), items.size());
+
+    {
+        const unique_ptr<IVIColumnarReader> reader(IVIColumnarReader::Open(path));
+        ASSERT_NE(reader, nullptr);
+        ASSERT_EQ(reader->Table(), IVIColumnarTable::ITEMS);
+        ASSERT_EQ(reader->RowCount(), items.size());
+        ASSERT_EQ(reader->RowGroupCount(), 4);
+        ASSERT_EQ(reader->RowGroupRows(3), 4);
+        ASSERT_EQ(reader->ColumnNames().size(), 17);
+
+        std::set<string> seen;
+        ASSERT_EQ(reader->ForEachItem([&](const IVIItem& item)
+            {
+                ASSERT_EQ(items.count(item.gameInventoryId), 1);
+                CheckEq(item, items[item.gameInventoryId]);
+                seen.insert(item.gameInventoryId);
+            }), items.size());
+        ASSERT_EQ(seen.size(), items.size());
+        ASSERT_EQ(reader->ForEachPlayer([](const IVIPlayer&) {}), 0);
+
+        // single columns, exported in createdTimestamp order
+        vector<string> typeIds;
+        vector<int64_t> timestamps;
+        ASSERT_TRUE(reader->ReadStringColumn(1, "gameItemTypeId", typeIds));
+        ASSERT_TRUE(reader->ReadInt64Column(1, "createdTimestamp", timestamps));
+        ASSERT_EQ(typeIds.size(), 7);
+        ASSERT_EQ(timestamps.size(), 7);
+        for (size_t row = 0; row < 7; ++row)
+        {
+            ASSERT_EQ(typeIds[row], itemTypeIds[(7 + row) % 3]);
+            ASSERT_EQ(timestamps[row], 1007 + row);
+        }
+        ASSERT_FALSE(reader->ReadInt64Column(1, "gameItemTypeId", timestamps));
+        ASSERT_FALSE(reader->ReadStringColumn(4, "gameItemTypeId", typeIds));
+    }
+
+    // a file cut short, eg by a crash before Close, is rejected
+    {
+        std::ifstream in(path, std::ios::binary);
+        const string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), bytes.size() - 1);
+    }
+    ASSERT_EQ(IVIColumnarReader::Open(path), nullptr);
+
+    std::remove(path.c_str());
+    m_service.pagedItems.clear();
+}
+
 TEST_F(ItemClientTest, UpdateItemMetadata)
 {
     for(int i = 0; i < FakeItemService::SomeItems().size(); ++i)
@@ -917,8 +1865,10 @@ public:
     }
 
     proto::api::itemtype::GetItemTypesRequest lastGetItemTypeRequest;
+    std::atomic<int> getItemTypesCalls{ 0 };
     ::grpc::Status GetItemTypes(::grpc::ServerContext* context, const ::ivi::proto::api::itemtype::GetItemTypesRequest* request, ::ivi::proto::api::itemtype::ItemTypes* response) override
     {
+        ++getItemTypesCalls;
         lastGetItemTypeRequest = *request;
 
         // special case - returns everything
@@ -1005,11 +1955,92 @@ TEST_F(ItemTypeClientTest, GetItemType)
     }
 }
 
+TEST_F(ItemTypeClientTest, GetItemType_SingleFlight)
+{
+    const string gameItemTypeId(RandomKey(FakeItemTypeService::SomeItemTypes()));
+    const string missingItemTypeId(RandomString(17));
+    const int callers = 6;
+    int results = 0, notFound = 0;
+
+    for (int i = 0; i < callers; ++i)
+    {
+        const string& id(i % 3 == 0 ? missingItemTypeId : gameItemTypeId);
+        m_asyncManager->ItemTypeClient().GetItemType(id,
+            [&, id](const IVIResultItemType& result)
+            {
+                if (id == missingItemTypeId)
+                {
+                    ASSERT_EQ(result.Status(), IVIResultStatus::NOT_FOUND);
+                    ++notFound;
+                }
+                else
+                {
+                    ASSERT_TRUE(result.Success());
+                    CheckEq(result.Payload(), FakeItemTypeService::SomeItemTypes().at(gameItemTypeId));
+                }
+                ++results;
+            });
+    }
+
+    while (results < callers)
+        ASSERT_TRUE(m_asyncManager->Poll());
+    ASSERT_EQ(notFound, 2);
+    ASSERT_EQ(m_service.getItemTypesCalls, 2);
+}
+
+TEST_F(ItemTypeClientTest, GetItemType_Batched)
+{
+    const FakeItemTypeService::ItemTypeMap& itemTypes(FakeItemTypeService::SomeItemTypes());
+    const string missingItemTypeId(RandomString(17));
+
+    IVIConfigurationPtr config(new IVIConfiguration(m_asyncManager->GetConfig()));
+    config->itemTypeBatchMaxIds = static_cast<uint32_t>(itemTypes.size());
+    config->itemTypeBatchWindowMs = 20;
+    IVIClientManagerAsync manager(config, IVIConnection::InsecureConnection(config->host), NoStreamCallbacks);
+
+    size_t results = 0, expectedResults = 0;
+    auto lookup = [&](const string& gameItemTypeId)
+    {
+        ++expectedResults;
+        manager.ItemTypeClient().GetItemType(gameItemTypeId,
+            [&, gameItemTypeId](const IVIResultItemType& result)
+            {
+                ++results;
+                if (gameItemTypeId == missingItemTypeId)
+                {
+                    ASSERT_EQ(result.Status(), IVIResultStatus::NOT_FOUND);
+                }
+                else
+                {
+                    ASSERT_TRUE(result.Success());
+                    CheckEq(result.Payload(), itemTypes.at(gameItemTypeId));
+                }
+            });
+    };
+
+    // a full batch goes out as one request without waiting for the window
+    for (const auto& itemType : itemTypes)
+    {
+        lookup(itemType.first);
+    }
+    while (results < expectedResults)
+        ASSERT_TRUE(manager.Poll());
+    ASSERT_EQ(m_service.getItemTypesCalls, 1);
+    ASSERT_EQ(m_service.lastGetItemTypeRequest.game_item_type_ids_size(), itemTypes.size());
+
+    // an unknown id fails the batch, each id is then retried on its own
+    lookup(missingItemTypeId);
+    lookup(itemTypes.begin()->first);
+    while (results < expectedResults)
+        ASSERT_TRUE(manager.Poll());
+    ASSERT_EQ(m_service.getItemTypesCalls, 4);
+}
+
 TEST_F(ItemTypeClientTest, GetItemTypes)
 {
     struct RPCTestData
     {
-        list<string> gameItemTypeIds;
+        StringList gameItemTypeIds;
         RPCTestData()
         { 
             const size_t count = RandomInt<size_t>(1, FakeItemTypeService::SomeItemTypes().size());
@@ -1024,7 +2055,7 @@ TEST_F(ItemTypeClientTest, GetItemTypes)
     {
         const proto::api::itemtype::GetItemTypesRequest& request(m_service.lastGetItemTypeRequest);
         ASSERT_TRUE(result.Success());
-        const list<string> requestedIds{ request.game_item_type_ids().begin(), request.game_item_type_ids().end() };
+        const StringList requestedIds{ request.game_item_type_ids().begin(), request.game_item_type_ids().end() };
         ASSERT_EQ(data.gameItemTypeIds, requestedIds);
         std::for_each(result.Payload().begin(), result.Payload().end(),
             [&data](const IVIItemType& itemType)
@@ -1078,6 +2109,43 @@ TEST_F(ItemTypeClientTest, GetItemTypes_All)
     ClientTest::template UnaryTest<RPCTestData>(checkResultSuccess, syncCaller, asyncCaller);
 }
 
+TEST_F(ItemTypeClientTest, GetItemTypes_Visitor)
+{
+    struct RPCTestData
+    {
+        shared_ptr<std::set<string>> visited = make_shared<std::set<string>>();
+    };
+
+    auto checkResultSuccess = [&](const RPCTestData& data, const IVIResultCount& result)
+    {
+        ASSERT_TRUE(result.Success());
+        ASSERT_EQ(result.Payload(), FakeItemTypeService::SomeItemTypes().size());
+        ASSERT_EQ(data.visited->size(), FakeItemTypeService::SomeItemTypes().size());
+    };
+
+    auto visitor = [](const RPCTestData& data)
+    {
+        shared_ptr<std::set<string>> visited(data.visited);
+        return [visited](const IVIItemType& itemType)
+        {
+            CheckEq(itemType, FakeItemTypeService::SomeItemTypes().at(itemType.gameItemTypeId));
+            visited->insert(itemType.gameItemTypeId);
+        };
+    };
+
+    auto syncCaller = [&](const RPCTestData& data)
+    {
+        return m_syncManager->ItemTypeClient().GetItemTypes(StringList(), visitor(data));
+    };
+
+    auto asyncCaller = [&](const RPCTestData& data, const function<void(const IVIResultCount&)>& callback)
+    {
+        m_asyncManager->ItemTypeClient().GetItemTypes(StringList(), visitor(data), callback);
+    };
+
+    ClientTest::template UnaryTest<RPCTestData>(checkResultSuccess, syncCaller, asyncCaller);
+}
+
 TEST_F(ItemTypeClientTest, CreateItemType)
 {
     struct RPCTestData
@@ -1218,6 +2286,64 @@ IVIPlayer GeneratePlayer()
     };
 }
 
+TEST_F(ItemTypeClientTest, ItemTypeCache)
+{
+    const FakeItemTypeService::ItemTypeMap& itemTypes(FakeItemTypeService::SomeItemTypes());
+
+    IVIItemTypeCache cache;
+    ASSERT_TRUE(cache.Seed(m_syncManager->ItemTypeClient()).Success());
+    ASSERT_EQ(cache.Size(), itemTypes.size());
+    for (const auto& itemType : itemTypes)
+    {
+        IVIItemTypeCache::ItemTypePtr cached(cache.Find(itemType.first));
+        ASSERT_NE(cached, nullptr);
+        CheckEq(*cached, itemType.second);
+    }
+    ASSERT_EQ(cache.Find(RandomString(17)), nullptr);
+
+    const IVIItemType& original(itemTypes.begin()->second);
+    const IVIItemTypeCache::ItemTypePtr beforeUpdate(cache.Find(original.gameItemTypeId));
+
+    // readers run concurrently with stream updates and always see a whole item type
+    std::atomic<bool> stopReading{ false };
+    std::thread reader([&]()
+        {
+            while (!stopReading)
+            {
+                IVIItemTypeCache::ItemTypePtr cached(cache.Find(original.gameItemTypeId));
+                ASSERT_NE(cached, nullptr);
+                ASSERT_EQ(cached->gameItemTypeId, original.gameItemTypeId);
+                ASSERT_TRUE(cached == beforeUpdate || cached->issuedSupply == cached->currentSupply + 1);
+            }
+        });
+
+    int nextCalls = 0;
+    OnItemTypeUpdated onUpdated(cache.Hook([&](const IVIItemTypeStatusUpdate&) { ++nextCalls; }));
+    const int updates = 1000;
+    for (int i = 0; i < updates; ++i)
+    {
+        onUpdated({ original.gameItemTypeId, RandomString(20), RandomString(10), i, i + 1, original.issueTimeSpan, ItemTypeState::CREATED });
+    }
+    stopReading = true;
+    reader.join();
+    ASSERT_EQ(nextCalls, updates);
+
+    IVIItemTypeCache::ItemTypePtr updated(cache.Find(original.gameItemTypeId));
+    ASSERT_EQ(updated->currentSupply, updates - 1);
+    ASSERT_EQ(updated->issuedSupply, updates);
+    ASSERT_EQ(updated->itemTypeState, ItemTypeState::CREATED);
+    ASSERT_EQ(updated->tokenName, original.tokenName);
+    CheckEq(*beforeUpdate, original);   // earlier lookups are unaffected
+
+    // updates for unknown ids are not cached until the item type itself is put
+    IVIItemType created(GenerateItemType());
+    ASSERT_FALSE(cache.ApplyUpdate({ created.gameItemTypeId, created.baseUri, RandomString(10), 1, 1, 0, ItemTypeState::CREATED }));
+    ASSERT_EQ(cache.Find(created.gameItemTypeId), nullptr);
+    cache.Put(created);
+    ASSERT_EQ(cache.Size(), itemTypes.size() + 1);
+    CheckEq(*cache.Find(created.gameItemTypeId), created);
+}
+
 class FakePlayerService : public rpc::api::player::PlayerService::Service
 {
 public:
@@ -1261,21 +2387,48 @@ public:
     
     bool getPlayersReturnsNothing = false;
     proto::api::player::GetPlayersRequest lastGetPlayersRequest;
+    std::vector<time_t> getPlayersCursors;
+    // When not empty GetPlayers pages over these instead, players at the cursor timestamp included
+    std::vector<IVIPlayer> pagedPlayers;
+    std::mutex getPlayersMutex;  // paged scans make concurrent calls
     ::grpc::Status GetPlayers(::grpc::ServerContext* context, const ::ivi::proto::api::player::GetPlayersRequest* request, ::ivi::proto::api::player::IVIPlayers* response) override
     {
+        std::lock_guard<std::mutex> lock(getPlayersMutex);
         lastGetPlayersRequest = *request;
+        getPlayersCursors.push_back(request->created_timestamp());
 
         if (getPlayersReturnsNothing)
             return ::grpc::Status::OK;
 
+        if (!pagedPlayers.empty())
+        {
+            const bool ascending(request->sort_order() == ECast(SortOrder::ASC));
+            std::vector<IVIPlayer> sorted(pagedPlayers);
+            std::stable_sort(sorted.begin(), sorted.end(), [ascending](const IVIPlayer& lhs, const IVIPlayer& rhs)
+                { return ascending ? lhs.createdTimestamp < rhs.createdTimestamp : lhs.createdTimestamp > rhs.createdTimestamp; });
+            for (const IVIPlayer& player : sorted)
+            {
+                const time_t cursor(request->created_timestamp());
+                if (cursor == 0 || (ascending ? player.createdTimestamp >= cursor : player.createdTimestamp <= cursor))
+                {
+                    *response->add_ivi_players() = player.ToProto();
+                    if (response->ivi_players_size() == request->page_size())
+                        break;
+                }
+            }
+            return ::grpc::Status::OK;
+        }
+
         transform(SomePlayers().begin(), SomePlayers().end(), RepeatedFieldBackInserter(response->mutable_ivi_players()),
             [](const FakePlayerService::PlayerMap::value_type& player) { return player.second.ToProto(); });
         return ::grpc::Status::OK;
     }
 
     proto::api::player::GetPlayerRequest lastGetPlayerRequest;
+    std::atomic<int> getPlayerCalls{ 0 };
     ::grpc::Status GetPlayer(::grpc::ServerContext* context, const ::ivi::proto::api::player::GetPlayerRequest* request, ::ivi::proto::api::player::IVIPlayer* response) override
     {
+        ++getPlayerCalls;
         lastGetPlayerRequest = *request;
         *response = SomePlayers().at(request->player_id()).ToProto();
         return ::grpc::Status::OK;
@@ -1352,6 +2505,28 @@ TEST_F(PlayerServiceTest, GetPlayer)
     }
 }
 
+TEST_F(PlayerServiceTest, GetPlayer_SingleFlight)
+{
+    const string playerId(RandomKey(FakePlayerService::SomePlayers()));
+    const int callers = 5;
+    int results = 0;
+
+    for (int i = 0; i < callers; ++i)
+    {
+        m_asyncManager->PlayerClient().GetPlayer(playerId,
+            [&](const IVIResultPlayer& result)
+            {
+                ASSERT_TRUE(result.Success());
+                CheckEq(result.Payload(), FakePlayerService::SomePlayers().at(playerId));
+                ++results;
+            });
+    }
+
+    while (results < callers)
+        ASSERT_TRUE(m_asyncManager->Poll());
+    ASSERT_EQ(m_service.getPlayerCalls, 1);
+}
+
 TEST_F(PlayerServiceTest, GetPlayers)
 {
     struct RPCTestData
@@ -1509,6 +2684,531 @@ void CheckEqList(const LHSListType& lhs, const RHSListType& rhs)
     }
 }
 
+TEST(Model, FromProtoRvalue)
+{
+    // the rvalue overloads parse the same model, taking the strings out of the message
+    const IVIItem item(GenerateItem());
+    proto::api::item::Item itemProto(item.ToProto());
+    CheckEq(item, IVIItem::FromProto(itemProto));
+    CheckEq(item, IVIItem::FromProto(move(itemProto)));
+    ASSERT_TRUE(itemProto.game_inventory_id().empty());
+    ASSERT_TRUE(itemProto.metadata().name().empty());
+
+    const IVIItemType itemType(GenerateItemType());
+    proto::api::itemtype::ItemType itemTypeProto(itemType.ToProto());
+    CheckEq(itemType, IVIItemType::FromProto(move(itemTypeProto)));
+    ASSERT_TRUE(itemTypeProto.game_item_type_id().empty());
+
+    const IVIPlayer player(GeneratePlayer());
+    proto::api::player::IVIPlayer playerProto(player.ToProto());
+    CheckEq(player, IVIPlayer::FromProto(move(playerProto)));
+    ASSERT_TRUE(playerProto.player_id().empty());
+
+    const IVIOrder order(GenerateOrder());
+    proto::api::order::Order orderProto(order.ToProto());
+    CheckEq(order, IVIOrder::FromProto(move(orderProto)));
+    ASSERT_TRUE(orderProto.order_id().empty());
+    ASSERT_TRUE(orderProto.address().city().empty());
+
+    const IVIPurchasedItems purchasedItems(GeneratePurchasedItems());
+    proto::api::order::ItemTypeOrder purchasedItemsProto(purchasedItems.ToProto());
+    const IVIPurchasedItems parsedItems(IVIPurchasedItems::FromProto(move(purchasedItemsProto)));
+    CheckEqList(purchasedItems.gameInventoryIds, parsedItems.gameInventoryIds);
+    ASSERT_EQ(purchasedItems.itemName, parsedItems.itemName);
+    CheckEq(purchasedItems.metadata, parsedItems.metadata);
+
+    // an unset field is left alone
+    proto::api::item::Item emptyProto;
+    const IVIItem emptyItem(IVIItem::FromProto(move(emptyProto)));
+    ASSERT_TRUE(emptyItem.gameInventoryId.empty());
+    ASSERT_FALSE(emptyProto.has_metadata());
+}
+
+TEST(Model, ToProtoInPlace)
+{
+    // writing over a message already holding another model leaves exactly what ToProto returns
+    const IVIItem item(GenerateItem());
+    proto::api::item::Item itemProto(GenerateItem().ToProto());
+    item.ToProto(&itemProto);
+    ASSERT_TRUE(MessageDifferencer::Equals(item.ToProto(), itemProto));
+
+    IVIItemType itemType(GenerateItemType());
+    proto::api::itemtype::ItemType itemTypeProto(GenerateItemType().ToProto());
+    itemTypeProto.add_agreement_ids(RandomString(8));
+    itemType.ToProto(&itemTypeProto);
+    ASSERT_TRUE(MessageDifferencer::Equals(itemType.ToProto(), itemTypeProto));
+
+    IVIOrder order(GenerateOrder());
+    proto::api::order::Order orderProto(order.ToProto());
+    order.metadata.clear();
+    order.bitpayInvoice.clear();
+    order.ToProto(&orderProto);
+    ASSERT_FALSE(orderProto.has_metadata());
+    ASSERT_FALSE(orderProto.has_payment_provider_data());
+    ASSERT_TRUE(MessageDifferencer::Equals(order.ToProto(), orderProto));
+
+    IVIMetadataUpdate update{ RandomString(16), GenerateMetadata() };
+    proto::api::item::UpdateItemMetadata updateProto;
+    update.metadata.properties = IVIMetadataProperties();
+    GenerateMetadata().ToProto(updateProto.mutable_metadata());
+    (*updateProto.mutable_metadata()->mutable_properties()->mutable_fields())["stale"].set_bool_value(true);
+    update.ToProto(&updateProto);
+    ASSERT_EQ(updateProto.metadata().properties().fields_size(), 0);
+    ASSERT_TRUE(MessageDifferencer::Equals(update.ToProto(), updateProto));
+
+    const IVIPurchasedItems purchasedItems(GeneratePurchasedItems());
+    proto::api::order::ItemTypeOrder purchasedItemsProto(GeneratePurchasedItems().ToProto());
+    purchasedItems.ToProto(&purchasedItemsProto);
+    ASSERT_TRUE(MessageDifferencer::Equals(purchasedItems.ToProto(), purchasedItemsProto));
+}
+
+TEST(Model, BinaryEncoding)
+{
+    IVIItem item(GenerateItem());
+    const string encoded(IVIBinaryEncode(item));
+    IVIBinaryType type;
+    ASSERT_TRUE(IVIBinaryPeekType(encoded.data(), encoded.size(), type));
+    ASSERT_EQ(type, IVIBinaryType::ITEM);
+    ASSERT_LT(encoded.size(), item.ToProto().SerializeAsString().size());
+
+    // views point into the buffer
+    IVIItemView view;
+    ASSERT_TRUE(view.Decode(encoded.data(), encoded.size()));
+    ASSERT_GE(view.gameInventoryId.data, encoded.data());
+    ASSERT_LT(view.gameInventoryId.data, encoded.data() + encoded.size());
+    ASSERT_EQ(view.gameInventoryId, item.gameInventoryId);
+    ASSERT_EQ(view.itemState, item.itemState);
+    CheckEq(view.ToModel(), item);
+
+    // kept Structs are carried as such
+    item.metadata.properties = MetadataPropertiesFromStruct(JsonStringToGoogleStruct("{\"level\":3,\"tags\":[\"a\",\"b\"]}"));
+    IVIItem decodedItem;
+    const string structEncoded(IVIBinaryEncode(item));
+    ASSERT_TRUE(IVIBinaryDecode(structEncoded.data(), structEncoded.size(), decodedItem));
+    ASSERT_EQ(MetadataPropertiesStruct(decodedItem.metadata.properties) != nullptr, MetadataPropertiesStruct(item.metadata.properties) != nullptr);
+    CheckEq(decodedItem, item);
+
+    const IVIItemType itemType(GenerateItemType());
+    IVIItemType decodedItemType;
+    const string itemTypeEncoded(IVIBinaryEncode(itemType));
+    ASSERT_TRUE(IVIBinaryDecode(itemTypeEncoded.data(), itemTypeEncoded.size(), decodedItemType));
+    CheckEq(decodedItemType, itemType);
+
+    const IVIPlayer player(GeneratePlayer());
+    IVIPlayer decodedPlayer;
+    const string playerEncoded(IVIBinaryEncode(player));
+    ASSERT_TRUE(IVIBinaryDecode(playerEncoded.data(), playerEncoded.size(), decodedPlayer));
+    CheckEq(decodedPlayer, player);
+
+    const IVIOrder order(GenerateOrder());
+    IVIOrder decodedOrder;
+    const string orderEncoded(IVIBinaryEncode(order));
+    ASSERT_TRUE(IVIBinaryDecode(orderEncoded.data(), orderEncoded.size(), decodedOrder));
+    CheckEq(decodedOrder, order);
+
+    // encodings append, so several can share a buffer
+    const IVIItemStatusUpdate itemUpdate{ RandomString(16), RandomString(8), RandomString(12), RandomString(20), RandomString(10), -RandomInt<int64_t>(), RandomInt<int32_t>(), ItemState::BURNED };
+    const IVIOrderStatusUpdate orderUpdate{ RandomString(16), OrderState::COMPLETE };
+    string updates(IVIBinaryEncode(itemUpdate));
+    const size_t itemUpdateSize(updates.size());
+    IVIBinaryEncode(orderUpdate, updates);
+    IVIItemStatusUpdateView itemUpdateView;
+    IVIOrderStatusUpdateView orderUpdateView;
+    ASSERT_TRUE(itemUpdateView.Decode(updates.data(), itemUpdateSize));
+    ASSERT_TRUE(orderUpdateView.Decode(updates.data() + itemUpdateSize, updates.size() - itemUpdateSize));
+    ASSERT_EQ(itemUpdateView.dgoodsId, itemUpdate.dgoodsId);
+    ASSERT_EQ(itemUpdateView.trackingId, itemUpdate.trackingId);
+    ASSERT_EQ(itemUpdateView.itemState, itemUpdate.itemState);
+    ASSERT_EQ(orderUpdateView.orderId, orderUpdate.orderId);
+    ASSERT_EQ(orderUpdateView.ToModel().orderState, orderUpdate.orderState);
+
+    const IVIPlayerStatusUpdate playerUpdate{ RandomString(12), RandomString(10), PlayerState::LINKED };
+    IVIPlayerStatusUpdate decodedPlayerUpdate;
+    const string playerUpdateEncoded(IVIBinaryEncode(playerUpdate));
+    ASSERT_TRUE(IVIBinaryDecode(playerUpdateEncoded.data(), playerUpdateEncoded.size(), decodedPlayerUpdate));
+    ASSERT_EQ(decodedPlayerUpdate.playerId, playerUpdate.playerId);
+    ASSERT_EQ(decodedPlayerUpdate.playerState, playerUpdate.playerState);
+
+    const IVIItemTypeStatusUpdate itemTypeUpdate{ RandomString(8), RandomString(20), RandomString(10), RandomInt<int32_t>(), RandomInt<int32_t>(), RandomInt<int32_t>(), ItemTypeState::CREATED };
+    IVIItemTypeStatusUpdate decodedItemTypeUpdate;
+    const string itemTypeUpdateEncoded(IVIBinaryEncode(itemTypeUpdate));
+    ASSERT_TRUE(IVIBinaryDecode(itemTypeUpdateEncoded.data(), itemTypeUpdateEncoded.size(), decodedItemTypeUpdate));
+    ASSERT_EQ(decodedItemTypeUpdate.baseUri, itemTypeUpdate.baseUri);
+    ASSERT_EQ(decodedItemTypeUpdate.issueTimeSpan, itemTypeUpdate.issueTimeSpan);
+    ASSERT_EQ(decodedItemTypeUpdate.itemTypeState, itemTypeUpdate.itemTypeState);
+
+    // truncated, padded, mistyped or versioned buffers are rejected
+    for (size_t size = 0; size < encoded.size(); ++size)
+    {
+        ASSERT_FALSE(view.Decode(encoded.data(), size));
+    }
+    ASSERT_FALSE(view.Decode((encoded + '\0').data(), encoded.size() + 1));
+    ASSERT_FALSE(view.Decode(playerEncoded.data(), playerEncoded.size()));
+    string versioned(encoded);
+    ++versioned[2];
+    ASSERT_FALSE(IVIBinaryPeekType(versioned.data(), versioned.size(), type));
+    ASSERT_FALSE(view.Decode(versioned.data(), versioned.size()));
+    string badState(IVIBinaryEncode(orderUpdate));
+    badState.back() = 0x7f;
+    ASSERT_FALSE(orderUpdateView.Decode(badState.data(), badState.size()));
+}
+
+TEST_F(PlayerServiceTest, GetPlayers_Visitor)
+{
+    struct RPCTestData
+    {
+        time_t createdTimestamp = Now();
+        int32_t pageSize = RandomInt();
+        SortOrder sortOrder = static_cast<SortOrder>(RandomInt(proto::common::sort::SortOrder_ARRAYSIZE));
+        shared_ptr<std::set<string>> visited = make_shared<std::set<string>>();
+    };
+
+    auto checkSuccessResult = [&](const RPCTestData& data, const IVIResultCount& result)
+    {
+        const proto::api::player::GetPlayersRequest& request(m_service.lastGetPlayersRequest);
+        ASSERT_TRUE(result.Success());
+        ASSERT_EQ(request.created_timestamp(), data.createdTimestamp);
+        ASSERT_EQ(result.Payload(), FakePlayerService::SomePlayers().size());
+        ASSERT_EQ(data.visited->size(), FakePlayerService::SomePlayers().size());
+    };
+
+    auto visitor = [](const RPCTestData& data)
+    {
+        shared_ptr<std::set<string>> visited(data.visited);
+        return [visited](const IVIPlayer& player)
+        {
+            CheckEq(player, FakePlayerService::SomePlayers().at(player.playerId));
+            visited->insert(player.playerId);
+        };
+    };
+
+    auto syncCaller = [&](const RPCTestData& data)
+    {
+        return m_syncManager->PlayerClient().GetPlayers(data.createdTimestamp, data.pageSize, data.sortOrder, visitor(data));
+    };
+
+    auto asyncCaller = [&](const RPCTestData& data, const function<void(const IVIResultCount&)>& callback)
+    {
+        m_asyncManager->PlayerClient().GetPlayers(data.createdTimestamp, data.pageSize, data.sortOrder, visitor(data), callback);
+    };
+
+    ClientTest::template UnaryTest<RPCTestData>(checkSuccessResult, syncCaller, asyncCaller);
+}
+
+TEST_F(PlayerServiceTest, PlayerCache)
+{
+    const string playerId(RandomKey(FakePlayerService::SomePlayers()));
+    IVIPlayerCache cache(2);
+
+    // read-through, the second login is served locally
+    for (int i = 0; i < 2; ++i)
+    {
+        bool resultReceived = false;
+        cache.GetPlayer(m_asyncManager->PlayerClient(), playerId,
+            [&](const IVIResultPlayer& result)
+            {
+                ASSERT_TRUE(result.Success());
+                CheckEq(result.Payload(), FakePlayerService::SomePlayers().at(playerId));
+                resultReceived = true;
+            });
+        while (!resultReceived)
+            ASSERT_TRUE(m_asyncManager->Poll());
+    }
+    ASSERT_EQ(m_service.getPlayerCalls, 1);
+    ASSERT_EQ(cache.Stats().hits, 1);
+    ASSERT_EQ(cache.Stats().misses, 1);
+
+    // an update in the same state only refreshes the trackingId, a state change drops the player
+    const IVIPlayerCache::PlayerPtr beforeUpdate(cache.Find(playerId));
+    const string trackingId(RandomString(10));
+    int nextCalls = 0;
+    OnPlayerUpdated onUpdated(cache.Hook([&](const IVIPlayerStatusUpdate&) { ++nextCalls; }));
+    onUpdated({ playerId, trackingId, beforeUpdate->playerState });
+    ASSERT_EQ(nextCalls, 1);
+    ASSERT_EQ(cache.Find(playerId)->trackingId, trackingId);
+    onUpdated({ playerId, RandomString(10), beforeUpdate->playerState == PlayerState::FAILED ? PlayerState::LINKED : PlayerState::FAILED });
+    ASSERT_EQ(nextCalls, 2);
+    ASSERT_EQ(cache.Find(playerId), nullptr);
+    CheckEq(*beforeUpdate, FakePlayerService::SomePlayers().at(playerId));
+    ASSERT_FALSE(cache.ApplyUpdate({ RandomString(12), RandomString(10), PlayerState::LINKED }));
+    cache.Put(*beforeUpdate);
+
+    // least recently used is evicted first, playerId was just looked up
+    const IVIPlayer other(GeneratePlayer()), newest(GeneratePlayer());
+    cache.Put(other);
+    ASSERT_NE(cache.Find(playerId), nullptr);
+    cache.Put(newest);
+    ASSERT_EQ(cache.Find(other.playerId), nullptr);
+    ASSERT_NE(cache.Find(playerId), nullptr);
+    CheckEq(*cache.Find(newest.playerId), newest);
+
+    const IVICacheStats stats(cache.Stats());
+    ASSERT_EQ(stats.size, 2);
+    ASSERT_EQ(stats.capacity, 2);
+    ASSERT_EQ(stats.evictions, 1);
+    ASSERT_EQ(stats.misses, 3);
+
+    cache.Erase(playerId);
+    ASSERT_EQ(cache.Find(playerId), nullptr);
+    ASSERT_EQ(cache.Stats().size, 1);
+}
+
+TEST_F(PlayerServiceTest, PlayerCacheLinking)
+{
+    const string playerId(RandomKey(FakePlayerService::SomePlayers()));
+    const IVIPlayer& linked(FakePlayerService::SomePlayers().at(playerId));
+    IVIPlayerCache cache(4);
+    OnPlayerUpdated onUpdated(cache.Hook(nullptr));
+
+    auto getPlayer = [&](IVIPlayerCache& playerCache)
+    {
+        bool resultReceived = false;
+        playerCache.GetPlayer(m_asyncManager->PlayerClient(), playerId,
+            [&](const IVIResultPlayer& result)
+            {
+                ASSERT_TRUE(result.Success());
+                ASSERT_EQ(result.Payload().sidechainAccountName, linked.sidechainAccountName);
+                resultReceived = true;
+            });
+        while (!resultReceived)
+            ASSERT_TRUE(m_asyncManager->Poll());
+    };
+
+    // cached while linking, the update to LINKED has no sidechainAccountName so the next login refetches
+    IVIPlayer pending(linked);
+    pending.sidechainAccountName.clear();
+    pending.playerState = PlayerState::PENDING_LINKED;
+    cache.Put(pending);
+    onUpdated({ playerId, RandomString(10), PlayerState::LINKED });
+    ASSERT_EQ(cache.Find(playerId), nullptr);
+    getPlayer(cache);
+    ASSERT_EQ(m_service.getPlayerCalls, 1);
+    ASSERT_EQ(cache.Find(playerId)->sidechainAccountName, linked.sidechainAccountName);
+
+    // an update arriving while the read-through is in flight keeps its result out of the cache
+    cache.Erase(playerId);
+    bool resultReceived = false;
+    cache.GetPlayer(m_asyncManager->PlayerClient(), playerId, [&](const IVIResultPlayer&) { resultReceived = true; });
+    onUpdated({ playerId, RandomString(10), PlayerState::LINKED });
+    while (!resultReceived)
+        ASSERT_TRUE(m_asyncManager->Poll());
+    ASSERT_EQ(cache.Find(playerId), nullptr);
+    getPlayer(cache);
+    ASSERT_NE(cache.Find(playerId), nullptr);
+
+    // destroying the cache leaves outstanding read-throughs to just call back
+    unique_ptr<IVIPlayerCache> shortLived(new IVIPlayerCache(1));
+    resultReceived = false;
+    shortLived->GetPlayer(m_asyncManager->PlayerClient(), playerId, [&](const IVIResultPlayer& result) { resultReceived = result.Success(); });
+    shortLived.reset();
+    while (!resultReceived)
+        ASSERT_TRUE(m_asyncManager->Poll());
+}
+
+TEST(CacheSnapshot, RoundTrip)
+{
+    const string path("ivi-sdk-test-" + RandomString(8) + ".snap");
+
+    IVIItemTypeCache itemTypeCache;
+    IVIPlayerCache playerCache(16);
+    std::map<string, IVIItemType> itemTypes;
+    std::map<string, IVIPlayer> players;
+    std::map<string, IVIItem> items;
+    IVISnapshotWriter writer;
+    for (int i = 0; i < 10; ++i)
+    {
+        const IVIItemType itemType(GenerateItemType());
+        itemTypes[itemType.gameItemTypeId] = itemType;
+        itemTypeCache.Put(itemType);
+
+        const IVIPlayer player(GeneratePlayer());
+        players[player.playerId] = player;
+        playerCache.Put(player);
+
+        const IVIItem item(GenerateItem());
+        items[item.gameInventoryId] = item;
+        writer.Add(item);
+    }
+    writer.Add(itemTypeCache);
+    writer.Add(playerCache);
+    ASSERT_TRUE(writer.Write(path, 12345));
+
+    {
+        const unique_ptr<IVISnapshot> snapshot(IVISnapshot::Open(path));
+        ASSERT_NE(snapshot, nullptr);
+        ASSERT_EQ(snapshot->CreatedTimestamp(), 12345);
+        ASSERT_EQ(snapshot->Count(IVISnapshotSection::ITEM_TYPES), 10);
+        ASSERT_EQ(snapshot->Count(IVISnapshotSection::PLAYERS), 10);
+        ASSERT_EQ(snapshot->Count(IVISnapshotSection::ITEMS), 10);
+
+        for (const auto& entry : itemTypes)
+        {
+            IVIItemType itemType;
+            ASSERT_TRUE(snapshot->FindItemType(entry.first, itemType));
+            CheckEq(itemType, entry.second);
+        }
+        for (const auto& entry : players)
+        {
+            IVIPlayer player;
+            ASSERT_TRUE(snapshot->FindPlayer(entry.first, player));
+            CheckEq(player, entry.second);
+        }
+        for (const auto& entry : items)
+        {
+            IVIItem item;
+            ASSERT_TRUE(snapshot->FindItem(entry.first, item));
+            CheckEq(item, entry.second);
+        }
+        IVIPlayer missing;
+        ASSERT_FALSE(snapshot->FindPlayer(RandomString(20), missing));
+
+        // warm restart
+        IVIItemTypeCache restoredItemTypes;
+        IVIPlayerCache restoredPlayers(16);
+        ASSERT_EQ(snapshot->LoadInto(restoredItemTypes), 10);
+        ASSERT_EQ(snapshot->LoadInto(restoredPlayers), 10);
+        IVIItemCache restoredItems(1024 * 1024, 0);
+        ASSERT_EQ(snapshot->LoadInto(restoredItems), 10);
+        for (const auto& entry : itemTypes)
+            CheckEq(*restoredItemTypes.Find(entry.first), entry.second);
+        for (const auto& entry : players)
+            CheckEq(*restoredPlayers.Find(entry.first), entry.second);
+        for (const auto& entry : items)
+            CheckEq(*restoredItems.Find(entry.first), entry.second);
+
+        size_t visited = 0;
+        ASSERT_EQ(snapshot->ForEachItem([&](const IVIItem& item) { CheckEq(item, items.at(item.gameInventoryId)); ++visited; }), 10);
+        ASSERT_EQ(visited, 10);
+    }
+
+    // truncated or foreign files are rejected rather than trusted
+    {
+        std::ifstream in(path, std::ios::binary);
+        const string contents((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        in.close();
+
+        std::ofstream(path, std::ios::binary | std::ios::trunc).write(contents.data(), contents.size() / 2);
+        ASSERT_EQ(IVISnapshot::Open(path), nullptr);
+
+        string corrupt(contents);
+        corrupt[0] = 'X';
+        std::ofstream(path, std::ios::binary | std::ios::trunc).write(corrupt.data(), corrupt.size());
+        ASSERT_EQ(IVISnapshot::Open(path), nullptr);
+
+        // an index offset whose end wraps around, the first section header's indexOffset follows the
+        // 32 byte file header and the section and count fields
+        corrupt = contents;
+        const uint64_t wrappingOffset(~uint64_t(0) - 64);
+        memcpy(&corrupt[32 + 8], &wrappingOffset, sizeof(wrappingOffset));
+        std::ofstream(path, std::ios::binary | std::ios::trunc).write(corrupt.data(), corrupt.size());
+        ASSERT_EQ(IVISnapshot::Open(path), nullptr);
+    }
+    ASSERT_EQ(IVISnapshot::Open(path + ".missing"), nullptr);
+
+    std::remove(path.c_str());
+}
+
+TEST_F(PlayerServiceTest, PlayerScan)
+{
+    // triples of players share a timestamp, some straddle partition and page edges
+    const time_t from = 1000, to = 1013;
+    std::set<string> inRange;
+    for (int i = 0; i < 42; ++i)
+    {
+        IVIPlayer player(GeneratePlayer());
+        player.createdTimestamp = from + i / 3;
+        inRange.insert(player.playerId);
+        m_service.pagedPlayers.push_back(player);
+    }
+    for (time_t outside : { from - 1, to + 1 })
+    {
+        IVIPlayer player(GeneratePlayer());
+        player.createdTimestamp = outside;
+        m_service.pagedPlayers.push_back(player);
+    }
+
+    for (bool ordered : { true, false })
+    {
+        for (SortOrder sortOrder : { SortOrder::ASC, SortOrder::DESC })
+        {
+            IVIPlayerScan scan(m_asyncManager->PlayerClient(), from, to, 4, 4, sortOrder, ordered);
+            ASSERT_EQ(scan.PartitionCount(), 4);
+
+            std::map<string, int> seen;
+            time_t lastTimestamp = sortOrder == SortOrder::ASC ? 0 : numeric_limits<time_t>::max();
+            ASSERT_TRUE(scan.ForEachPlayer(*m_asyncManager,
+                [&](const IVIPlayer& player)
+                {
+                    ++seen[player.playerId];
+                    if (ordered && sortOrder == SortOrder::ASC)
+                        ASSERT_GE(player.createdTimestamp, lastTimestamp);
+                    else if (ordered)
+                        ASSERT_LE(player.createdTimestamp, lastTimestamp);
+                    lastTimestamp = player.createdTimestamp;
+                }).Success());
+            ASSERT_TRUE(scan.Done());
+
+            ASSERT_EQ(seen.size(), inRange.size());
+            for (const auto& entry : seen)
+            {
+                ASSERT_EQ(entry.second, 1);
+                ASSERT_TRUE(inRange.count(entry.first));
+            }
+        }
+    }
+
+    // more partitions than seconds in the range
+    IVIPlayerScan narrow(m_asyncManager->PlayerClient(), from, from + 1, 8, 4, SortOrder::ASC, false);
+    ASSERT_EQ(narrow.PartitionCount(), 2);
+    size_t players = 0;
+    ASSERT_TRUE(narrow.ForEachPlayer(*m_asyncManager, [&](const IVIPlayer&) { ++players; }).Success());
+    ASSERT_EQ(players, 6);
+
+    m_service.pagedPlayers.clear();
+}
+
+TEST_F(PlayerServiceTest, ColumnarExport)
+{
+    const string path("ivi-sdk-test-" + RandomString(8) + ".cols");
+    std::map<string, IVIPlayer> players;
+    const time_t oldest(Now() - 20 * 60);
+    for (int i = 0; i < 20; ++i)
+    {
+        IVIPlayer player(GeneratePlayer());
+        player.createdTimestamp = oldest + i * 60;
+        players[player.playerId] = player;
+        m_service.pagedPlayers.push_back(player);
+    }
+
+    m_service.getPlayersCursors.clear();
+    const IVIResultCount exported(IVIExportPlayers(*m_asyncManager, path, 3, 4, 6));
+    ASSERT_TRUE(exported.Success());
+    ASSERT_EQ(exported.Payload(), players.size());
+
+    // after looking up the oldest player the partitions only span the range the players were created in
+    ASSERT_EQ(m_service.getPlayersCursors.front(), 0);
+    for (size_t request = 1; request < m_service.getPlayersCursors.size(); ++request)
+        ASSERT_GE(m_service.getPlayersCursors[request], oldest - 1);
+
+    {
+        const unique_ptr<IVIColumnarReader> reader(IVIColumnarReader::Open(path));
+        ASSERT_NE(reader, nullptr);
+        ASSERT_EQ(reader->Table(), IVIColumnarTable::PLAYERS);
+        ASSERT_EQ(reader->RowCount(), players.size());
+        ASSERT_EQ(reader->RowGroupCount(), 4);
+        ASSERT_EQ(reader->ForEachPlayer([&](const IVIPlayer& player)
+            {
+                ASSERT_EQ(players.count(player.playerId), 1);
+                CheckEq(player, players[player.playerId]);
+                players.erase(player.playerId);
+            }), 20);
+        ASSERT_TRUE(players.empty());
+    }
+
+    std::remove(path.c_str());
+    m_service.pagedPlayers.clear();
+}
+
 class FakeOrderService : public rpc::api::order::OrderService::Service
 {
 public:
@@ -2000,6 +3700,100 @@ TEST_F(ItemStreamTest, UpdateStream)
     ClientStreamTest::template StreamTest(FakeOnItemUpdatedCount, confirmChecker);
 }
 
+static IVIItemTracker StreamItemTracker(32, 32, 60 * 60 * 1000);
+static int32_t TrackedItemUpdatedCount = 0;
+static IVIStreamCallbacks TrackedItemStreamCallbacks{ StreamItemTracker.Hook([](const IVIItemStatusUpdate&) { ++TrackedItemUpdatedCount; }) };
+using TrackedItemStreamTest = ClientStreamTest<FakeItemStream, &TrackedItemStreamCallbacks>;
+
+TEST_F(TrackedItemStreamTest, ItemTracker)
+{
+    std::map<IVIResultStatus, size_t> statusCounts;
+    size_t expectedSuccesses = 0, expectedTimeouts = 0, expectedBuffered = 0;
+    std::future<IVIResultItemStatusUpdate> awaited;
+    bool awaitedFinal = false;
+    StringList bufferedTrackingIds;
+
+    // half the state changes are tracked before their final update arrives, the rest after
+    size_t index = 0;
+    for (const auto& update : FakeItemStream::SomeUpdates())
+    {
+        const string& trackingId(update.second.tracking_id());
+        const bool final(IVIItemTracker::IsFinalState(ECast(update.second.item_state())));
+        if (index++ % 2 == 1)
+        {
+            if (final)
+            {
+                ++expectedBuffered;
+                bufferedTrackingIds.push_back(trackingId);
+            }
+        }
+        else if (!awaited.valid())
+        {
+            awaited = StreamItemTracker.Await(trackingId);
+            awaitedFinal = final;
+        }
+        else
+        {
+            final ? ++expectedSuccesses : ++expectedTimeouts;
+            StreamItemTracker.Track(trackingId,
+                [&, trackingId, final](const IVIResultItemStatusUpdate& result)
+                {
+                    ASSERT_EQ(result.Status(), final ? IVIResultStatus::SUCCESS : IVIResultStatus::TIMEOUT);
+                    if (final)
+                    {
+                        ASSERT_EQ(result.Payload().trackingId, trackingId);
+                    }
+                    ++statusCounts[result.Status()];
+                });
+        }
+    }
+
+    ClientStreamTest::template StreamTest(TrackedItemUpdatedCount, [](const rpc::streams::item::ItemStatusConfirmRequest&) {});
+
+    ASSERT_EQ(statusCounts[IVIResultStatus::SUCCESS], expectedSuccesses);
+    ASSERT_EQ(awaited.wait_for(std::chrono::seconds(0)) == std::future_status::ready, awaitedFinal);
+    ASSERT_EQ(StreamItemTracker.BufferedCount(), expectedBuffered);
+
+    for (const string& trackingId : bufferedTrackingIds)
+    {
+        StreamItemTracker.Track(trackingId,
+            [&](const IVIResultItemStatusUpdate& result) { ++statusCounts[result.Status()]; });
+    }
+    ASSERT_EQ(statusCounts[IVIResultStatus::SUCCESS], expectedSuccesses + expectedBuffered);
+    ASSERT_EQ(StreamItemTracker.BufferedCount(), 0);
+
+    const size_t awaitedTimeouts(awaitedFinal ? 0 : 1);
+    ASSERT_EQ(StreamItemTracker.ProcessTimeouts(IVIItemTracker::Clock::now() + std::chrono::hours(1)), expectedTimeouts + awaitedTimeouts);
+    ASSERT_EQ(statusCounts[IVIResultStatus::TIMEOUT], expectedTimeouts);
+    ASSERT_EQ(awaited.get().Status(), awaitedFinal ? IVIResultStatus::SUCCESS : IVIResultStatus::TIMEOUT);
+    ASSERT_EQ(StreamItemTracker.TrackedCount(), 0);
+
+    // bounded, and RPC failures complete without tracking
+    IVIItemTracker tracker(1, 0, 1000);
+    IVIItemTracker::OnCompleted recordStatus([&](const IVIResultItemStatusUpdate& result) { ++statusCounts[result.Status()]; });
+    tracker.TrackOnSuccess(recordStatus)({ IVIResultStatus::SUCCESS, { RandomString(12), RandomString(10), ItemState::PENDING_ISSUED } });
+    tracker.Track(RandomString(10), recordStatus);
+    tracker.TrackOnSuccess(recordStatus)({ IVIResultStatus::UNAVAILABLE });
+    ASSERT_EQ(statusCounts[IVIResultStatus::RESOURCE_EXHAUSTED], 1);
+    ASSERT_EQ(statusCounts[IVIResultStatus::UNAVAILABLE], 1);
+    ASSERT_EQ(tracker.TrackedCount(), 1);
+
+    // churn through the fixed-size index, interleaving tracked and buffered entries
+    IVIItemTracker churned(4, 4, 60 * 1000);
+    size_t completed = 0;
+    for (int i = 0; i < 1000; ++i)
+    {
+        const string trackedId(RandomString(10)), bufferedId(RandomString(10));
+        churned.Track(trackedId, [&](const IVIResultItemStatusUpdate& result) { ASSERT_TRUE(result.Success()); ++completed; });
+        churned.ApplyUpdate({ RandomString(12), RandomString(18), RandomString(10), "", bufferedId, 0, 0, ItemState::ISSUED });
+        churned.ApplyUpdate({ RandomString(12), RandomString(18), RandomString(10), "", trackedId, 0, 0, ItemState::ISSUED });
+        ASSERT_LE(churned.BufferedCount(), 4);
+    }
+    ASSERT_EQ(completed, 1000);
+    ASSERT_EQ(churned.TrackedCount(), 0);
+    ASSERT_EQ(churned.BufferedCount(), 4);
+}
+
 struct ITSUPopulator
 {
     static rpc::streams::itemtype::ItemTypeStatusUpdate GenerateITSU()
@@ -2138,6 +3932,103 @@ TEST_F(OrderStreamTest, UpdateStream)
     ClientStreamTest::template StreamTest(FakeOnOrderUpdatedCount, confirmChecker);
 }
 
+static IVIOrderTracker StreamOrderTracker;
+static int32_t TrackedOrderUpdatedCount = 0;
+static IVIStreamCallbacks TrackedOrderStreamCallbacks = { OnItemUpdated(), OnItemTypeUpdated(), StreamOrderTracker.Hook([](const IVIOrderStatusUpdate&) { ++TrackedOrderUpdatedCount; }) };
+using TrackedOrderStreamTest = ClientStreamTest<FakeOrderStream, &TrackedOrderStreamCallbacks>;
+
+TEST_F(TrackedOrderStreamTest, OrderTracker)
+{
+    const uint32_t timeoutMs = 60 * 60 * 1000;
+    std::map<IVIResultStatus, size_t> statusCounts;
+    size_t expectedAborted = 0, expectedTimeouts = 1;
+
+    for (const auto& update : FakeOrderStream::SomeUpdates())
+    {
+        const OrderState state(ECast(update.second.order_state()));
+        StreamOrderTracker.WaitFor(update.first, state, timeoutMs,
+            [&, state](const IVIResultOrderState& result)
+            {
+                ASSERT_EQ(result.Status(), IVIResultStatus::SUCCESS);
+                ASSERT_EQ(result.Payload(), state);
+                ++statusCounts[result.Status()];
+            });
+
+        // waiting on another state either ends with the order's final state or times out
+        const OrderState otherState(state == OrderState::PAID ? OrderState::COMPLETE : OrderState::PAID);
+        StreamOrderTracker.WaitFor(update.first, otherState, timeoutMs,
+            [&, state](const IVIResultOrderState& result)
+            {
+                ASSERT_NE(result.Status(), IVIResultStatus::SUCCESS);
+                ASSERT_EQ(result.Payload(), state);
+                ++statusCounts[result.Status()];
+            });
+        if (IVIOrderTracker::IsFinalState(state))
+            ++expectedAborted;
+        else
+            ++expectedTimeouts;
+    }
+
+    StreamOrderTracker.WaitFor(RandomString(20), OrderState::COMPLETE, 0,
+        [&](const IVIResultOrderState& result) { ++statusCounts[result.Status()]; });
+
+    const size_t updateCount = FakeOrderStream::SomeUpdates().size();
+    ASSERT_EQ(StreamOrderTracker.WaiterCount(), updateCount * 2 + 1);
+
+    ClientStreamTest::template StreamTest(TrackedOrderUpdatedCount, [](const rpc::streams::order::OrderStatusConfirmRequest&) {});
+
+    ASSERT_EQ(statusCounts[IVIResultStatus::SUCCESS], updateCount);
+    ASSERT_EQ(statusCounts[IVIResultStatus::ABORTED], expectedAborted);
+    ASSERT_EQ(StreamOrderTracker.ProcessTimeouts(IVIOrderTracker::Clock::now() + std::chrono::milliseconds(timeoutMs)), expectedTimeouts);
+    ASSERT_EQ(statusCounts[IVIResultStatus::TIMEOUT], expectedTimeouts);
+    ASSERT_EQ(StreamOrderTracker.WaiterCount(), 0);
+
+    // known states are answered without waiting
+    const auto& settled(*FakeOrderStream::SomeUpdates().begin());
+    bool resultReceived = false;
+    StreamOrderTracker.WaitFor(settled.first, ECast(settled.second.order_state()), timeoutMs,
+        [&](const IVIResultOrderState& result)
+        {
+            ASSERT_TRUE(result.Success());
+            resultReceived = true;
+        });
+    ASSERT_TRUE(resultReceived);
+
+    OrderState state;
+    ASSERT_TRUE(StreamOrderTracker.GetState(settled.first, state));
+    StreamOrderTracker.Forget(settled.first);
+    ASSERT_FALSE(StreamOrderTracker.GetState(settled.first, state));
+}
+
+TEST(OrderTracker, BoundedStates)
+{
+    IVIOrderTracker tracker(1000, 2);
+    const string pending(RandomString(20)), first(RandomString(20)), second(RandomString(20)), third(RandomString(20));
+    OrderState state;
+
+    // at most maxFinalStates final states, oldest dropped first, other states are kept
+    tracker.ApplyUpdate({ pending, OrderState::STARTED });
+    tracker.ApplyUpdate({ first, OrderState::COMPLETE });
+    tracker.ApplyUpdate({ second, OrderState::FAILED });
+    tracker.ApplyUpdate({ third, OrderState::DECLINED });
+    ASSERT_FALSE(tracker.GetState(first, state));
+    ASSERT_TRUE(tracker.GetState(second, state));
+    ASSERT_TRUE(tracker.GetState(third, state));
+
+    // final states expire, late waiters are then waiting on an unknown order
+    tracker.ApplyUpdate({ pending, OrderState::PAID });
+    ASSERT_EQ(tracker.ProcessTimeouts(IVIOrderTracker::Clock::now() + std::chrono::milliseconds(2000)), 0);
+    ASSERT_FALSE(tracker.GetState(second, state));
+    ASSERT_FALSE(tracker.GetState(third, state));
+    ASSERT_TRUE(tracker.GetState(pending, state));
+    ASSERT_EQ(state, OrderState::PAID);
+
+    // reaching a final state later is bounded the same way
+    tracker.ApplyUpdate({ pending, OrderState::COMPLETE });
+    tracker.ProcessTimeouts(IVIOrderTracker::Clock::now() + std::chrono::milliseconds(2000));
+    ASSERT_FALSE(tracker.GetState(pending, state));
+}
+
 struct PSUPopulator
 {
     rpc::streams::player::PlayerStatusUpdate GeneratePSU()